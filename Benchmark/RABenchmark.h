@@ -0,0 +1,82 @@
+//
+//  RABenchmark.h
+//  Benchmark
+//
+//  Created by Tobias Raatiniemi on 2016-12-19.
+//  Copyright (c) 2016 Raatiniemi. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ Runner for measuring the benchmark cases.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ Each case is run once for warm up before the samples are measured, the result
+ is based on the median sample to reduce the influence of outliers.
+ */
+@interface RABenchmark : NSObject
+
+/// Number of measured samples for each case.
+@property(nonatomic) NSUInteger samples;
+
+/// Only cases with names containing the filter are measured, `nil` for every case.
+@property(nonatomic, copy) NSString *filter;
+
+/**
+ Retrieve the results for the measured cases.
+
+ @return Results for the measured cases, in order.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (NSArray *)results;
+
+/**
+ Retrieve the names of the failed cases.
+
+ @return Names of the cases where the block returned `NO`, in order.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (NSArray *)failures;
+
+/**
+ Measure benchmark case.
+
+ @param name Name of the case, e.g. `fetch/narrow/1k`.
+ @param operations Number of operations performed by each call to the block.
+ @param setUp Block called before each sample, excluded from the measurement.
+ @param block Block performing the operations, returns `NO` on failure.
+
+ @return `YES` if the case was measured or filtered, otherwise `NO`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (BOOL)measure:(NSString *)name operations:(NSUInteger)operations setUp:(void (^)(void))setUp block:(BOOL (^)(void))block;
+
+/**
+ Measure benchmark case.
+
+ @param name Name of the case, e.g. `fetch/narrow/1k`.
+ @param operations Number of operations performed by each call to the block.
+ @param block Block performing the operations, returns `NO` on failure.
+
+ @return `YES` if the case was measured or filtered, otherwise `NO`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (BOOL)measure:(NSString *)name operations:(NSUInteger)operations block:(BOOL (^)(void))block;
+
+/**
+ Build the report with the results.
+
+ @return JSON encoded report.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (NSData *)report;
+
+@end
@@ -0,0 +1,139 @@
+//
+//  RABenchmark.m
+//  Benchmark
+//
+//  Created by Tobias Raatiniemi on 2016-12-19.
+//  Copyright (c) 2016 Raatiniemi. All rights reserved.
+//
+
+#import "RABenchmark.h"
+
+#import <sqlite3.h>
+
+#import "RABenchmarkAllocation.h"
+#import "RASqliteHistogram.h"
+
+/**
+ Compare two durations, used for sorting the samples.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static int RABenchmarkCompareDuration(const void *lhs, const void *rhs) {
+    double difference = *(const double *) lhs - *(const double *) rhs;
+    return (difference > 0) - (difference < 0);
+}
+
+@interface RABenchmark () {
+@private
+    NSMutableArray *_results;
+    NSMutableArray *_failures;
+}
+
+@end
+
+@implementation RABenchmark
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _results = [[NSMutableArray alloc] init];
+        _failures = [[NSMutableArray alloc] init];
+        _samples = 5;
+    }
+
+    return self;
+}
+
+- (NSArray *)results {
+    return [_results copy];
+}
+
+- (NSArray *)failures {
+    return [_failures copy];
+}
+
+- (BOOL)measure:(NSString *)name operations:(NSUInteger)operations setUp:(void (^)(void))setUp block:(BOOL (^)(void))block {
+    if (_filter && [name rangeOfString:_filter].location == NSNotFound) {
+        return YES;
+    }
+
+    NSUInteger samples = MAX(_samples, 1);
+    double *durations = calloc(samples, sizeof(double));
+
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+
+    BOOL success = YES;
+    for (NSUInteger sample = 0; sample <= samples && success; sample++) {
+        @autoreleasepool {
+            if (setUp) {
+                setUp();
+            }
+
+            RABenchmarkAllocation before = RABenchmarkAllocationSnapshot();
+            uint64_t start = RASqliteTimestamp();
+            success = block();
+            uint64_t duration = RASqliteTimestamp() - start;
+            RABenchmarkAllocation after = RABenchmarkAllocationSnapshot();
+
+            // The first call is used for warming up the caches.
+            if (sample == 0) {
+                continue;
+            }
+
+            durations[sample - 1] = (double) duration / operations;
+            allocations += after.count - before.count;
+            bytes += after.bytes - before.bytes;
+        }
+    }
+
+    if (!success) {
+        free(durations);
+        fprintf(stderr, "Benchmark `%s` failed.\n", [name UTF8String]);
+        [_failures addObject:name];
+        return NO;
+    }
+
+    qsort(durations, samples, sizeof(double), RABenchmarkCompareDuration);
+
+    double median = durations[samples / 2];
+    NSMutableDictionary *result = [[NSMutableDictionary alloc] init];
+    result[@"name"] = name;
+    result[@"samples"] = @(samples);
+    result[@"operations"] = @(operations);
+    result[@"nsPerOp"] = @(median);
+    result[@"minimumNsPerOp"] = @(durations[0]);
+    result[@"maximumNsPerOp"] = @(durations[samples - 1]);
+    result[@"opsPerSecond"] = @(median > 0 ? 1e9 / median : 0);
+
+    if (RABenchmarkAllocationIsAvailable()) {
+        double total = (double) operations * samples;
+        result[@"allocsPerOp"] = @(allocations / total);
+        result[@"bytesPerOp"] = @(bytes / total);
+    } else {
+        result[@"allocsPerOp"] = [NSNull null];
+        result[@"bytesPerOp"] = [NSNull null];
+    }
+    [_results addObject:result];
+    free(durations);
+
+    fprintf(stderr, "%-32s %14.1f ns/op %14.1f ops/s\n",
+            [name UTF8String], median, [result[@"opsPerSecond"] doubleValue]);
+
+    return YES;
+}
+
+- (BOOL)measure:(NSString *)name operations:(NSUInteger)operations block:(BOOL (^)(void))block {
+    return [self measure:name operations:operations setUp:nil block:block];
+}
+
+- (NSData *)report {
+    NSDictionary *report = @{
+            @"sqlite": @(sqlite3_libversion()),
+            @"samples": @(_samples),
+            @"results": _results
+    };
+
+    return [NSJSONSerialization dataWithJSONObject:report options:NSJSONWritingPrettyPrinted error:nil];
+}
+
+@end
@@ -0,0 +1,43 @@
+//
+//  RABenchmarkAllocation.h
+//  Benchmark
+//
+//  Created by Tobias Raatiniemi on 2016-12-19.
+//  Copyright (c) 2016 Raatiniemi. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/// Snapshot of the allocation counters.
+typedef struct {
+    /// Number of allocations, i.e. calls to `malloc`, `calloc` and `realloc`.
+    uint64_t count;
+
+    /// Number of requested bytes.
+    uint64_t bytes;
+} RABenchmarkAllocation;
+
+/**
+ Check whether the allocations are counted on the current platform.
+
+ @return `YES` if allocations are counted, otherwise `NO`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ Allocations are counted by interposing the allocation functions of the GNU C
+ library, i.e. they are only available when built on Linux.
+ */
+FOUNDATION_EXPORT BOOL RABenchmarkAllocationIsAvailable(void);
+
+/**
+ Retrieve the allocation counters.
+
+ @return Snapshot of the allocation counters.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ The counters are process-wide, i.e. allocations from every thread are counted.
+ */
+FOUNDATION_EXPORT RABenchmarkAllocation RABenchmarkAllocationSnapshot(void);
@@ -0,0 +1,82 @@
+//
+//  RABenchmarkAllocation.m
+//  Benchmark
+//
+//  Created by Tobias Raatiniemi on 2016-12-19.
+//  Copyright (c) 2016 Raatiniemi. All rights reserved.
+//
+
+#import "RABenchmarkAllocation.h"
+
+#import <errno.h>
+#import <stdatomic.h>
+
+#if defined(__GLIBC__)
+
+static _Atomic(uint64_t) RABenchmarkAllocationCount;
+static _Atomic(uint64_t) RABenchmarkAllocationBytes;
+
+// The GNU C library exports its allocator under these names, which allows for
+// interposing the allocation functions without having to resolve them with
+// `dlsym`, which itself allocates.
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *pointer, size_t size);
+extern void *__libc_memalign(size_t alignment, size_t size);
+
+NS_INLINE void RABenchmarkAllocationRecord(size_t bytes) {
+    atomic_fetch_add_explicit(&RABenchmarkAllocationCount, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&RABenchmarkAllocationBytes, bytes, memory_order_relaxed);
+}
+
+void *malloc(size_t size) {
+    RABenchmarkAllocationRecord(size);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) {
+    RABenchmarkAllocationRecord(count * size);
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *pointer, size_t size) {
+    RABenchmarkAllocationRecord(size);
+    return __libc_realloc(pointer, size);
+}
+
+int posix_memalign(void **pointer, size_t alignment, size_t size) {
+    RABenchmarkAllocationRecord(size);
+
+    void *memory = __libc_memalign(alignment, size);
+    if (!memory) {
+        return ENOMEM;
+    }
+
+    *pointer = memory;
+    return 0;
+}
+
+BOOL RABenchmarkAllocationIsAvailable(void) {
+    return YES;
+}
+
+RABenchmarkAllocation RABenchmarkAllocationSnapshot(void) {
+    RABenchmarkAllocation allocation;
+    allocation.count = atomic_load_explicit(&RABenchmarkAllocationCount, memory_order_relaxed);
+    allocation.bytes = atomic_load_explicit(&RABenchmarkAllocationBytes, memory_order_relaxed);
+
+    return allocation;
+}
+
+#else
+
+BOOL RABenchmarkAllocationIsAvailable(void) {
+    return NO;
+}
+
+RABenchmarkAllocation RABenchmarkAllocationSnapshot(void) {
+    RABenchmarkAllocation allocation = {0, 0};
+    return allocation;
+}
+
+#endif
@@ -0,0 +1,60 @@
+//
+//  RALoadGenerator.h
+//  Benchmark
+//
+//  Created by Tobias Raatiniemi on 2016-12-20.
+//  Copyright (c) 2016 Raatiniemi. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ Load generator for measuring the contention between reader and writer threads.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ Readers perform point lookups with `fetchRow:` and range scans with `fetch:`,
+ writers increment counters within `queueTransactionWithBlock:` and update rows
+ with `execute:`. Each operation is performed against a random database.
+ */
+@interface RALoadGenerator : NSObject
+
+/// Duration for each run, in seconds.
+@property(nonatomic) NSTimeInterval duration;
+
+/// Length of the intervals the latencies are reported for, in seconds.
+@property(nonatomic) NSTimeInterval interval;
+
+/**
+ Initialize the load generator, and populate the databases.
+
+ @param directory Directory for the database files.
+ @param databases Number of databases to distribute the operations over.
+
+ @return Initialized load generator, or `nil` if the databases could not be populated.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (instancetype)initWithDirectory:(NSString *)directory databases:(NSUInteger)databases;
+
+/**
+ Run the load with the thread mix.
+
+ @param readers Number of reader threads.
+ @param writers Number of writer threads.
+
+ @return Throughput and latency percentiles, in total and for each interval.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (NSDictionary *)runWithReaders:(NSUInteger)readers writers:(NSUInteger)writers;
+
+/**
+ Close the database connections.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)close;
+
+@end
@@ -0,0 +1,281 @@
+//
+//  RALoadGenerator.m
+//  Benchmark
+//
+//  Created by Tobias Raatiniemi on 2016-12-20.
+//  Copyright (c) 2016 Raatiniemi. All rights reserved.
+//
+
+#import "RALoadGenerator.h"
+
+#import <pthread.h>
+#import <stdatomic.h>
+
+#import "RASqlite.h"
+#import "RASqliteHistogram.h"
+
+/// Number of rows within the item table of each database.
+static const unsigned int RALoadGeneratorRows = 10000;
+
+/// Number of counters within each database.
+static const unsigned int RALoadGeneratorCounters = 16;
+
+/**
+ Entry point for the load threads.
+
+ @param context Retained block to execute.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static void *RALoadGeneratorThread(void *context) {
+    void (^block)(void) = (__bridge_transfer void (^)(void)) context;
+    @autoreleasepool {
+        block();
+    }
+
+    return NULL;
+}
+
+/**
+ Build the summary for the recorded latencies.
+
+ @param histogram Histogram with the recorded latencies, in nanoseconds.
+ @param duration Duration for the recorded latencies, in seconds.
+
+ @return Number of operations, throughput and latency percentiles in milliseconds.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static NSDictionary *RALoadGeneratorSummary(RASqliteHistogram *histogram, NSTimeInterval duration) {
+    return @{
+            @"count": @([histogram count]),
+            @"throughput": @(duration > 0 ? [histogram count] / duration : 0),
+            @"p50": @([histogram valueAtPercentile:50] / 1e6),
+            @"p99": @([histogram valueAtPercentile:99] / 1e6),
+            @"p99.9": @([histogram valueAtPercentile:99.9] / 1e6),
+            @"maximum": @([histogram maximum] / 1e6)
+    };
+}
+
+@interface RALoadGenerator () {
+@private
+    NSArray *_databases;
+}
+
+/**
+ Perform a read operation against a random database.
+
+ @param seed Seed for the thread local random number generator.
+
+ @return `YES` if the operation was successful, otherwise `NO`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (BOOL)readWithSeed:(unsigned int *)seed;
+
+/**
+ Perform a write operation against a random database.
+
+ @param seed Seed for the thread local random number generator.
+
+ @return `YES` if the operation was successful, otherwise `NO`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (BOOL)writeWithSeed:(unsigned int *)seed;
+
+@end
+
+@implementation RALoadGenerator
+
+- (instancetype)initWithDirectory:(NSString *)directory databases:(NSUInteger)databases {
+    if (self = [super init]) {
+        _duration = 10;
+        _interval = 1;
+
+        NSString *series = RASqliteSF(@"WITH RECURSIVE series(i) AS (SELECT 1 UNION ALL SELECT i + 1 FROM series WHERE i < %u) ", RALoadGeneratorRows);
+        NSArray *queries = @[
+                @"CREATE TABLE item(id INTEGER PRIMARY KEY, name TEXT NOT NULL, value INTEGER NOT NULL)",
+                @"CREATE TABLE counter(id INTEGER PRIMARY KEY, value INTEGER NOT NULL)",
+                [series stringByAppendingString:@"INSERT INTO item(id, name, value) SELECT i, printf('item %08d', i), i FROM series"],
+                RASqliteSF(@"%@INSERT INTO counter(id, value) SELECT i, 0 FROM series WHERE i <= %u", series, RALoadGeneratorCounters)
+        ];
+
+        NSMutableArray *connections = [[NSMutableArray alloc] init];
+        for (NSUInteger index = 0; index < databases; index++) {
+            NSString *path = [directory stringByAppendingPathComponent:RASqliteSF(@"load-%lu.db", (unsigned long) index)];
+            RASqlite *db = [[RASqlite alloc] initWithPath:path];
+
+            BOOL __block success;
+            [db queueTransactionWithBlock:^(RASqlite *db, BOOL *commit) {
+                for (NSString *sql in queries) {
+                    if (!(*commit = [db execute:sql])) {
+                        break;
+                    }
+                }
+                success = *commit;
+            }];
+
+            if (!success) {
+                RASqliteErrorLog(@"Unable to populate `%@`: %@", path, [db error]);
+                return nil;
+            }
+            [connections addObject:db];
+        }
+        _databases = [connections copy];
+    }
+
+    return self;
+}
+
+- (BOOL)readWithSeed:(unsigned int *)seed {
+    RASqlite *db = _databases[rand_r(seed) % [_databases count]];
+    unsigned int identifier = rand_r(seed) % RALoadGeneratorRows + 1;
+
+    // Most of the reads are point lookups, the rest are range scans.
+    BOOL scan = rand_r(seed) % 5 == 0;
+
+    // The error is shared by the threads using the connection, i.e. the read
+    // and the reset of the error have to be performed on the query queue.
+    BOOL __block success;
+    [db queueWithBlock:^(RASqlite *db) {
+        if (scan) {
+            success = [db fetch:@"SELECT id, name, value FROM item WHERE id >= ? LIMIT 100" withParam:@(identifier)] != nil;
+        } else {
+            success = [db fetchRow:@"SELECT id, name, value FROM item WHERE id = ?" withParam:@(identifier)] != nil;
+        }
+
+        // The error have to be reset, otherwise no more queries will be executed.
+        if (!success) {
+            [db setError:nil];
+        }
+    }];
+    return success;
+}
+
+- (BOOL)writeWithSeed:(unsigned int *)seed {
+    RASqlite *db = _databases[rand_r(seed) % [_databases count]];
+
+    // Half of the writes are read-modify-write within a transaction, i.e. the
+    // same pattern as incrementing a number from multiple threads.
+    BOOL transaction = rand_r(seed) % 2;
+    NSNumber *counter = @(rand_r(seed) % RALoadGeneratorCounters + 1);
+    NSNumber *identifier = @(rand_r(seed) % RALoadGeneratorRows + 1);
+
+    // The error is shared by the threads using the connection, i.e. the write
+    // and the reset of the error have to be performed on the query queue.
+    BOOL __block success;
+    [db queueWithBlock:^(RASqlite *db) {
+        if (transaction) {
+            [db queueTransaction:RASqliteTransactionImmediate withBlock:^(RASqlite *db, BOOL *commit) {
+                NSDictionary *row = [db fetchRow:@"SELECT value FROM counter WHERE id = ?" withParam:counter];
+                if ((*commit = row != nil)) {
+                    NSNumber *value = @([row[@"value"] longLongValue] + 1);
+                    *commit = [db execute:@"UPDATE counter SET value = ? WHERE id = ?" withParams:@[value, counter]];
+                }
+                success = *commit;
+            }];
+        } else {
+            success = [db execute:@"UPDATE item SET value = value + 1 WHERE id = ?" withParam:identifier];
+        }
+
+        // The error have to be reset, otherwise no more queries will be executed.
+        if (!success) {
+            [db setError:nil];
+        }
+    }];
+    return success;
+}
+
+- (NSDictionary *)runWithReaders:(NSUInteger)readers writers:(NSUInteger)writers {
+    NSTimeInterval interval = MAX(_interval, 0.1);
+    NSUInteger intervals = (NSUInteger) ceil(_duration / interval);
+
+    // Latencies are recorded into the histogram for the current interval, the
+    // histograms are shared by the threads and recorded with atomic counters.
+    NSMutableArray *reads = [[NSMutableArray alloc] init];
+    NSMutableArray *writes = [[NSMutableArray alloc] init];
+    for (NSUInteger index = 0; index < intervals; index++) {
+        [reads addObject:[[RASqliteHistogram alloc] init]];
+        [writes addObject:[[RASqliteHistogram alloc] init]];
+    }
+
+    RASqliteHistogram *totalReads = [[RASqliteHistogram alloc] init];
+    RASqliteHistogram *totalWrites = [[RASqliteHistogram alloc] init];
+
+    uint64_t intervalLength = (uint64_t) (interval * 1e9);
+    uint64_t start = RASqliteTimestamp();
+    uint64_t end = start + intervalLength * intervals;
+
+    _Atomic(uint64_t) *failures = calloc(1, sizeof(_Atomic(uint64_t)));
+
+    NSUInteger threads = readers + writers;
+    pthread_t *identifiers = calloc(threads, sizeof(pthread_t));
+    for (NSUInteger index = 0; index < threads; index++) {
+        BOOL writer = index >= readers;
+        NSArray *histograms = writer ? writes : reads;
+        RASqliteHistogram *total = writer ? totalWrites : totalReads;
+        unsigned int __block seed = (unsigned int) index + 1;
+
+        void (^block)(void) = ^{
+            for (;;) {
+                @autoreleasepool {
+                    uint64_t before = RASqliteTimestamp();
+                    if (before >= end) {
+                        break;
+                    }
+
+                    BOOL success = writer ? [self writeWithSeed:&seed] : [self readWithSeed:&seed];
+                    uint64_t after = RASqliteTimestamp();
+                    if (!success) {
+                        atomic_fetch_add_explicit(failures, 1, memory_order_relaxed);
+                        continue;
+                    }
+
+                    // The operation is attributed to the interval it started in.
+                    NSUInteger current = MIN((before - start) / intervalLength, intervals - 1);
+                    [histograms[current] recordValue:after - before];
+                    [total recordValue:after - before];
+                }
+            }
+        };
+        pthread_create(&identifiers[index], NULL, RALoadGeneratorThread, (__bridge_retained void *) block);
+    }
+
+    for (NSUInteger index = 0; index < threads; index++) {
+        pthread_join(identifiers[index], NULL);
+    }
+    free(identifiers);
+
+    NSMutableArray *timeline = [[NSMutableArray alloc] init];
+    for (NSUInteger index = 0; index < intervals; index++) {
+        [timeline addObject:@{
+                @"time": @((index + 1) * interval),
+                @"reads": RALoadGeneratorSummary(reads[index], interval),
+                @"writes": RALoadGeneratorSummary(writes[index], interval)
+        }];
+    }
+
+    uint64_t failed = atomic_load(failures);
+    free(failures);
+
+    NSTimeInterval duration = intervals * interval;
+    return @{
+            @"readers": @(readers),
+            @"writers": @(writers),
+            @"databases": @([_databases count]),
+            @"duration": @(duration),
+            @"failures": @(failed),
+            @"reads": RALoadGeneratorSummary(totalReads, duration),
+            @"writes": RALoadGeneratorSummary(totalWrites, duration),
+            @"intervals": timeline
+    };
+}
+
+- (void)close {
+    for (RASqlite *db in _databases) {
+        [db close];
+    }
+}
+
+@end
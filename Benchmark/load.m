@@ -0,0 +1,116 @@
+//
+//  load.m
+//  Benchmark
+//
+//  Created by Tobias Raatiniemi on 2016-12-20.
+//  Copyright (c) 2016 Raatiniemi. All rights reserved.
+//
+
+#import "RASqlite.h"
+#import "RALoadGenerator.h"
+
+/**
+ Build the thread mixes to run.
+
+ @param defaults Defaults with the command line arguments.
+
+ @return Array with pairs of reader and writer thread counts.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ With `-sweep 1,2,4,8` each total thread count is run, divided between readers
+ and writers according to `-writeRatio`. Otherwise the `-readers` and `-writers`
+ arguments are used as is.
+ */
+static NSArray *RALoadMixes(NSUserDefaults *defaults) {
+    NSString *sweep = [defaults stringForKey:@"sweep"];
+    if (!sweep) {
+        NSInteger readers = [defaults objectForKey:@"readers"] ? [defaults integerForKey:@"readers"] : 4;
+        NSInteger writers = [defaults objectForKey:@"writers"] ? [defaults integerForKey:@"writers"] : 1;
+
+        return @[@[@(MAX(readers, 0)), @(MAX(writers, 0))]];
+    }
+
+    double ratio = [defaults objectForKey:@"writeRatio"] ? [defaults doubleForKey:@"writeRatio"] : 0.25;
+    ratio = MIN(MAX(ratio, 0), 1);
+
+    NSMutableArray *mixes = [[NSMutableArray alloc] init];
+    for (NSString *value in [sweep componentsSeparatedByString:@","]) {
+        NSInteger threads = [value integerValue];
+        if (threads <= 0) {
+            continue;
+        }
+
+        NSInteger writers = (NSInteger) round(threads * ratio);
+        [mixes addObject:@[@(threads - writers), @(writers)]];
+    }
+
+    return mixes;
+}
+
+int main(int argc, const char *argv[]) {
+    @autoreleasepool {
+        // Arguments are read from the argument domain, e.g. `-readers 8`.
+        NSUserDefaults *defaults = [NSUserDefaults standardUserDefaults];
+
+        NSInteger databases = [defaults objectForKey:@"databases"] ? [defaults integerForKey:@"databases"] : 1;
+        NSArray *mixes = RALoadMixes(defaults);
+        if (databases <= 0 || [mixes count] == 0) {
+            fprintf(stderr, "usage: RASqliteLoad [-readers n] [-writers n] [-sweep 1,2,4,8 [-writeRatio 0.25]]\n"
+                    "                    [-databases n] [-duration seconds] [-interval seconds] [-output path]\n");
+            return 1;
+        }
+
+        NSString *directory = [NSTemporaryDirectory() stringByAppendingPathComponent:
+                RASqliteSF(@"rasqlite-load-%d", [[NSProcessInfo processInfo] processIdentifier])];
+
+        RALoadGenerator *generator = [[RALoadGenerator alloc] initWithDirectory:directory databases:(NSUInteger) databases];
+        if (!generator) {
+            [[NSFileManager defaultManager] removeItemAtPath:directory error:nil];
+            return 1;
+        }
+        if ([defaults doubleForKey:@"duration"] > 0) {
+            [generator setDuration:[defaults doubleForKey:@"duration"]];
+        }
+        if ([defaults doubleForKey:@"interval"] > 0) {
+            [generator setInterval:[defaults doubleForKey:@"interval"]];
+        }
+
+        NSMutableArray *runs = [[NSMutableArray alloc] init];
+        uint64_t failures = 0;
+        for (NSArray *mix in mixes) {
+            NSDictionary *run = [generator runWithReaders:[mix[0] unsignedIntegerValue] writers:[mix[1] unsignedIntegerValue]];
+            [runs addObject:run];
+            failures += [run[@"failures"] unsignedLongLongValue];
+
+            fprintf(stderr, "readers %3lu writers %3lu  reads %10.1f/s p99 %8.3f ms  writes %10.1f/s p99 %8.3f ms\n",
+                    [mix[0] unsignedLongValue], [mix[1] unsignedLongValue],
+                    [run[@"reads"][@"throughput"] doubleValue], [run[@"reads"][@"p99"] doubleValue],
+                    [run[@"writes"][@"throughput"] doubleValue], [run[@"writes"][@"p99"] doubleValue]);
+        }
+
+        [generator close];
+        [[NSFileManager defaultManager] removeItemAtPath:directory error:nil];
+
+        NSDictionary *report = @{@"sqlite": @(sqlite3_libversion()), @"runs": runs};
+        NSData *data = [NSJSONSerialization dataWithJSONObject:report options:NSJSONWritingPrettyPrinted error:nil];
+
+        NSString *output = [defaults stringForKey:@"output"];
+        if (output) {
+            [data writeToFile:output atomically:YES];
+        } else {
+            fwrite([data bytes], 1, [data length], stdout);
+            fputc('\n', stdout);
+        }
+
+        // Failed operations are excluded from the latencies, i.e. the report
+        // would otherwise look better than the actual run.
+        if (failures > 0) {
+            fprintf(stderr, "%llu operations failed\n", (unsigned long long) failures);
+            return 1;
+        }
+    }
+
+    return 0;
+}
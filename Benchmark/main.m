@@ -0,0 +1,260 @@
+//
+//  main.m
+//  Benchmark
+//
+//  Created by Tobias Raatiniemi on 2016-12-19.
+//  Copyright (c) 2016 Raatiniemi. All rights reserved.
+//
+
+#import "RASqlite.h"
+#import "RABenchmark.h"
+
+/// Number of rows within the narrow and wide tables.
+static const NSUInteger RABenchmarkRows = 100000;
+
+/// Number of point lookups for each sample.
+static const NSUInteger RABenchmarkLookups = 1000;
+
+/// Size of the large blob values, i.e. 1 MiB.
+static const NSUInteger RABenchmarkBlobSize = 1 << 20;
+
+/**
+ Populate the tables used by the read benchmarks.
+
+ @param db Database to populate.
+
+ @return `YES` if the tables have been populated, otherwise `NO`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static BOOL RABenchmarkPopulate(RASqlite *db) {
+    BOOL __block success = YES;
+
+    [db queueTransactionWithBlock:^(RASqlite *db, BOOL *commit) {
+        NSString *series = RASqliteSF(@"WITH RECURSIVE series(i) AS (SELECT 1 UNION ALL SELECT i + 1 FROM series WHERE i < %lu) ", (unsigned long) RABenchmarkRows);
+
+        NSArray *queries = @[
+                @"CREATE TABLE narrow(id INTEGER PRIMARY KEY, name TEXT NOT NULL)",
+                @"CREATE TABLE wide(id INTEGER PRIMARY KEY, a TEXT, b TEXT, c TEXT, d TEXT, e INTEGER, f INTEGER, g INTEGER, h INTEGER, i REAL, j REAL, k REAL, l REAL, m TEXT, n TEXT, o INTEGER)",
+                [series stringByAppendingString:@"INSERT INTO narrow(id, name) SELECT i, printf('name %08d', i) FROM series"],
+                [series stringByAppendingString:@"INSERT INTO wide SELECT i, printf('a %08d', i), printf('b %08d', i), printf('c %08d', i), printf('d %08d', i), i, i * 2, i * 3, i * 4, i / 2.0, i / 3.0, i / 4.0, i / 5.0, printf('m %08d', i), printf('n %08d', i), i * 5 FROM series"],
+                @"CREATE TABLE insertion(id INTEGER PRIMARY KEY, name TEXT, value INTEGER)",
+                @"CREATE TABLE text_value(value TEXT)",
+                @"CREATE TABLE integer_value(value INTEGER)",
+                @"CREATE TABLE blob_value(value BLOB)"
+        ];
+
+        for (NSString *sql in queries) {
+            if (!(*commit = [db execute:sql])) {
+                break;
+            }
+        }
+        success = *commit;
+    }];
+
+    return success;
+}
+
+/**
+ Remove every row from the table.
+
+ @param db Database with the table.
+ @param table Name of the table.
+
+ @return Block removing every row from the table.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static void (^RABenchmarkTruncate(RASqlite *db, NSString *table))(void) {
+    return ^{
+        [db execute:RASqliteSF(@"DELETE FROM %@", table)];
+    };
+}
+
+/**
+ Benchmark the point lookups with `fetchRow:`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static void RABenchmarkFetchRow(RABenchmark *benchmark, RASqlite *db) {
+    NSMutableArray *identifiers = [[NSMutableArray alloc] initWithCapacity:RABenchmarkLookups];
+    srandom(1);
+    for (NSUInteger index = 0; index < RABenchmarkLookups; index++) {
+        [identifiers addObject:@(random() % RABenchmarkRows + 1)];
+    }
+
+    [benchmark measure:@"fetchRow/point" operations:RABenchmarkLookups block:^BOOL {
+        for (NSNumber *identifier in identifiers) {
+            if (![db fetchRow:@"SELECT id, name FROM narrow WHERE id = ?" withParam:identifier]) {
+                return NO;
+            }
+        }
+        return YES;
+    }];
+}
+
+/**
+ Benchmark fetching 1k and 100k rows, of narrow and wide tables, with `fetch:`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static void RABenchmarkFetch(RABenchmark *benchmark, RASqlite *db) {
+    for (NSString *table in @[@"narrow", @"wide"]) {
+        for (NSNumber *rows in @[@1000, @(RABenchmarkRows)]) {
+            NSString *name = RASqliteSF(@"fetch/%@/%luk", table, [rows unsignedLongValue] / 1000);
+            NSString *sql = RASqliteSF(@"SELECT * FROM %@ LIMIT %@", table, rows);
+
+            // Each fetched row is considered an operation.
+            [benchmark measure:name operations:[rows unsignedIntegerValue] block:^BOOL {
+                return [[db fetch:sql] count] == [rows unsignedIntegerValue];
+            }];
+        }
+    }
+}
+
+/**
+ Benchmark single, i.e. auto-committed, versus batched inserts with `execute:`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static void RABenchmarkExecute(RABenchmark *benchmark, RASqlite *db) {
+    NSString *sql = @"INSERT INTO insertion(name, value) VALUES(?, ?)";
+
+    // Every single insert is committed, i.e. synced to disk.
+    NSUInteger single = 100;
+    [benchmark measure:@"execute/insert/single" operations:single setUp:RABenchmarkTruncate(db, @"insertion") block:^BOOL {
+        for (NSUInteger index = 0; index < single; index++) {
+            if (![db execute:sql withParams:@[@"name", @(index)]]) {
+                return NO;
+            }
+        }
+        return YES;
+    }];
+
+    NSUInteger batched = 10000;
+    [benchmark measure:@"execute/insert/batched" operations:batched setUp:RABenchmarkTruncate(db, @"insertion") block:^BOOL {
+        BOOL __block success;
+        [db queueTransactionWithBlock:^(RASqlite *db, BOOL *commit) {
+            for (NSUInteger index = 0; index < batched; index++) {
+                if (!(*commit = [db execute:sql withParams:@[@"name", @(index)]])) {
+                    break;
+                }
+            }
+            success = *commit;
+        }];
+        return success;
+    }];
+}
+
+/**
+ Benchmark the binding and mapping of values by type.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static void RABenchmarkBindAndMap(RABenchmark *benchmark, RASqlite *db) {
+    NSMutableData *blob = [[NSMutableData alloc] initWithLength:RABenchmarkBlobSize];
+    memset([blob mutableBytes], 0xab, RABenchmarkBlobSize);
+
+    NSDictionary *values = @{
+            @"text": @"The quick brown fox jumps over the lazy dog",
+            @"integer": @(INT64_MAX),
+            @"blob": blob
+    };
+
+    for (NSString *type in @[@"text", @"integer", @"blob"]) {
+        NSString *table = RASqliteSF(@"%@_value", type);
+        NSString *insert = RASqliteSF(@"INSERT INTO %@(value) VALUES(?)", table);
+        NSString *select = RASqliteSF(@"SELECT value FROM %@", table);
+
+        id value = values[type];
+        NSUInteger operations = [type isEqualToString:@"blob"] ? 50 : 10000;
+
+        // The inserts are batched within a transaction to keep the cost of
+        // committing out of the measurement.
+        [benchmark measure:RASqliteSF(@"bind/%@", type) operations:operations setUp:RABenchmarkTruncate(db, table) block:^BOOL {
+            BOOL __block success;
+            [db queueTransactionWithBlock:^(RASqlite *db, BOOL *commit) {
+                for (NSUInteger index = 0; index < operations; index++) {
+                    if (!(*commit = [db execute:insert withParam:value])) {
+                        break;
+                    }
+                }
+                success = *commit;
+            }];
+            return success;
+        }];
+
+        // The table is left populated from the bind benchmark.
+        [benchmark measure:RASqliteSF(@"map/%@", type) operations:operations block:^BOOL {
+            return [[db fetch:select] count] == operations;
+        }];
+    }
+}
+
+/**
+ Benchmark the throughput for committing transactions.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static void RABenchmarkTransaction(RABenchmark *benchmark, RASqlite *db) {
+    NSUInteger transactions = 100;
+    [benchmark measure:@"transaction/commit" operations:transactions setUp:RABenchmarkTruncate(db, @"insertion") block:^BOOL {
+        for (NSUInteger index = 0; index < transactions; index++) {
+            BOOL __block success;
+            [db queueTransactionWithBlock:^(RASqlite *db, BOOL *commit) {
+                success = *commit = [db execute:@"INSERT INTO insertion(name, value) VALUES(?, ?)" withParams:@[@"name", @(index)]];
+            }];
+
+            if (!success) {
+                return NO;
+            }
+        }
+        return YES;
+    }];
+}
+
+int main(int argc, const char *argv[]) {
+    @autoreleasepool {
+        // Arguments are read from the argument domain, e.g. `-filter fetch`.
+        NSUserDefaults *defaults = [NSUserDefaults standardUserDefaults];
+
+        RABenchmark *benchmark = [[RABenchmark alloc] init];
+        [benchmark setFilter:[defaults stringForKey:@"filter"]];
+        if ([defaults integerForKey:@"samples"] > 0) {
+            [benchmark setSamples:(NSUInteger) [defaults integerForKey:@"samples"]];
+        }
+
+        NSString *directory = [NSTemporaryDirectory() stringByAppendingPathComponent:
+                RASqliteSF(@"rasqlite-benchmark-%d", [[NSProcessInfo processInfo] processIdentifier])];
+        NSString *path = [directory stringByAppendingPathComponent:@"benchmark.db"];
+
+        RASqlite *db = [[RASqlite alloc] initWithPath:path];
+        if (!RABenchmarkPopulate(db)) {
+            fprintf(stderr, "Unable to populate the database: %s\n", [[[db error] description] UTF8String]);
+            return 1;
+        }
+
+        RABenchmarkFetchRow(benchmark, db);
+        RABenchmarkFetch(benchmark, db);
+        RABenchmarkExecute(benchmark, db);
+        RABenchmarkBindAndMap(benchmark, db);
+        RABenchmarkTransaction(benchmark, db);
+
+        // Failed cases are excluded from the report, i.e. the exit status is
+        // the only way for CI to detect a broken run.
+        BOOL failed = [db error] != nil || [[benchmark failures] count] > 0;
+        [db close];
+        [[NSFileManager defaultManager] removeItemAtPath:directory error:nil];
+
+        NSData *report = [benchmark report];
+        NSString *output = [defaults stringForKey:@"output"];
+        if (output) {
+            [report writeToFile:output atomically:YES];
+        } else {
+            fwrite([report bytes], 1, [report length], stdout);
+            fputc('\n', stdout);
+        }
+
+        return failed ? 1 : 0;
+    }
+}
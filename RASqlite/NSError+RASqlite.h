@@ -23,9 +23,22 @@ typedef NS_ENUM(short int, RASqliteErrorCode) {
             RASqliteErrorQuery,
 
     /// Error code related to transaction.
-            RASqliteErrorTransaction
+            RASqliteErrorTransaction,
+
+    /// Error code related to interrupted queries, i.e. cancelled or timed out.
+            RASqliteErrorInterrupt,
+
+    /// Error code related to reading from or writing to streams.
+            RASqliteErrorStream,
+
+    /// Error code related to failed integrity checks, i.e. corrupted database.
+            RASqliteErrorIntegrity
 };
 
+/// Key for the offset of the failing statement within a script, the value
+/// is a `NSNumber` with the offset in bytes from the beginning of the script.
+FOUNDATION_EXPORT NSString *const RASqliteErrorOffsetKey;
+
 /**
  Simplified handling for RASqlite errors.
 
@@ -49,4 +62,16 @@ typedef NS_ENUM(short int, RASqliteErrorCode) {
  */
 + (instancetype)code:(RASqliteErrorCode)code message:(NSString *)message, ...;
 
+/**
+ Creates a copy of the error with the offset of the failing statement.
+
+ @param offset Offset in bytes from the beginning of the script.
+
+ @return Error with domain, code, and user info from the error, with the offset
+ available under the `RASqliteErrorOffsetKey`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (instancetype)errorWithOffset:(NSUInteger)offset;
+
 @end
\ No newline at end of file
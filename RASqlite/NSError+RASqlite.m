@@ -11,6 +11,8 @@
 /// Error domain for RASqlite related errors.
 static NSString *RASqliteErrorDomain = @"me.raatiniemi.rasqlite.error";
 
+NSString *const RASqliteErrorOffsetKey = @"me.raatiniemi.rasqlite.error.offset";
+
 @implementation NSError (RASqlite)
 
 + (instancetype)code:(RASqliteErrorCode)code message:(NSString *)message, ... {
@@ -31,4 +33,11 @@ static NSString *RASqliteErrorDomain = @"me.raatiniemi.rasqlite.error";
     return [[self class] errorWithDomain:RASqliteErrorDomain code:code userInfo:userInfo];
 }
 
+- (instancetype)errorWithOffset:(NSUInteger)offset {
+    NSMutableDictionary *userInfo = [NSMutableDictionary dictionaryWithDictionary:[self userInfo]];
+    userInfo[RASqliteErrorOffsetKey] = @(offset);
+
+    return [[self class] errorWithDomain:[self domain] code:[self code] userInfo:userInfo];
+}
+
 @end
\ No newline at end of file
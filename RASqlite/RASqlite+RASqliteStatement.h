@@ -0,0 +1,126 @@
+//
+//  RASqlite+RASqliteStatement.h
+//  RASqlite
+//
+//  Created by Tobias Raatiniemi on 2016-12-22.
+//  Copyright (c) 2016 Raatiniemi. All rights reserved.
+//
+
+#import "RASqlite.h"
+
+/**
+ Statement level functionality used within the library, e.g. by the categories.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ The methods are implemented within `RASqlite.m` and are not part of the public
+ interface.
+ */
+@interface RASqlite (RASqliteStatement)
+
+/**
+ Execute update query with a cached statement, with parameters.
+
+ @param sql Query to perform against the database.
+ @param params Parameters to bind to the query.
+
+ @return `YES` if query was successfully executed, otherwise `NO`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ The statement is prepared the first time the query is executed, and reused
+ for subsequent calls with the same query, i.e. repeated queries only have to
+ bind the parameters.
+ */
+- (BOOL)executeCached:(NSString *)sql withParams:(NSArray *)params;
+
+/**
+ Execute update query with a cached statement, with parameters and cancellation token.
+
+ @param sql Query to perform against the database.
+ @param params Parameters to bind to the query.
+ @param token Token for cancelling the query, or `nil`.
+
+ @return `YES` if query was successfully executed, otherwise `NO`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (BOOL)executeCached:(NSString *)sql withParams:(NSArray *)params cancellationToken:(RASqliteCancellationToken *)token;
+
+/**
+ Fetch rows with a cached statement, with parameters.
+
+ @param sql Query to perform against the database.
+ @param params Parameters to bind to the query.
+
+ @return Array with the rows, or `nil` if an error occurred.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ Uses the same statement cache as `executeCached:withParams:`, i.e. for
+ queries that are executed repeatedly, e.g. searching while typing.
+ */
+- (NSArray *)fetchCached:(NSString *)sql withParams:(NSArray *)params;
+
+/**
+ Fetch rows with a cached statement, with parameters and cancellation token.
+
+ @param sql Query to perform against the database.
+ @param params Parameters to bind to the query.
+ @param token Token for cancelling the query, or `nil`.
+
+ @return Array with the rows, or `nil` if an error occurred.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (NSArray *)fetchCached:(NSString *)sql withParams:(NSArray *)params cancellationToken:(RASqliteCancellationToken *)token;
+
+/**
+ Step through the rows for the query, with parameters.
+
+ @param sql Query to perform against the database.
+ @param params Parameters to bind to the query.
+ @param block Block called with the statement for each row, returns `NO` to stop.
+
+ @return `YES` if every row have been stepped through, otherwise `NO`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ The block is called on the query queue with the statement positioned on the
+ row, i.e. the columns can be read without building a dictionary for each row.
+ If the block stops the iteration it is responsible for setting the error.
+ */
+- (BOOL)stepQuery:(NSString *)sql withParams:(NSArray *)params usingBlock:(BOOL (^)(sqlite3_stmt *statement))block;
+
+/**
+ Step through the rows for the query, with parameters and cancellation token.
+
+ @param sql Query to perform against the database.
+ @param params Parameters to bind to the query.
+ @param token Token for cancelling the query, or `nil`.
+ @param block Block called with the statement for each row, returns `NO` to stop.
+
+ @return `YES` if every row have been stepped through, otherwise `NO`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (BOOL)stepQuery:(NSString *)sql withParams:(NSArray *)params cancellationToken:(RASqliteCancellationToken *)token usingBlock:(BOOL (^)(sqlite3_stmt *statement))block;
+
+/**
+ Change the id for the last inserted row.
+
+ @param insertId Id for the last inserted row.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ Used for detecting whether a query inserted a row, since the id is only
+ changed by inserts.
+ */
+- (void)setLastInsertId:(NSNumber *)insertId;
+
+@end
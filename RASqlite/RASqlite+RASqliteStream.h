@@ -0,0 +1,88 @@
+//
+//  RASqlite+RASqliteStream.h
+//  RASqlite
+//
+//  Created by Tobias Raatiniemi on 2016-12-23.
+//  Copyright (c) 2016 Raatiniemi. All rights reserved.
+//
+
+#import "RASqlite.h"
+
+// -- -- Format
+
+/// Available stream formats.
+typedef NS_ENUM(short int, RASqliteStreamFormat) {
+    /// Comma-separated values, with the column names as header record.
+            RASqliteStreamFormatCSV,
+
+    /// Newline-delimited JSON, with one object per row.
+            RASqliteStreamFormatNDJSON
+};
+
+@interface RASqlite (RASqliteStream)
+
+#pragma mark - Export
+
+/**
+ Export the result of a query to a stream.
+
+ @param sql Query to export.
+ @param params Parameters to bind to the query.
+ @param stream Stream to write to, opened if not already open.
+ @param format Format of the exported rows.
+
+ @return `YES` if every row have been exported, otherwise `NO`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ The rows are written directly from the statement to the stream, i.e. the
+ result is never materialized. The database queue is held until the export is
+ finished, and the stream is left open.
+
+ `NULL` is exported as an empty field for CSV and as `null` for NDJSON, while
+ blobs are exported as base64 encoded strings. The CSV header record is written
+ with the first row, i.e. nothing is written for an empty result.
+ */
+- (BOOL)exportQuery:(NSString *)sql withParams:(NSArray *)params toStream:(NSOutputStream *)stream format:(RASqliteStreamFormat)format;
+
+/**
+ Export the result of a query to a stream.
+
+ @param sql Query to export.
+ @param stream Stream to write to, opened if not already open.
+ @param format Format of the exported rows.
+
+ @return `YES` if every row have been exported, otherwise `NO`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (BOOL)exportQuery:(NSString *)sql toStream:(NSOutputStream *)stream format:(RASqliteStreamFormat)format;
+
+#pragma mark - Import
+
+/**
+ Import rows from a stream into a table.
+
+ @param stream Stream to read from, opened if not already open.
+ @param table Name of the table, have to be defined within the structure.
+ @param format Format of the imported rows.
+
+ @return `YES` if every row have been imported, otherwise `NO`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @throws NSException If the table is not defined within the structure.
+
+ @note
+ The values are converted according to the column definitions, e.g. base64
+ encoded strings are decoded for blob columns. The rows are inserted in chunks,
+ each chunk within a savepoint, and the memory usage is independent of the
+ size of the stream.
+
+ If a chunk fails the chunk is rolled back and the import is aborted, the
+ previously imported chunks are kept.
+ */
+- (BOOL)importStream:(NSInputStream *)stream intoTable:(NSString *)table format:(RASqliteStreamFormat)format;
+
+@end
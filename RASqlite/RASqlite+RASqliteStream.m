@@ -0,0 +1,580 @@
+//
+//  RASqlite+RASqliteStream.m
+//  RASqlite
+//
+//  Created by Tobias Raatiniemi on 2016-12-23.
+//  Copyright (c) 2016 Raatiniemi. All rights reserved.
+//
+
+#import "RASqlite+RASqliteStream.h"
+#import "RASqlite+RASqliteStatement.h"
+#import "RASqliteStreamReader.h"
+#import "RASqliteStreamWriter.h"
+#import "NSError+RASqlite.h"
+#import "RASqliteCompressor.h"
+
+// -- -- Exception
+
+/// Exception name for issues with importing rows.
+static NSString *RASqliteImportException = @"Import stream";
+
+/// Number of rows imported within each savepoint.
+static const NSUInteger RASqliteImportBatchSize = 1000;
+
+#pragma mark - Export
+
+/**
+ Write a CSV field, quoted if the value contain a separator, quote or line break.
+
+ @param writer Writer to append the field to.
+ @param value Value of the field.
+ @param length Length of the value, in bytes.
+
+ @return `YES` if the field have been written, otherwise `NO`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static BOOL RASqliteWriteCSVField(RASqliteStreamWriter *writer, const char *value, NSUInteger length) {
+    // Empty strings are quoted, unquoted empty fields are reserved for `NULL`.
+    BOOL quote = length == 0;
+    for (NSUInteger i = 0; i < length && !quote; i++) {
+        char c = value[i];
+        quote = c == ',' || c == '"' || c == '\r' || c == '\n';
+    }
+
+    if (!quote) {
+        return [writer appendBytes:value length:length];
+    }
+
+    if (![writer appendString:"\""]) {
+        return NO;
+    }
+
+    // Quotes within the value are escaped by doubling them.
+    NSUInteger start = 0;
+    for (NSUInteger i = 0; i < length; i++) {
+        if (value[i] != '"') {
+            continue;
+        }
+
+        if (![writer appendBytes:value + start length:i - start + 1] || ![writer appendString:"\""]) {
+            return NO;
+        }
+        start = i + 1;
+    }
+
+    return [writer appendBytes:value + start length:length - start] && [writer appendString:"\""];
+}
+
+/**
+ Write a JSON string, with the characters escaped.
+
+ @param writer Writer to append the string to.
+ @param value Value of the string.
+ @param length Length of the value, in bytes.
+
+ @return `YES` if the string have been written, otherwise `NO`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static BOOL RASqliteWriteJSONString(RASqliteStreamWriter *writer, const char *value, NSUInteger length) {
+    if (![writer appendString:"\""]) {
+        return NO;
+    }
+
+    NSUInteger start = 0;
+    for (NSUInteger i = 0; i < length; i++) {
+        unsigned char c = (unsigned char) value[i];
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            continue;
+        }
+
+        char escaped[8];
+        switch (c) {
+            case '"':
+                strcpy(escaped, "\\\"");
+                break;
+            case '\\':
+                strcpy(escaped, "\\\\");
+                break;
+            case '\n':
+                strcpy(escaped, "\\n");
+                break;
+            case '\r':
+                strcpy(escaped, "\\r");
+                break;
+            case '\t':
+                strcpy(escaped, "\\t");
+                break;
+            default:
+                snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                break;
+        }
+
+        if (![writer appendBytes:value + start length:i - start] || ![writer appendString:escaped]) {
+            return NO;
+        }
+        start = i + 1;
+    }
+
+    return [writer appendBytes:value + start length:length - start] && [writer appendString:"\""];
+}
+
+/**
+ Write the value of a column, formatted for the stream format.
+
+ @param writer Writer to append the value to.
+ @param statement Statement positioned at the row.
+ @param index Index of the column.
+ @param format Format of the stream.
+
+ @return `YES` if the value have been written, otherwise `NO`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static BOOL RASqliteWriteColumn(RASqliteStreamWriter *writer, sqlite3_stmt *statement, int index, RASqliteStreamFormat format) {
+    BOOL csv = format == RASqliteStreamFormatCSV;
+    char number[32];
+
+    switch (sqlite3_column_type(statement, index)) {
+        case SQLITE_INTEGER:
+            snprintf(number, sizeof(number), "%lld", sqlite3_column_int64(statement, index));
+            return [writer appendString:number];
+        case SQLITE_FLOAT: {
+            double value = sqlite3_column_double(statement, index);
+            // JSON do not support infinity or NaN.
+            if (!csv && !isfinite(value)) {
+                return [writer appendString:"null"];
+            }
+
+            snprintf(number, sizeof(number), "%.17g", value);
+            return [writer appendString:number];
+        }
+        case SQLITE_TEXT: {
+            const char *value = (const char *) sqlite3_column_text(statement, index);
+            NSUInteger length = (NSUInteger) sqlite3_column_bytes(statement, index);
+
+            return csv ? RASqliteWriteCSVField(writer, value, length) : RASqliteWriteJSONString(writer, value, length);
+        }
+        case SQLITE_BLOB: {
+            const void *bytes = sqlite3_column_blob(statement, index);
+            NSUInteger length = (NSUInteger) sqlite3_column_bytes(statement, index);
+
+            // Compressed values are exported with their original type.
+            id value = [RASqliteCompressor decompressBytes:bytes length:length];
+            if ([value isKindOfClass:[NSString class]]) {
+                const char *text = [value UTF8String];
+                return csv ? RASqliteWriteCSVField(writer, text, strlen(text)) : RASqliteWriteJSONString(writer, text, strlen(text));
+            }
+
+            NSData *data = value ?: [[NSData alloc] initWithBytesNoCopy:(void *) bytes length:length freeWhenDone:NO];
+            NSData *encoded = [data base64EncodedDataWithOptions:0];
+
+            // Base64 never contain characters that have to be quoted or escaped,
+            // except for empty blobs which have to be quoted as CSV.
+            if (csv && [encoded length] > 0) {
+                return [writer appendBytes:[encoded bytes] length:[encoded length]];
+            }
+
+            return csv ? RASqliteWriteCSVField(writer, [encoded bytes], [encoded length]) : RASqliteWriteJSONString(writer, [encoded bytes], [encoded length]);
+        }
+        default:
+            return csv ? YES : [writer appendString:"null"];
+    }
+}
+
+#pragma mark - Import
+
+/**
+ Convert an imported value according to the column definition.
+
+ @param value Value from the stream, i.e. `NSString`, `NSNumber` or `NSNull`.
+ @param column Definition for the column.
+
+ @return Converted value, or `nil` if the value can not be converted.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ Numeric strings that can not be parsed are kept as is, i.e. the column
+ affinity will determine how the value is stored.
+ */
+static id RASqliteImportValue(id value, RASqliteColumn *column) {
+    if ([value isKindOfClass:[NSNull class]]) {
+        return value;
+    }
+
+    if (![value isKindOfClass:[NSString class]] && ![value isKindOfClass:[NSNumber class]]) {
+        return nil;
+    }
+
+    if (![value isKindOfClass:[NSString class]]) {
+        return value;
+    }
+
+    const char *string = [value UTF8String];
+    char *end = NULL;
+
+    switch ([column numericType]) {
+        case RASqliteInteger: {
+            long long number = strtoll(string, &end, 10);
+            return *string && end && *end == '\0' ? @(number) : value;
+        }
+        case RASqliteReal: {
+            double number = strtod(string, &end);
+            return *string && end && *end == '\0' ? @(number) : value;
+        }
+        case RASqliteBlob:
+            return [[NSData alloc] initWithBase64EncodedString:value options:0];
+        default:
+            return value;
+    }
+}
+
+/**
+ Build query for inserting the columns into the table.
+
+ @param table Name of the table.
+ @param columns Column definitions for the columns within the row.
+
+ @return Query inserting the row.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static NSString *RASqliteImportQuery(NSString *table, NSArray *columns) {
+    NSMutableArray *names = [[NSMutableArray alloc] initWithCapacity:[columns count]];
+    NSMutableArray *placeholders = [[NSMutableArray alloc] initWithCapacity:[columns count]];
+
+    for (RASqliteColumn *column in columns) {
+        [names addObject:[column name]];
+        [placeholders addObject:@"?"];
+    }
+
+    return RASqliteSF(@"INSERT INTO %@(%@) VALUES(%@)",
+            table,
+            [names componentsJoinedByString:@", "],
+            [placeholders componentsJoinedByString:@", "]);
+}
+
+@interface RASqlite (RASqliteStreamPrivate)
+
+/**
+ Read the next row from the stream.
+
+ @param reader Reader for the stream.
+ @param format Format of the stream.
+ @param table Name of the table.
+ @param columns Column definitions for the table, keyed by name.
+ @param header Column definitions from the CSV header record.
+ @param queries Cache for the queries, keyed by the column names.
+ @param failed Set to `YES` if the row is invalid.
+
+ @return Array with the query and its parameters, `nil` at the end of the stream or on failure.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (NSArray *)readRowFromReader:(RASqliteStreamReader *)reader format:(RASqliteStreamFormat)format table:(NSString *)table columns:(NSDictionary *)columns header:(NSArray *)header queries:(NSMutableDictionary *)queries failed:(BOOL *)failed;
+
+/**
+ Insert chunk of rows within a savepoint.
+
+ @param rows Array with the query and parameters for each row.
+ @param table Name of the table.
+
+ @return `YES` if every row have been inserted, otherwise `NO`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (BOOL)importChunk:(NSArray *)rows intoTable:(NSString *)table;
+
+@end
+
+@implementation RASqlite (RASqliteStream)
+
+#pragma mark - Export
+
+- (BOOL)exportQuery:(NSString *)sql withParams:(NSArray *)params toStream:(NSOutputStream *)stream format:(RASqliteStreamFormat)format {
+    RASqliteStreamWriter *writer = [[RASqliteStreamWriter alloc] initWithStream:stream];
+
+    // The column names are encoded once, i.e. every row only have to write
+    // the values.
+    NSMutableArray *__block names;
+    BOOL __block written = YES;
+
+    BOOL exported = [self stepQuery:sql withParams:params usingBlock:^BOOL(sqlite3_stmt *statement) {
+        int count = sqlite3_column_count(statement);
+        BOOL csv = format == RASqliteStreamFormatCSV;
+
+        if (!names) {
+            names = [[NSMutableArray alloc] initWithCapacity:(NSUInteger) count];
+
+            for (int index = 0; index < count; index++) {
+                NSOutputStream *buffer = [NSOutputStream outputStreamToMemory];
+                RASqliteStreamWriter *encoder = [[RASqliteStreamWriter alloc] initWithStream:buffer];
+
+                const char *name = sqlite3_column_name(statement, index);
+                if (csv) {
+                    RASqliteWriteCSVField(encoder, name, strlen(name));
+                } else {
+                    [encoder appendString:index == 0 ? "{" : ","];
+                    RASqliteWriteJSONString(encoder, name, strlen(name));
+                    [encoder appendString:":"];
+                }
+                [encoder flush];
+
+                [names addObject:[buffer propertyForKey:NSStreamDataWrittenToMemoryStreamKey]];
+            }
+
+            if (csv) {
+                for (int index = 0; index < count && written; index++) {
+                    NSData *name = names[(NSUInteger) index];
+                    written = (index == 0 || [writer appendString:","]) && [writer appendBytes:[name bytes] length:[name length]];
+                }
+                written = written && [writer appendString:"\n"];
+            }
+        }
+
+        for (int index = 0; index < count && written; index++) {
+            if (csv) {
+                written = index == 0 || [writer appendString:","];
+            } else {
+                NSData *name = names[(NSUInteger) index];
+                written = [writer appendBytes:[name bytes] length:[name length]];
+            }
+
+            written = written && RASqliteWriteColumn(writer, statement, index, format);
+        }
+
+        if (written) {
+            written = [writer appendString:csv ? "\n" : (count == 0 ? "{}\n" : "}\n")];
+        }
+
+        return written;
+    }];
+
+    if (exported) {
+        written = [writer flush];
+    }
+
+    if (!written) {
+        NSString *message = RASqliteSF(@"Unable to write to stream: %@", [[stream streamError] localizedDescription]);
+        RASqliteErrorLog(@"%@", message);
+
+        [self setError:[NSError code:RASqliteErrorStream message:message]];
+    }
+
+    return exported && written;
+}
+
+- (BOOL)exportQuery:(NSString *)sql toStream:(NSOutputStream *)stream format:(RASqliteStreamFormat)format {
+    return [self exportQuery:sql withParams:nil toStream:stream format:format];
+}
+
+#pragma mark - Import
+
+- (BOOL)importStream:(NSInputStream *)stream intoTable:(NSString *)table format:(RASqliteStreamFormat)format {
+    NSArray *structure = [self structure][table];
+    if (!structure) {
+        [NSException raise:RASqliteImportException
+                    format:@"Unable to import stream, table `%@` is not defined within the structure.", table];
+    }
+
+    NSMutableDictionary *columns = [[NSMutableDictionary alloc] init];
+    for (id item in structure) {
+        if ([item isKindOfClass:[RASqliteColumn class]]) {
+            columns[[item name]] = item;
+        }
+    }
+
+    [self setError:nil];
+
+    RASqliteStreamReader *reader = [[RASqliteStreamReader alloc] initWithStream:stream];
+    NSMutableDictionary *queries = [[NSMutableDictionary alloc] init];
+
+    // For CSV the columns are determined by the header record.
+    NSMutableArray *header;
+    if (format == RASqliteStreamFormatCSV) {
+        NSArray *names = [reader nextRecord];
+        if (!names) {
+            if ([reader hasFailed]) {
+                [self setError:[NSError code:RASqliteErrorStream message:@"Unable to read header from stream."]];
+            }
+            return ![reader hasFailed];
+        }
+
+        header = [[NSMutableArray alloc] initWithCapacity:[names count]];
+        for (id name in names) {
+            RASqliteColumn *column = [name isKindOfClass:[NSString class]] ? columns[name] : nil;
+            if (!column) {
+                NSString *message = RASqliteSF(@"Column `%@` is not defined for table `%@`.", name, table);
+                RASqliteErrorLog(@"%@", message);
+
+                [self setError:[NSError code:RASqliteErrorStream message:message]];
+                return NO;
+            }
+            [header addObject:column];
+        }
+    }
+
+    BOOL imported = YES;
+    BOOL failed = NO;
+    NSMutableArray *chunk = [[NSMutableArray alloc] initWithCapacity:RASqliteImportBatchSize];
+
+    while (imported) {
+        @autoreleasepool {
+            NSArray *row = [self readRowFromReader:reader
+                                            format:format
+                                             table:table
+                                           columns:columns
+                                            header:header
+                                           queries:queries
+                                            failed:&failed];
+            if (row) {
+                [chunk addObject:row];
+            } else if (failed) {
+                imported = NO;
+                break;
+            }
+
+            // Each chunk is dispatched separately, i.e. other queries do not
+            // have to wait for the whole stream to be imported.
+            if ([chunk count] == RASqliteImportBatchSize || (!row && [chunk count] > 0)) {
+                imported = [self importChunk:chunk intoTable:table];
+                [chunk removeAllObjects];
+            }
+
+            if (!row) {
+                break;
+            }
+        }
+    }
+
+    if (imported && [reader hasFailed]) {
+        NSString *message = RASqliteSF(@"Unable to read from stream: %@", [[stream streamError] localizedDescription]);
+        RASqliteErrorLog(@"%@", message);
+
+        [self setError:[NSError code:RASqliteErrorStream message:message]];
+        imported = NO;
+    }
+
+    return imported;
+}
+
+- (NSArray *)readRowFromReader:(RASqliteStreamReader *)reader format:(RASqliteStreamFormat)format table:(NSString *)table columns:(NSDictionary *)columns header:(NSArray *)header queries:(NSMutableDictionary *)queries failed:(BOOL *)failed {
+    NSArray *rColumns;
+    NSArray *values;
+
+    if (format == RASqliteStreamFormatCSV) {
+        values = [reader nextRecord];
+        if (!values) {
+            return nil;
+        }
+
+        if ([values count] != [header count]) {
+            NSString *message = RASqliteSF(@"Record have %lu fields, expected %lu.", (unsigned long) [values count], (unsigned long) [header count]);
+            RASqliteErrorLog(@"%@", message);
+
+            [self setError:[NSError code:RASqliteErrorStream message:message]];
+            *failed = YES;
+            return nil;
+        }
+        rColumns = header;
+    } else {
+        NSData *line;
+        do {
+            line = [reader nextLine];
+        } while (line && [line length] == 0);
+
+        if (!line) {
+            return nil;
+        }
+
+        id object = [NSJSONSerialization JSONObjectWithData:line options:0 error:nil];
+        if (![object isKindOfClass:[NSDictionary class]]) {
+            NSString *message = @"Line is not a valid JSON object.";
+            RASqliteErrorLog(@"%@", message);
+
+            [self setError:[NSError code:RASqliteErrorStream message:message]];
+            *failed = YES;
+            return nil;
+        }
+
+        // Sort the keys, i.e. objects with the same keys share the query.
+        NSArray *keys = [[object allKeys] sortedArrayUsingSelector:@selector(compare:)];
+        NSMutableArray *mColumns = [[NSMutableArray alloc] initWithCapacity:[keys count]];
+        NSMutableArray *mValues = [[NSMutableArray alloc] initWithCapacity:[keys count]];
+
+        for (NSString *key in keys) {
+            RASqliteColumn *column = columns[key];
+            if (!column) {
+                NSString *message = RASqliteSF(@"Column `%@` is not defined for table `%@`.", key, table);
+                RASqliteErrorLog(@"%@", message);
+
+                [self setError:[NSError code:RASqliteErrorStream message:message]];
+                *failed = YES;
+                return nil;
+            }
+
+            [mColumns addObject:column];
+            [mValues addObject:object[key]];
+        }
+
+        rColumns = mColumns;
+        values = mValues;
+        header = keys;
+    }
+
+    NSMutableArray *params = [[NSMutableArray alloc] initWithCapacity:[values count]];
+    for (NSUInteger index = 0; index < [values count]; index++) {
+        RASqliteColumn *column = rColumns[index];
+
+        id value = RASqliteImportValue(values[index], column);
+        if (!value) {
+            NSString *message = RASqliteSF(@"Unable to convert value for column `%@`.", [column name]);
+            RASqliteErrorLog(@"%@", message);
+
+            [self setError:[NSError code:RASqliteErrorStream message:message]];
+            *failed = YES;
+            return nil;
+        }
+        [params addObject:[column bindableValue:value]];
+    }
+
+    NSString *query = queries[header];
+    if (!query) {
+        query = RASqliteImportQuery(table, rColumns);
+        queries[header] = query;
+    }
+
+    return @[query, params];
+}
+
+- (BOOL)importChunk:(NSArray *)rows intoTable:(NSString *)table {
+    BOOL __block imported = NO;
+
+    [self queueWithBlock:^(RASqlite *db) {
+        // Using a savepoint instead of a transaction, since the import might
+        // be executed from within an already active transaction.
+        if (![db execute:@"SAVEPOINT rasqlite_import"]) {
+            return;
+        }
+
+        imported = YES;
+        for (NSArray *row in rows) {
+            if (![db executeCached:row[0] withParams:row[1]]) {
+                imported = NO;
+                break;
+            }
+        }
+
+        if (!imported) {
+            RASqliteErrorLog(@"Unable to import rows into `%@`, rolling back chunk.", table);
+            [db execute:@"ROLLBACK TO SAVEPOINT rasqlite_import"];
+        }
+        [db execute:@"RELEASE SAVEPOINT rasqlite_import"];
+    }];
+
+    return imported;
+}
+
+@end
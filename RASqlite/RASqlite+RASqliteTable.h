@@ -9,6 +9,14 @@
 #import "RASqlite.h"
 #import "RASqliteTableDelegate.h"
 
+/**
+ Block for reporting the progress of a table migration.
+
+ @param copied Number of rows that have been copied.
+ @param total Total number of rows within the table.
+ */
+typedef void (^RASqliteMigrationProgress)(NSUInteger copied, NSUInteger total);
+
 @interface RASqlite (RASqliteTable) <RASqliteTableDelegate>
 
 /**
@@ -17,9 +25,29 @@
  @return `YES` if database structure is as defined, otherwise `NO`.
 
  @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ The fingerprint for the defined structure is stored within the database, i.e.
+ `PRAGMA user_version`, once the structure have been verified. If
+ the stored fingerprint matches the defined structure the per table check is
+ skipped. Otherwise, the structure for every table is retrieved with a single
+ query against `sqlite_master`.
  */
 - (BOOL)check;
 
+/**
+ Calculate the fingerprint for the defined database structure.
+
+ @return Fingerprint for the structure, always a positive non-zero value.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ The fingerprint is calculated from the table names and column definitions, i.e.
+ any change to the structure will produce a different fingerprint.
+ */
+- (int32_t)structureFingerprint;
+
 /**
  Check structure for database table.
 
@@ -45,6 +73,61 @@
  */
 - (BOOL)checkTable:(NSString *)table withColumns:(NSArray *)columns status:(RASqliteTableCheckStatus **)status;
 
+/**
+ Migrate the database structure, while preserving the table data.
+
+ @return `YES` if database structure have been migrated, otherwise `NO`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ If the database instance implements the `migrationOfTable:didCopyRows:ofTotal:`
+ delegate method it will receive the progress for tables being rebuilt.
+ */
+- (BOOL)migrate;
+
+/**
+ Migrate the table structure, while preserving the table data.
+
+ @param table Name of the table to migrate.
+ @param columns Array with column definitions.
+
+ @return `YES` if table structure have been migrated, otherwise `NO`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (BOOL)migrateTable:(NSString *)table withColumns:(NSArray *)columns;
+
+/**
+ Migrate the table structure, while preserving the table data.
+
+ @param table Name of the table to migrate.
+ @param columns Array with column definitions.
+ @param progress Block receiving the progress while the table data is copied, can be `nil`.
+
+ @return `YES` if table structure have been migrated, otherwise `NO`.
+
+ @code
+ [db migrateTable:@"user" withColumns:columns progress:^(NSUInteger copied, NSUInteger total) {
+    // Report the progress for the migration.
+ }];
+ @endcode
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ If the table do not exist it will be created. If the defined columns only
+ append columns to the table, the columns are added with `ALTER TABLE`. Otherwise,
+ the table is rebuilt, i.e. a new table is created and the rows for the columns
+ available in both structures are copied before the tables are swapped and the
+ indexes and triggers are recreated.
+
+ @par
+ The migration is executed within a savepoint, i.e. it's safe to call from within
+ a transaction and if the migration fails every change is rolled back.
+ */
+- (BOOL)migrateTable:(NSString *)table withColumns:(NSArray *)columns progress:(RASqliteMigrationProgress)progress;
+
 /**
  Create the database structure.
 
@@ -77,4 +160,105 @@
  */
 - (BOOL)deleteTable:(NSString *)table;
 
+/**
+ Insert or update the rows, based on the primary key of the table structure.
+
+ @param rows Array with a dictionary for each row, keyed by column name.
+ @param table Name of the table, have to be defined within the structure.
+ @param inserted Number of inserted rows, can be `NULL`.
+ @param updated Number of updated rows, can be `NULL`.
+
+ @return `YES` if every row have been inserted or updated, otherwise `NO`.
+
+ @code
+ NSUInteger inserted, updated;
+ [db upsertRows:@[@{@"id": @1, @"name": @"foo"}, @{@"id": @2, @"name": @"bar"}]
+      intoTable:@"user"
+       inserted:&inserted
+        updated:&updated];
+ @endcode
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ One `INSERT ... ON CONFLICT DO UPDATE` query is built for each distinct set of
+ columns within the rows, and its statement is reused for every row with the
+ same set of columns. Only the columns within the row are updated, and keys not
+ defined within the structure are ignored. Requires SQLite 3.24, or later.
+
+ @par
+ The rows are upserted in chunks, each within a savepoint. If a row fails, the
+ chunk is rolled back while the previous chunks are kept, unless the method is
+ called from within a transaction that is rolled back.
+ */
+- (BOOL)upsertRows:(NSArray *)rows intoTable:(NSString *)table inserted:(NSUInteger *)inserted updated:(NSUInteger *)updated;
+
+/**
+ Insert or update the rows, based on the primary key of the table structure.
+
+ @param rows Array with a dictionary for each row, keyed by column name.
+ @param table Name of the table, have to be defined within the structure.
+
+ @return `YES` if every row have been inserted or updated, otherwise `NO`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (BOOL)upsertRows:(NSArray *)rows intoTable:(NSString *)table;
+
+/**
+ Search the full-text table for text entered by the user, with the hits ranked by relevance.
+
+ @param text Text entered by the user, e.g. `tob raa` or `raatiniemi@gmail.com`.
+ @param table Name of the full-text table, have to be defined within the structure.
+ @param limit Maximum number of hits.
+
+ @return Array with the hits, empty if the text do not contain any terms, or `nil` if an error occurred.
+
+ @code
+ NSArray *hits = [db search:@"raa" inTable:@"user_search" limit:10];
+ @endcode
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @throws NSException If the table is not defined as a full-text table within the structure.
+
+ @note
+ The text is split into terms on whitespace, and each term is quoted and
+ matched as a prefix, i.e. every term have to match. Characters with special
+ meaning within the FTS5 query syntax, e.g. `"`, `-`, and `@`, are matched as
+ text. Use `searchWithExpression:inTable:limit:` for the FTS5 query syntax.
+
+ @par
+ The hits are the same as for `searchWithExpression:inTable:limit:`.
+ */
+- (NSArray *)search:(NSString *)text inTable:(NSString *)table limit:(NSUInteger)limit;
+
+/**
+ Search the full-text table with an FTS5 query expression, with the hits ranked by relevance.
+
+ @param query Full-text query, using the FTS5 query syntax, e.g. `tob* OR rai*`.
+ @param table Name of the full-text table, have to be defined within the structure.
+ @param limit Maximum number of hits.
+
+ @return Array with the hits, or `nil` if an error occurred, e.g. for invalid syntax.
+
+ @code
+ NSArray *hits = [db searchWithExpression:@"name:rai*" inTable:@"user_search" limit:10];
+ @endcode
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @throws NSException If the table is not defined as a full-text table within the structure.
+
+ @note
+ Each hit contain the `rowid`, the indexed columns, the `bm25` score as `rank`,
+ and a `snippet` with the matching terms highlighted with `<b>` and `</b>`. A
+ lower rank is a better match, i.e. the best hit comes first.
+
+ @par
+ The statement for the query is cached, i.e. repeated searches, e.g. while the
+ user is typing, only have to bind the parameters.
+ */
+- (NSArray *)searchWithExpression:(NSString *)query inTable:(NSString *)table limit:(NSUInteger)limit;
+
 @end
\ No newline at end of file
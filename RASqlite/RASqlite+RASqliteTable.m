@@ -7,6 +7,7 @@
 //
 
 #import "RASqlite+RASqliteTable.h"
+#import "RASqlite+RASqliteStatement.h"
 
 // -- -- Exception
 
@@ -19,143 +20,1521 @@ static NSString *RASqliteCheckTableException = @"Check table";
 /// Exception name for issues with table removal.
 static NSString *RASqliteRemoveTableException = @"Remove table";
 
+/// Exception name for issues with full-text search.
+static NSString *RASqliteSearchException = @"Search table";
+
+/// Exception name for issues with upserting rows.
+static NSString *RASqliteUpsertException = @"Upsert rows";
+
+/// Number of rows copied within each batch while rebuilding a table.
+static const NSUInteger RASqliteMigrationBatchSize = 10000;
+
+/// Number of rows upserted within each savepoint.
+static const NSUInteger RASqliteUpsertBatchSize = 1000;
+
+/// Id used for detecting whether the upsert inserted a row.
+static const int64_t RASqliteUpsertSentinelId = INT64_MIN;
+
+/// Query for retrieving the column structure for every table with a single query.
+static NSString *RASqliteTableInfoQuery = @"SELECT m.name AS tbl_name, p.name AS name, p.type AS type, "
+        "p.\"notnull\" AS \"notnull\", p.dflt_value AS dflt_value, p.pk AS pk "
+        "FROM sqlite_master AS m JOIN pragma_table_info(m.name) AS p "
+        "WHERE m.type = 'table' ORDER BY m.name, p.cid";
+
+/// Query for retrieving the table and index definitions with a single query.
+static NSString *RASqliteDefinitionListQuery = @"SELECT tbl_name, name, sql FROM sqlite_master "
+        "WHERE type IN ('table', 'index') AND sql IS NOT NULL";
+
+/**
+ Retrieve the column definitions from the table structure.
+
+ @param structure Array with column, index, and table option definitions.
+
+ @return Array with the column definitions.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static NSArray *RASqliteColumnsForStructure(NSArray *structure) {
+    NSMutableArray *columns = [[NSMutableArray alloc] initWithCapacity:[structure count]];
+    for (id item in structure) {
+        if ([item isKindOfClass:[RASqliteIndex class]] || [item isKindOfClass:[RASqliteTableOptions class]] ||
+                [item isKindOfClass:[RASqliteFullTextOptions class]]) {
+            continue;
+        }
+        [columns addObject:item];
+    }
+
+    return columns;
+}
+
+/**
+ Retrieve the index definitions from the table structure.
+
+ @param structure Array with column and index definitions.
+
+ @return Array with the index definitions.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static NSArray *RASqliteIndexesForStructure(NSArray *structure) {
+    NSMutableArray *indexes = [[NSMutableArray alloc] init];
+    for (id item in structure) {
+        if ([item isKindOfClass:[RASqliteIndex class]]) {
+            [indexes addObject:item];
+        }
+    }
+
+    return indexes;
+}
+
+/**
+ Retrieve the table options from the table structure.
+
+ @param structure Array with column, index, and table option definitions.
+
+ @return Table options, or `nil` if none have been defined.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static RASqliteTableOptions *RASqliteOptionsForStructure(NSArray *structure) {
+    for (id item in structure) {
+        if ([item isKindOfClass:[RASqliteTableOptions class]]) {
+            return item;
+        }
+    }
+
+    return nil;
+}
+
+/**
+ Retrieve the full-text options from the table structure.
+
+ @param structure Array with column, index, and table option definitions.
+
+ @return Full-text options, or `nil` if the table is not a full-text table.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static RASqliteFullTextOptions *RASqliteFullTextOptionsForStructure(NSArray *structure) {
+    for (id item in structure) {
+        if ([item isKindOfClass:[RASqliteFullTextOptions class]]) {
+            return item;
+        }
+    }
+
+    return nil;
+}
+
+/**
+ Build the full-text query for the text entered by the user.
+
+ @param text Text entered by the user, e.g. a name or an email address.
+
+ @return Full-text query, or `nil` if the text do not contain any terms.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ Each term is quoted as an FTS5 string, i.e. characters with special meaning
+ within the query syntax are matched as text, and the terms are matched as
+ prefixes, e.g. `o'neil-smith` is queried as `"o'neil-smith"*`.
+ */
+static NSString *RASqliteSearchQuery(NSString *text) {
+    NSCharacterSet *whitespace = [NSCharacterSet whitespaceAndNewlineCharacterSet];
+
+    NSMutableArray *terms = [[NSMutableArray alloc] init];
+    for (NSString *term in [text componentsSeparatedByCharactersInSet:whitespace]) {
+        if ([term length] == 0) {
+            continue;
+        }
+
+        NSString *quoted = [term stringByReplacingOccurrencesOfString:@"\"" withString:@"\"\""];
+        [terms addObject:RASqliteSF(@"\"%@\"*", quoted)];
+    }
+
+    return [terms count] > 0 ? [terms componentsJoinedByString:@" "] : nil;
+}
+
+/**
+ Retrieve the names of the columns from the table structure.
+
+ @param structure Array with column, index, and table option definitions.
+
+ @return Array with the column names, in order.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static NSArray *RASqliteColumnNamesForStructure(NSArray *structure) {
+    return [RASqliteColumnsForStructure(structure) valueForKey:@"name"];
+}
+
+/**
+ Retrieve the table names from the structure, in creation order.
+
+ @param tables Structure with table names and their column definitions.
+
+ @return Array with the table names.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ Full-text tables are ordered last, since the triggers for external content
+ can only be created once the content table exists.
+ */
+static NSArray *RASqliteTableNamesForStructure(NSDictionary *tables) {
+    NSMutableArray *names = [[NSMutableArray alloc] initWithCapacity:[tables count]];
+    NSMutableArray *fullText = [[NSMutableArray alloc] init];
+
+    for (NSString *table in tables) {
+        if (RASqliteFullTextOptionsForStructure(tables[table])) {
+            [fullText addObject:table];
+        } else {
+            [names addObject:table];
+        }
+    }
+    [names addObjectsFromArray:fullText];
+
+    return names;
+}
+
+/**
+ Retrieve the names of the triggers syncing a full-text table with its content table.
+
+ @param table Name of the full-text table.
+
+ @return Array with the trigger names.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static NSArray *RASqliteFullTextTriggerNames(NSString *table) {
+    return @[RASqliteSF(@"%@_ai", table), RASqliteSF(@"%@_ad", table), RASqliteSF(@"%@_au", table)];
+}
+
+/**
+ Retrieve the table options from the options clause.
+
+ @param clause Table options clause, e.g. `WITHOUT ROWID, STRICT`.
+
+ @return Table options, with normalized case and whitespace.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static NSSet *RASqliteOptionsForClause(NSString *clause) {
+    NSMutableSet *options = [[NSMutableSet alloc] init];
+
+    NSCharacterSet *whitespace = [NSCharacterSet whitespaceAndNewlineCharacterSet];
+    for (NSString *option in [[clause uppercaseString] componentsSeparatedByString:@","]) {
+        NSArray *words = [[option componentsSeparatedByCharactersInSet:whitespace]
+                filteredArrayUsingPredicate:[NSPredicate predicateWithFormat:@"length > 0"]];
+        if ([words count] > 0) {
+            [options addObject:[words componentsJoinedByString:@" "]];
+        }
+    }
+
+    return options;
+}
+
+/**
+ Retrieve the table options from the create statement of the table.
+
+ @param sql Create statement for the table, from `sqlite_master`.
+
+ @return Table options, e.g. `WITHOUT ROWID` and `STRICT`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static NSSet *RASqliteOptionsForDefinition(NSString *sql) {
+    // The table options follows the closing parenthesis of the column list.
+    NSRange range = [sql rangeOfString:@")" options:NSBackwardsSearch];
+    if (range.location == NSNotFound) {
+        return [NSSet set];
+    }
+
+    return RASqliteOptionsForClause([sql substringFromIndex:NSMaxRange(range)]);
+}
+
+/**
+ Check whether the defined table options match the create statement of the table.
+
+ @param structure Array with column, index, and table option definitions.
+ @param sql Create statement for the table, from `sqlite_master`.
+
+ @return `YES` if the table options match, otherwise `NO`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static BOOL RASqliteOptionsMatchDefinition(NSArray *structure, NSString *sql) {
+    NSSet *options = RASqliteOptionsForClause([RASqliteOptionsForStructure(structure) definition]);
+    return [options isEqualToSet:RASqliteOptionsForDefinition(sql)];
+}
+
+/**
+ Verify that compressed columns are not used where the stored values are compared.
+
+ @param table Name of the table.
+ @param structure Array with column, index, and table option definitions.
+
+ @throws NSException If a compressed column is indexed, within a full-text table, or not a blob within a strict table.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static void RASqliteCheckCompressionForStructure(NSString *table, NSArray *structure) {
+    NSMutableSet *compressed = [[NSMutableSet alloc] init];
+    for (RASqliteColumn *column in RASqliteColumnsForStructure(structure)) {
+        if ([column isKindOfClass:[RASqliteColumn class]] && RASqliteCompressionNone != [column compression]) {
+            [compressed addObject:[column name]];
+        }
+    }
+
+    if ([compressed count] == 0) {
+        return;
+    }
+
+    if (RASqliteFullTextOptionsForStructure(structure)) {
+        [NSException raise:RASqliteColumnConstrainException
+                    format:@"Columns within full-text table `%@` can not be compressed.", table];
+    }
+
+    for (RASqliteIndex *index in RASqliteIndexesForStructure(structure)) {
+        if ([compressed intersectsSet:[NSSet setWithArray:[index columns]]]) {
+            [NSException raise:RASqliteColumnConstrainException
+                        format:@"Compressed columns can not be used within index `%@` for table `%@`.", [index name], table];
+        }
+    }
+
+    // Compressed values are stored as blobs, which strict tables only accept
+    // for columns declared as `BLOB`.
+    if (![RASqliteOptionsForStructure(structure) isStrict]) {
+        return;
+    }
+
+    for (RASqliteColumn *column in RASqliteColumnsForStructure(structure)) {
+        if ([column isKindOfClass:[RASqliteColumn class]] && [compressed containsObject:[column name]]
+                && RASqliteBlob != [column numericType]) {
+            [NSException raise:RASqliteColumnConstrainException
+                        format:@"Compressed column `%@` within strict table `%@` have to be declared as `BLOB`.", [column name], table];
+        }
+    }
+}
+
+/**
+ Build the canonical description for the database structure.
+
+ @param tables Structure with table names and their column definitions.
+
+ @return Canonical description for the structure.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ Tables are sorted by name since the order of a dictionary is not guaranteed,
+ whereas the column order is significant and kept as defined.
+ */
+static NSString *RASqliteStructureDescription(NSDictionary *tables) {
+    NSMutableString *description = [[NSMutableString alloc] init];
+
+    NSArray *names = [[tables allKeys] sortedArrayUsingSelector:@selector(compare:)];
+    for (NSString *table in names) {
+        [description appendFormat:@"%@(", table];
+
+        // The compression is excluded, since it do not affect the stored
+        // structure, i.e. compressed and uncompressed values can be mixed.
+        for (RASqliteColumn *column in RASqliteColumnsForStructure(tables[table])) {
+            [description appendFormat:@"%@ %@ %d%d%d%d %@;",
+                                      [column name],
+                                      [column type],
+                                      [column isPrimaryKey],
+                                      [column isAutoIncrement],
+                                      [column isUnique],
+                                      [column isNullable],
+                                      [column defaultValue]];
+        }
+
+        for (RASqliteIndex *index in RASqliteIndexesForStructure(tables[table])) {
+            [description appendFormat:@"%@;", [index definitionForTable:table]];
+        }
+
+        NSString *options = [RASqliteOptionsForStructure(tables[table]) definition];
+        if ([options length] > 0) {
+            [description appendFormat:@"%@;", options];
+        }
+
+        RASqliteFullTextOptions *fullText = RASqliteFullTextOptionsForStructure(tables[table]);
+        if (fullText) {
+            NSArray *names = RASqliteColumnNamesForStructure(tables[table]);
+            [description appendFormat:@"%@;", [fullText definitionForTable:table columns:names]];
+        }
+        [description appendString:@")"];
+    }
+
+    return description;
+}
+
+/**
+ Build the definition for a column, i.e. name, data type, and constraints.
+
+ @param column Column to build the definition for.
+ @param compositeKey Whether the primary key is defined as a table constraint.
+
+ @return Definition for the column.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static NSString *RASqliteColumnDefinition(RASqliteColumn *column, BOOL compositeKey) {
+    // Start with building the item with the column name and type.
+    NSMutableString *item = [[NSMutableString alloc] init];
+    [item appendFormat:@"%@ %@", [column name], [column type]];
+
+    // Check if the column should be unique.
+    if ([column isUnique]) {
+        [item appendString:@" UNIQUE"];
+    }
+
+    // Handle if the column should be nullable or not.
+    if (![column isNullable]) {
+        [item appendString:@" NOT"];
+    }
+    [item appendString:@" NULL"];
+
+    // Check if the column should be a primary key, composite primary keys are
+    // defined as a table constraint instead.
+    if ([column isPrimaryKey]) {
+        if (compositeKey) {
+            return item;
+        }
+        [item appendString:@" PRIMARY KEY"];
+
+        // Column have to be of type `integer` to use `autoincremental`.
+        if ([column isAutoIncrement] && RASqliteInteger == [column numericType]) {
+            [item appendString:@" AUTOINCREMENT"];
+        }
+    } else {
+        // If the column have a default value available, use it.
+        // Have to check for nil since default value can be @0.
+        if ([column defaultValue] != nil) {
+            [item appendFormat:@" DEFAULT `%@`", [column defaultValue]];
+        }
+    }
+
+    return item;
+}
+
+/**
+ Build the table definition, i.e. the table name followed by the column list.
+
+ @param table Name of the table.
+ @param columns Array with column, index, and table option definitions.
+
+ @return Definition for the table, used with `CREATE TABLE`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static NSString *RASqliteTableDefinition(NSString *table, NSArray *columns) {
+    // The create query will be constructed with a list of items, each
+    // item represent their column name, data type, constraints, etc.
+    NSMutableArray *list = [[NSMutableArray alloc] init];
+    NSMutableArray *keys = [[NSMutableArray alloc] init];
+
+    NSArray *tColumns = RASqliteColumnsForStructure(columns);
+    for (RASqliteColumn *column in tColumns) {
+        // The column have to be of type `RASqliteColumn`.
+        if (![column isKindOfClass:[RASqliteColumn class]]) {
+            [NSException raise:NSInvalidArgumentException
+                        format:@"Column defined for table `%@` is not of type `RASqliteColumn.", table];
+        }
+
+        if ([column isPrimaryKey]) {
+            [keys addObject:[column name]];
+        }
+    }
+
+    // Assemble the columns and data types for the structure.
+    BOOL compositeKey = [keys count] > 1;
+    for (RASqliteColumn *column in tColumns) {
+        [list addObject:RASqliteColumnDefinition(column, compositeKey)];
+    }
+
+    if (compositeKey) {
+        [list addObject:RASqliteSF(@"PRIMARY KEY(%@)", [keys componentsJoinedByString:@", "])];
+    }
+
+    NSString *definition = RASqliteSF(@"%@(%@)", table, [list componentsJoinedByString:@","]);
+
+    NSString *options = [RASqliteOptionsForStructure(columns) definition];
+    if ([options length] > 0) {
+        definition = RASqliteSF(@"%@ %@", definition, options);
+    }
+
+    return definition;
+}
+
+/**
+ Build the upsert query for the columns.
+
+ @param table Name of the table.
+ @param columns Column definitions for the columns within the row, in structure order.
+ @param keys Names of the primary key columns.
+
+ @return Query inserting the row, or updating the columns on conflict.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static NSString *RASqliteUpsertQuery(NSString *table, NSArray *columns, NSArray *keys) {
+    NSMutableArray *names = [[NSMutableArray alloc] initWithCapacity:[columns count]];
+    NSMutableArray *placeholders = [[NSMutableArray alloc] initWithCapacity:[columns count]];
+    NSMutableArray *assignments = [[NSMutableArray alloc] initWithCapacity:[columns count]];
+
+    for (RASqliteColumn *column in columns) {
+        [names addObject:[column name]];
+        [placeholders addObject:@"?"];
+
+        if (![keys containsObject:[column name]]) {
+            [assignments addObject:RASqliteSF(@"%@ = excluded.%@", [column name], [column name])];
+        }
+    }
+
+    // If the row only contain the primary key there is nothing to update.
+    NSString *action = @"DO NOTHING";
+    if ([assignments count] > 0) {
+        action = RASqliteSF(@"DO UPDATE SET %@", [assignments componentsJoinedByString:@", "]);
+    }
+
+    return RASqliteSF(@"INSERT INTO %@(%@) VALUES(%@) ON CONFLICT(%@) %@",
+            table,
+            [names componentsJoinedByString:@", "],
+            [placeholders componentsJoinedByString:@", "],
+            [keys componentsJoinedByString:@", "],
+            action);
+}
+
+@interface RASqlite (RASqliteTablePrivate)
+
+/**
+ Retrieve the stored structure fingerprint.
+
+ @return Stored fingerprint, or zero if none have been stored.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (int32_t)storedStructureFingerprint;
+
+/**
+ Store the structure fingerprint.
+
+ @param fingerprint Fingerprint to store.
+
+ @return `YES` if fingerprint was stored, otherwise `NO`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (BOOL)storeStructureFingerprint:(int32_t)fingerprint;
+
+/**
+ Retrieve the column structure for every table within the database.
+
+ @return Table names with their `PRAGMA table_info` rows, or `nil` on failure.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (NSDictionary *)fetchTableStructure;
+
+/**
+ Retrieve the table and index definitions for every table within the database.
+
+ @return Table names with their table and index names and definitions, or `nil` on failure.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (NSDictionary *)fetchDefinitions;
+
+/**
+ Match the table options and index definitions against the table.
+
+ @param table Name of the table to match.
+ @param columns Array with column, index, and table option definitions.
+ @param definitions Table and index names with their definitions from `sqlite_master`.
+ @param status Status of the table.
+
+ @return `YES` if the table options match and the defined indexes exists, otherwise `NO`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ Only the defined indexes are verified, i.e. indexes created outside of the
+ structure are ignored.
+ */
+- (BOOL)matchDefinitionsForTable:(NSString *)table withColumns:(NSArray *)columns definitions:(NSDictionary *)definitions status:(RASqliteTableCheckStatus **)status;
+
+/**
+ Create the defined indexes that are missing, or differ, for the table.
+
+ @param table Name of the table.
+ @param columns Array with column and index definitions.
+
+ @return `YES` if the indexes are as defined, otherwise `NO`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (BOOL)createIndexesForTable:(NSString *)table withColumns:(NSArray *)columns;
+
+/**
+ Match the column definitions against the table structure.
+
+ @param table Name of the table to match.
+ @param columns Array with column definitions.
+ @param tColumns Rows from `PRAGMA table_info` for the table.
+ @param status Status of the table.
+
+ @return `YES` if table structure is as defined, otherwise `NO`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (BOOL)matchTable:(NSString *)table withColumns:(NSArray *)columns tableColumns:(NSArray *)tColumns status:(RASqliteTableCheckStatus **)status;
+
+/**
+ Retrieve the columns that can be appended to the table with `ALTER TABLE`.
+
+ @param table Name of the table.
+ @param columns Array with column definitions.
+ @param tColumns Rows from `PRAGMA table_info` for the table.
+
+ @return Columns to append, or `nil` if the table have to be rebuilt.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (NSArray *)appendableColumnsForTable:(NSString *)table withColumns:(NSArray *)columns tableColumns:(NSArray *)tColumns;
+
+/**
+ Rebuild the table with the column definitions, preserving the table data.
+
+ @param table Name of the table.
+ @param columns Array with column definitions.
+ @param tColumns Rows from `PRAGMA table_info` for the table.
+ @param progress Block receiving the progress while the table data is copied.
+
+ @return `YES` if the table have been rebuilt, otherwise `NO`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (BOOL)rebuildTable:(NSString *)table withColumns:(NSArray *)columns tableColumns:(NSArray *)tColumns progress:(RASqliteMigrationProgress)progress;
+
+/**
+ Copy the rows between the tables in batches, ordered by rowid.
+
+ @param table Name of the table to copy from.
+ @param destination Name of the table to copy to.
+ @param list Comma separated list with the columns to copy.
+ @param rowid Whether both of the tables have a rowid.
+ @param progress Block receiving the progress after each batch.
+
+ @return `YES` if the rows have been copied, otherwise `NO`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ Tables created `WITHOUT ROWID` can not be copied in batches, the rows are
+ instead copied with a single statement.
+ */
+- (BOOL)copyRowsFromTable:(NSString *)table toTable:(NSString *)destination columns:(NSString *)list rowid:(BOOL)rowid progress:(RASqliteMigrationProgress)progress;
+
+/**
+ Create the full-text table, together with the triggers for the content table.
+
+ @param table Name of the full-text table.
+ @param columns Array with column definitions and full-text options.
+
+ @return `YES` if the table have been created, otherwise `NO`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ The index for an external content table is built from the existing rows when
+ the table is created.
+ */
+- (BOOL)createFullTextTable:(NSString *)table withColumns:(NSArray *)columns;
+
+/**
+ Check whether the triggers for the full-text table match the definitions.
+
+ @param table Name of the full-text table.
+ @param columns Array with column definitions and full-text options.
+
+ @return `YES` if the triggers match, otherwise `NO`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (BOOL)matchTriggersForFullTextTable:(NSString *)table withColumns:(NSArray *)columns;
+
+/**
+ Rebuild the full-text table with the defined structure.
+
+ @param table Name of the full-text table.
+ @param columns Array with column definitions and full-text options.
+ @param tColumns Column definitions from the existing table.
+
+ @return `YES` if the table have been rebuilt, otherwise `NO`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ Virtual tables can not be altered, i.e. the table is always recreated. Content
+ stored within the table is copied, while an external content index is rebuilt
+ from the content table.
+ */
+- (BOOL)rebuildFullTextTable:(NSString *)table withColumns:(NSArray *)columns tableColumns:(NSArray *)tColumns;
+
+/**
+ Upsert chunk of rows within a savepoint.
+
+ @param rows Rows to upsert.
+ @param table Name of the table.
+ @param columns Column definitions for the table.
+ @param keys Names of the primary key columns.
+ @param queries Upsert queries and their columns, keyed by the indexes of the columns within the row.
+ @param rowid Whether the table have a rowid, i.e. inserts can be detected by the last insert id.
+ @param inserted Incremented with the number of inserted rows.
+ @param updated Incremented with the number of updated rows.
+
+ @return `YES` if every row within the chunk have been upserted, otherwise `NO`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (BOOL)upsertChunk:(NSArray *)rows intoTable:(NSString *)table columns:(NSArray *)columns keys:(NSArray *)keys queries:(NSMutableDictionary *)queries rowid:(BOOL)rowid inserted:(NSUInteger *)inserted updated:(NSUInteger *)updated;
+
+@end
+
 @implementation RASqlite (RASqliteTable)
 
-- (BOOL)check {
-    // Keep track if whether the structure for the table is valid.
-    //
-    // The default value have to be `YES`, otherwise we risk of deleting the
-    // table when something is wrong with the database instance.
-    BOOL __block valid = YES;
+- (BOOL)check {
+    // Keep track if whether the structure for the table is valid.
+    //
+    // The default value have to be `YES`, otherwise we risk of deleting the
+    // table when something is wrong with the database instance.
+    BOOL __block valid = YES;
+
+    [self queueWithBlock:^(RASqlite *db) {
+        NSDictionary *tables = [db structure];
+        if (!tables) {
+            // Raise an exception, no structure have been supplied.
+            [NSException raise:RASqliteCheckDatabaseException
+                        format:@"Unable to check database structure, none has been supplied."];
+        }
+
+        // If the stored fingerprint matches the defined structure there is no
+        // need to introspect the tables, nothing have changed since the last
+        // successful check.
+        int32_t fingerprint = [db structureFingerprint];
+        BOOL unchanged = fingerprint == [db storedStructureFingerprint];
+
+        // Retrieve the structure for every table with a single query, instead
+        // of one `PRAGMA table_info` query for each of the tables.
+        NSDictionary *schema;
+        NSDictionary *definitions;
+        if (!unchanged) {
+            schema = [db fetchTableStructure];
+            definitions = [db fetchDefinitions];
+        }
+
+        // Checking whether the database instance have implemented
+        // methods for before and after table check handling.
+        BOOL isBeforeAvailable = [db respondsToSelector:@selector(beforeTableCheck:)];
+        BOOL isAfterAvailable = [db respondsToSelector:@selector(afterTableCheck:withStatus:)];
+
+        // If any of the tables is skipped we are not able to tell whether the
+        // structure is valid, i.e. the fingerprint should not be stored.
+        BOOL skipped = NO;
+
+        RASqliteTableCheckStatus *status;
+        for (NSString *table in tables) {
+            // If the before check method is available and it returns
+            // `NO` we should move on to the next table.
+            if (isBeforeAvailable && ![db beforeTableCheck:table]) {
+                skipped = YES;
+                continue;
+            }
+
+            status = (RASqliteTableCheckStatus *) RASqliteTableCheckStatusClean;
+            if (schema && definitions) {
+                if (![db matchTable:table withColumns:tables[table] tableColumns:schema[table] status:&status]) {
+                    valid = NO;
+                } else if (![db matchDefinitionsForTable:table withColumns:tables[table] definitions:definitions[table] status:&status]) {
+                    valid = NO;
+                }
+            } else if (!unchanged) {
+                // The structure could not be retrieved with a single query,
+                // fall back to checking each of the tables individually.
+                if (![db checkTable:table withColumns:tables[table] status:&status]) {
+                    valid = NO;
+                }
+            }
+
+            // If the after check method is available we have to execute it,
+            // sending the current status of the table.
+            // This way we can determined what to do about the changes (if any).
+            if (isAfterAvailable) {
+                [db afterTableCheck:table withStatus:status];
+            }
+        }
+
+        if (!unchanged && valid && !skipped) {
+            [db storeStructureFingerprint:fingerprint];
+        }
+    }];
+
+    return valid;
+}
+
+- (int32_t)structureFingerprint {
+    NSDictionary *tables = [self structure];
+    if (!tables) {
+        // Raise an exception, no structure have been supplied.
+        [NSException raise:RASqliteCheckDatabaseException
+                    format:@"Unable to calculate structure fingerprint, none has been supplied."];
+    }
+
+    // Calculate the 32-bit FNV-1a hash for the structure description.
+    const char *bytes = [RASqliteStructureDescription(tables) UTF8String];
+    uint32_t hash = 2166136261u;
+    while (*bytes) {
+        hash ^= (uint8_t) *bytes++;
+        hash *= 16777619u;
+    }
+
+    // The `user_version` is a signed integer and zero is the default value,
+    // i.e. the fingerprint have to be positive and non-zero.
+    int32_t fingerprint = (int32_t) (hash & 0x7fffffff);
+    return fingerprint ? fingerprint : 1;
+}
+
+- (int32_t)storedStructureFingerprint {
+    NSDictionary *row = [self fetchRow:@"PRAGMA user_version"];
+
+    id version = [row getColumn:@"user_version"];
+    return [version isKindOfClass:[NSNumber class]] ? [version intValue] : 0;
+}
+
+- (BOOL)storeStructureFingerprint:(int32_t)fingerprint {
+    BOOL stored = [self execute:RASqliteSF(@"PRAGMA user_version = %d", fingerprint)];
+    if (stored) {
+        RASqliteDebugLog(@"Structure fingerprint `%d` have been stored.", fingerprint);
+    }
+
+    return stored;
+}
+
+- (NSDictionary *)fetchTableStructure {
+    NSDictionary __block *schema;
+
+    [self queueWithBlock:^(RASqlite *db) {
+        // The table valued `pragma_table_info` function is not available in
+        // older versions of SQLite, which will cause a prepare error.
+        NSError *error = [db error];
+        NSArray *rows = [db fetch:RASqliteTableInfoQuery];
+        if (!rows) {
+            RASqliteDebugLog(@"Unable to retrieve table structure with a single query.");
+            [db setError:error];
+            return;
+        }
+
+        NSMutableDictionary *tables = [[NSMutableDictionary alloc] init];
+        for (NSDictionary *row in rows) {
+            NSString *table = [row getColumn:@"tbl_name"];
+
+            NSMutableArray *tColumns = tables[table];
+            if (!tColumns) {
+                tColumns = [[NSMutableArray alloc] init];
+                tables[table] = tColumns;
+            }
+            [tColumns addObject:row];
+        }
+        schema = tables;
+    }];
+
+    return schema;
+}
+
+- (NSDictionary *)fetchDefinitions {
+    NSArray *rows = [self fetch:RASqliteDefinitionListQuery];
+    if (!rows) {
+        return nil;
+    }
+
+    NSMutableDictionary *tables = [[NSMutableDictionary alloc] init];
+    for (NSDictionary *row in rows) {
+        NSString *table = [row getColumn:@"tbl_name"];
+
+        NSMutableDictionary *definitions = tables[table];
+        if (!definitions) {
+            definitions = [[NSMutableDictionary alloc] init];
+            tables[table] = definitions;
+        }
+        definitions[[row getColumn:@"name"]] = [row getColumn:@"sql"];
+    }
+
+    return tables;
+}
+
+- (BOOL)checkTable:(NSString *)table withColumns:(NSArray *)columns {
+    RASqliteTableCheckStatus *status;
+
+    return [self checkTable:table withColumns:columns status:&status];
+}
+
+- (BOOL)checkTable:(NSString *)table withColumns:(NSArray *)columns status:(RASqliteTableCheckStatus **)status {
+    if (!table) {
+        // Raise an exception, no valid table name.
+        [NSException raise:NSInvalidArgumentException
+                    format:@"Unable to check table without valid name."];
+    }
+
+    if (!columns) {
+        // Raise an exception, no defined columns.
+        [NSException raise:NSInvalidArgumentException
+                    format:@"Unable to check table without defined columns."];
+    }
+
+    RASqliteCheckCompressionForStructure(table, columns);
+
+    // Keeps track on whether the structure for the table is valid.
+    //
+    // The default value have to be `YES`, otherwise we risk of deleting the
+    // table when something is wrong with the database instance.
+    BOOL __block valid = YES;
+
+    [self queueWithBlock:^(RASqlite *db) {
+        // Check whether the defined columns and the table columns match.
+        NSArray *tColumns = [db fetch:RASqliteSF(@"PRAGMA table_info(%@)", table)];
+        valid = [db matchTable:table withColumns:columns tableColumns:tColumns status:status];
+        if (!valid) {
+            return;
+        }
+
+        NSDictionary *definitions = [db fetchDefinitions];
+        valid = [db matchDefinitionsForTable:table withColumns:columns definitions:definitions[table] status:status];
+    }];
+
+    return valid;
+}
+
+- (BOOL)matchTable:(NSString *)table withColumns:(NSArray *)columns tableColumns:(NSArray *)tColumns status:(RASqliteTableCheckStatus **)status {
+    // Columns within full-text tables do not have any type or constraints.
+    BOOL fullText = RASqliteFullTextOptionsForStructure(columns) != nil;
+
+    // Indexes are matched separately against `sqlite_master`.
+    columns = RASqliteColumnsForStructure(columns);
+
+    if (0 == [tColumns count]) {
+        RASqliteDebugLog(@"Table `%@` do not exist with any structure within the database.", table);
+        *status = (RASqliteTableCheckStatus *) RASqliteTableCheckStatusNew;
+        return NO;
+    }
+
+    if ([tColumns count] != [columns count]) {
+        RASqliteDebugLog(@"Number of specified columns for table `%@` do not matched the defined table count.", table);
+        *status = (RASqliteTableCheckStatus *) RASqliteTableCheckStatusModified;
+        return NO;
+    }
+
+    BOOL valid = YES;
+
+    // Unique column constraints are backed by automatic indexes, with the
+    // origin `u`, and only covers a single column.
+    NSMutableSet *unique = [[NSMutableSet alloc] init];
+    if (!fullText) {
+        for (NSDictionary *tIndex in [self fetch:RASqliteSF(@"PRAGMA index_list(%@)", table)]) {
+            if (![[tIndex getColumn:@"origin"] isEqual:@"u"]) {
+                continue;
+            }
+
+            NSArray *tIndexColumns = [self fetch:RASqliteSF(@"PRAGMA index_info(%@)", [tIndex getColumn:@"name"])];
+            if ([tIndexColumns count] == 1) {
+                [unique addObject:[tIndexColumns[0] getColumn:@"name"]];
+            }
+        }
+    }
+
+    unsigned int index = 0;
+    int key = 0;
+    BOOL autoIncrement = NO;
+    for (RASqliteColumn *column in columns) {
+        // The column have to be of type `RASqliteColumn`.
+        if (![column isKindOfClass:[RASqliteColumn class]]) {
+            [NSException raise:NSInvalidArgumentException
+                        format:@"Column defined for table `%@` at index `%i` is not of type `RASqliteColumn.", table, index];
+        }
+
+        // Retrieve the column definition from the table.
+        NSDictionary *tColumn = tColumns[index];
+
+        // Check that the column name matches.
+        if (![[tColumn getColumn:@"name"] isEqualToString:[column name]]) {
+            RASqliteDebugLog(@"Column name at index `%i` do not match column given for structure `%@`.", index, table);
+            valid = NO;
+            break;
+        }
+
+        if (fullText) {
+            index++;
+            continue;
+        }
+
+        // Check that the column type matches.
+        if (![[tColumn getColumn:@"type"] isEqualToString:[column type]]) {
+            RASqliteDebugLog(@"Column type at index `%i` do not match column given for structure `%@`.", index, table);
+            valid = NO;
+            break;
+        }
+
+        // Check that whether the column matches the primary key setting, the
+        // value is the position of the column within composite primary keys.
+        if ([column isPrimaryKey]) {
+            key++;
+        }
+
+        if (([column isPrimaryKey] ? key : 0) != [[tColumn getColumn:@"pk"] intValue]) {
+            RASqliteDebugLog(@"Column primary key option at index `%i` do not match column given for structure `%@`.", index, table);
+            valid = NO;
+            break;
+        }
+
+        // Check that whether the column matches the nullable setting.
+        if ([column isNullable] == [[tColumn getColumn:@"notnull"] boolValue]) {
+            RASqliteDebugLog(@"Column nullable option at index `%i` do not match column given for structure `%@`.", index, table);
+            valid = NO;
+            break;
+        }
+
+        // The default value is stored as written within the definition, and
+        // is not defined for primary key columns.
+        id defaultValue = [NSNull null];
+        if (![column isPrimaryKey] && [column defaultValue] != nil) {
+            defaultValue = RASqliteSF(@"`%@`", [column defaultValue]);
+        }
+
+        if (![defaultValue isEqual:[tColumn getColumn:@"dflt_value"]]) {
+            RASqliteDebugLog(@"Column default value at index `%i` do not match column given for structure `%@`.", index, table);
+            valid = NO;
+            break;
+        }
+
+        if ([column isUnique] != [unique containsObject:[column name]]) {
+            RASqliteDebugLog(@"Column unique option at index `%i` do not match column given for structure `%@`.", index, table);
+            valid = NO;
+            break;
+        }
+
+        if ([column isPrimaryKey] && [column isAutoIncrement] && RASqliteInteger == [column numericType]) {
+            autoIncrement = YES;
+        }
+
+        index++;
+    }
+
+    // Auto increment is only available for a single integer primary key, and
+    // is only visible within the table definition.
+    if (valid && !fullText) {
+        NSDictionary *row = [self fetchRow:@"SELECT sql FROM sqlite_master WHERE type = 'table' AND name = ?" withParam:table];
+        id definition = [row getColumn:@"sql"];
+        BOOL tAutoIncrement = [definition isKindOfClass:[NSString class]]
+                && [definition rangeOfString:@" AUTOINCREMENT" options:NSCaseInsensitiveSearch].location != NSNotFound;
+
+        if ((autoIncrement && key == 1) != tAutoIncrement) {
+            RASqliteDebugLog(@"Column auto increment option do not match column given for structure `%@`.", table);
+            valid = NO;
+        }
+    }
+
+    if (!valid) {
+        *status = (RASqliteTableCheckStatus *) RASqliteTableCheckStatusModified;
+    }
+
+    return valid;
+}
+
+- (BOOL)matchDefinitionsForTable:(NSString *)table withColumns:(NSArray *)columns definitions:(NSDictionary *)definitions status:(RASqliteTableCheckStatus **)status {
+    RASqliteFullTextOptions *fullText = RASqliteFullTextOptionsForStructure(columns);
+    if (fullText) {
+        NSString *definition = [fullText definitionForTable:table columns:RASqliteColumnNamesForStructure(columns)];
+        if (![definitions[table] isEqualToString:RASqliteSF(@"CREATE VIRTUAL TABLE %@", definition)]) {
+            RASqliteDebugLog(@"Full-text options do not match options given for structure `%@`.", table);
+            *status = (RASqliteTableCheckStatus *) RASqliteTableCheckStatusModified;
+            return NO;
+        }
+
+        if (![self matchTriggersForFullTextTable:table withColumns:columns]) {
+            RASqliteDebugLog(@"Triggers do not match content table given for structure `%@`.", table);
+            *status = (RASqliteTableCheckStatus *) RASqliteTableCheckStatusModified;
+            return NO;
+        }
+
+        return YES;
+    }
+
+    if (!RASqliteOptionsMatchDefinition(columns, definitions[table])) {
+        RASqliteDebugLog(@"Table options do not match options given for structure `%@`.", table);
+        *status = (RASqliteTableCheckStatus *) RASqliteTableCheckStatusModified;
+        return NO;
+    }
+
+    for (RASqliteIndex *index in RASqliteIndexesForStructure(columns)) {
+        NSString *definition = definitions[[index name]];
+        if (!definition) {
+            RASqliteDebugLog(@"Index `%@` do not exist for table `%@`.", [index name], table);
+            *status = (RASqliteTableCheckStatus *) RASqliteTableCheckStatusModified;
+            return NO;
+        }
+
+        if (![definition isEqualToString:[index definitionForTable:table]]) {
+            RASqliteDebugLog(@"Index `%@` do not match index given for structure `%@`.", [index name], table);
+            *status = (RASqliteTableCheckStatus *) RASqliteTableCheckStatusModified;
+            return NO;
+        }
+    }
+
+    return YES;
+}
+
+- (BOOL)createIndexesForTable:(NSString *)table withColumns:(NSArray *)columns {
+    NSArray *indexes = RASqliteIndexesForStructure(columns);
+    if ([indexes count] == 0) {
+        return YES;
+    }
+
+    BOOL __block created = NO;
+
+    [self queueWithBlock:^(RASqlite *db) {
+        NSDictionary *tables = [db fetchDefinitions];
+        if (!tables) {
+            return;
+        }
+
+        NSDictionary *definitions = tables[table];
+
+        created = YES;
+        for (RASqliteIndex *index in indexes) {
+            NSString *definition = [index definitionForTable:table];
+
+            NSString *existing = definitions[[index name]];
+            if ([existing isEqualToString:definition]) {
+                continue;
+            }
+
+            // The definition for the index have changed, it have to be
+            // removed before it can be created with the new definition.
+            if (existing && ![db execute:RASqliteSF(@"DROP INDEX %@", [index name])]) {
+                created = NO;
+                break;
+            }
+
+            RASqliteDebugLog(@"Create index query: %@", definition);
+            if (![db execute:definition]) {
+                created = NO;
+                break;
+            }
+        }
+    }];
+
+    return created;
+}
+
+- (BOOL)migrate {
+    // Keeps track on whether the structure was migrated.
+    BOOL __block migrated = NO;
 
     [self queueWithBlock:^(RASqlite *db) {
         NSDictionary *tables = [db structure];
         if (!tables) {
             // Raise an exception, no structure have been supplied.
             [NSException raise:RASqliteCheckDatabaseException
-                        format:@"Unable to check database structure, none has been supplied."];
+                        format:@"Unable to migrate database structure, none has been supplied."];
         }
 
-        // Get the pointer for the method, performance improvement.
-        SEL selector = @selector(checkTable:withColumns:status:);
-
-        typedef BOOL (*check)(id, SEL, NSString *, NSArray *, RASqliteTableCheckStatus **);
-        check checkTable = (check) [db methodForSelector:selector];
+        // Checking whether the database instance have implemented the method
+        // for receiving the migration progress.
+        BOOL isProgressAvailable = [db respondsToSelector:@selector(migrationOfTable:didCopyRows:ofTotal:)];
 
-        // Checking whether the database instance have implemented
-        // methods for before and after table check handling.
-        BOOL isBeforeAvailable = [db respondsToSelector:@selector(beforeTableCheck:)];
-        BOOL isAfterAvailable = [db respondsToSelector:@selector(afterTableCheck:withStatus:)];
+        // Change the migrated check before going in to the migrate loop.
+        migrated = YES;
 
-        RASqliteTableCheckStatus *status;
-        for (NSString *table in tables) {
-            // If the before check method is available and it returns
-            // `NO` we should move on to the next table.
-            if (isBeforeAvailable && ![db beforeTableCheck:table]) {
-                continue;
+        for (NSString *table in RASqliteTableNamesForStructure(tables)) {
+            RASqliteMigrationProgress progress;
+            if (isProgressAvailable) {
+                progress = ^(NSUInteger copied, NSUInteger total) {
+                    [db migrationOfTable:table didCopyRows:copied ofTotal:total];
+                };
             }
 
-            status = (RASqliteTableCheckStatus *) RASqliteTableCheckStatusClean;
-            checkTable(db, selector, table, tables[table], &status);
-
-            // If the after check method is available we have to execute it,
-            // sending the current status of the table.
-            // This way we can determined what to do about the changes (if any).
-            if (isAfterAvailable) {
-                [db afterTableCheck:table withStatus:status];
+            if (![db migrateTable:table withColumns:tables[table] progress:progress]) {
+                migrated = NO;
+                break;
             }
         }
+
+        // Every table now matches the structure, the fingerprint can be stored.
+        if (migrated) {
+            [db storeStructureFingerprint:[db structureFingerprint]];
+        }
     }];
 
-    return valid;
+    return migrated;
 }
 
-- (BOOL)checkTable:(NSString *)table withColumns:(NSArray *)columns {
+- (BOOL)migrateTable:(NSString *)table withColumns:(NSArray *)columns {
+    return [self migrateTable:table withColumns:columns progress:nil];
+}
+
+- (BOOL)migrateTable:(NSString *)table withColumns:(NSArray *)columns progress:(RASqliteMigrationProgress)progress {
     if (!table) {
         // Raise an exception, no valid table name.
         [NSException raise:NSInvalidArgumentException
-                    format:@"Unable to check table without valid name."];
+                    format:@"Unable to migrate table without valid name."];
     }
 
     if (!columns) {
         // Raise an exception, no defined columns.
         [NSException raise:NSInvalidArgumentException
-                    format:@"Unable to check table without defined columns."];
+                    format:@"Unable to migrate table without defined columns."];
     }
 
-    // Keeps track on whether the structure for the table is valid.
-    //
-    // The default value have to be `YES`, otherwise we risk of deleting the
-    // table when something is wrong with the database instance.
-    BOOL __block valid = YES;
+    // Keeps track on whether the table was migrated.
+    BOOL __block migrated = NO;
 
     [self queueWithBlock:^(RASqlite *db) {
-        // Check whether the defined columns and the table columns match.
         NSArray *tColumns = [db fetch:RASqliteSF(@"PRAGMA table_info(%@)", table)];
-        if (0 == [tColumns count]) {
-            RASqliteDebugLog(@"Table `%@` do not exist with any structure within the database.", table);
-            valid = NO;
+
+        RASqliteTableCheckStatus *status = (RASqliteTableCheckStatus *) RASqliteTableCheckStatusClean;
+        BOOL matching = [db matchTable:table withColumns:columns tableColumns:tColumns status:&status];
+
+        // There is no data to preserve, just create the table.
+        if ((RASqliteTableCheckStatus *) RASqliteTableCheckStatusNew == status) {
+            migrated = [db createTable:table withColumns:columns];
             return;
         }
 
-        if ([tColumns count] != [columns count]) {
-            RASqliteDebugLog(@"Number of specified columns for table `%@` do not matched the defined table count.", table);
-            valid = NO;
+        // Table options can not be altered, i.e. the table have to be rebuilt
+        // if the options have changed.
+        BOOL fullText = RASqliteFullTextOptionsForStructure(columns) != nil;
+        BOOL options;
+        if (fullText) {
+            NSDictionary *definitions = [db fetchDefinitions];
+            options = [db matchDefinitionsForTable:table withColumns:columns definitions:definitions[table] status:&status];
+        } else {
+            NSDictionary *row = [db fetchRow:@"SELECT sql FROM sqlite_master WHERE type = 'table' AND name = ?" withParam:table];
+            options = RASqliteOptionsMatchDefinition(columns, [row getColumn:@"sql"]);
+        }
+        if (matching && options) {
+            RASqliteDebugLog(@"Table columns for `%@` do not need to be migrated.", table);
+            migrated = [db createIndexesForTable:table withColumns:columns];
             return;
         }
 
-        unsigned int index = 0;
-        for (RASqliteColumn *column in columns) {
-            // The column have to be of type `RASqliteColumn`.
-            if (![column isKindOfClass:[RASqliteColumn class]]) {
-                [NSException raise:NSInvalidArgumentException
-                            format:@"Column defined for table `%@` at index `%i` is not of type `RASqliteColumn.", table, index];
-            }
+        // Using a savepoint instead of a transaction, since the migration
+        // might be executed from within an already active transaction.
+        if (![db execute:@"SAVEPOINT rasqlite_migration"]) {
+            return;
+        }
 
-            // Retrieve the column definition from the table.
-            NSDictionary *tColumn = tColumns[index];
+        NSArray *appendable;
+        if (options && !fullText) {
+            appendable = [db appendableColumnsForTable:table withColumns:columns tableColumns:tColumns];
+        }
 
-            // Check that the column name matches.
-            if (![[tColumn getColumn:@"name"] isEqualToString:[column name]]) {
-                RASqliteDebugLog(@"Column name at index `%i` do not match column given for structure `%@`.", index, table);
-                valid = NO;
-                break;
+        if (appendable) {
+            migrated = YES;
+            for (RASqliteColumn *column in appendable) {
+                NSString *sql = RASqliteSF(@"ALTER TABLE %@ ADD COLUMN %@", table, RASqliteColumnDefinition(column, NO));
+                if (![db execute:sql]) {
+                    migrated = NO;
+                    break;
+                }
             }
+        } else if (fullText) {
+            migrated = [db rebuildFullTextTable:table withColumns:columns tableColumns:tColumns];
+        } else {
+            migrated = [db rebuildTable:table withColumns:columns tableColumns:tColumns progress:progress];
+        }
 
-            // Check that the column type matches.
-            if (![[tColumn getColumn:@"type"] isEqualToString:[column type]]) {
-                RASqliteDebugLog(@"Column type at index `%i` do not match column given for structure `%@`.", index, table);
-                valid = NO;
-                break;
-            }
+        if (migrated) {
+            migrated = [db createIndexesForTable:table withColumns:columns];
+        }
 
-            // Check that whether the column matches the primary key setting.
-            if ([column isPrimaryKey] != [[tColumn getColumn:@"pk"] boolValue]) {
-                RASqliteDebugLog(@"Column primary key option at index `%i` do not match column given for structure `%@`.", index, table);
-                valid = NO;
-                break;
-            }
+        if (!migrated) {
+            RASqliteErrorLog(@"Unable to migrate table `%@`, rolling back changes.", table);
+            [db execute:@"ROLLBACK TO SAVEPOINT rasqlite_migration"];
+        }
+        [db execute:@"RELEASE SAVEPOINT rasqlite_migration"];
+
+        if (migrated) {
+            RASqliteInfoLog(@"Table `%@` have been migrated.", table);
+        }
+    }];
+
+    return migrated;
+}
+
+- (NSArray *)appendableColumnsForTable:(NSString *)table withColumns:(NSArray *)columns tableColumns:(NSArray *)tColumns {
+    // Indexes are created separately once the columns have been migrated.
+    columns = RASqliteColumnsForStructure(columns);
+
+    NSUInteger count = [tColumns count];
+    if ([columns count] <= count) {
+        return nil;
+    }
+
+    // The existing columns have to be unchanged, i.e. the defined columns
+    // should only append columns to the table.
+    RASqliteTableCheckStatus *status;
+    NSArray *existing = [columns subarrayWithRange:NSMakeRange(0, count)];
+    if (![self matchTable:table withColumns:existing tableColumns:tColumns status:&status]) {
+        return nil;
+    }
+
+    NSArray *appendable = [columns subarrayWithRange:NSMakeRange(count, [columns count] - count)];
+    for (RASqliteColumn *column in appendable) {
+        if (![column isKindOfClass:[RASqliteColumn class]]) {
+            [NSException raise:NSInvalidArgumentException
+                        format:@"Column defined for table `%@` is not of type `RASqliteColumn.", table];
+        }
+
+        // Primary key and unique columns can not be added with `ALTER TABLE`,
+        // and columns that are not nullable require a default value.
+        if ([column isPrimaryKey] || [column isUnique]) {
+            return nil;
+        }
+
+        if (![column isNullable] && nil == [column defaultValue]) {
+            return nil;
+        }
+    }
+
+    return appendable;
+}
+
+- (BOOL)rebuildTable:(NSString *)table withColumns:(NSArray *)columns tableColumns:(NSArray *)tColumns progress:(RASqliteMigrationProgress)progress {
+    NSString *destination = RASqliteSF(@"rasqlite_migration_%@", table);
+
+    // Indexes and triggers are removed together with the table, i.e. their
+    // definitions have to be retrieved before the table is swapped.
+    NSArray *definitions = [self fetch:@"SELECT type, name, sql FROM sqlite_master "
+                                               "WHERE type IN ('index', 'trigger') AND tbl_name = ? AND sql IS NOT NULL"
+                             withParam:table];
+    if (!definitions) {
+        return NO;
+    }
+
+    // The rowid can only be preserved if both the existing and new table have one.
+    NSDictionary *row = [self fetchRow:@"SELECT sql FROM sqlite_master WHERE type = 'table' AND name = ?" withParam:table];
+    BOOL rowid = ![RASqliteOptionsForDefinition([row getColumn:@"sql"]) containsObject:@"WITHOUT ROWID"]
+            && ![RASqliteOptionsForStructure(columns) isWithoutRowid];
+
+    // Remove left overs from previously failed migrations.
+    if (![self execute:RASqliteSF(@"DROP TABLE IF EXISTS %@", destination)]) {
+        return NO;
+    }
+
+    if (![self execute:RASqliteSF(@"CREATE TABLE %@", RASqliteTableDefinition(destination, columns))]) {
+        return NO;
+    }
+
+    // Only the columns available within both structures can be copied.
+    NSMutableSet *names = [[NSMutableSet alloc] init];
+    for (NSDictionary *tColumn in tColumns) {
+        [names addObject:[tColumn getColumn:@"name"]];
+    }
+
+    NSMutableArray *common = [[NSMutableArray alloc] init];
+    for (RASqliteColumn *column in RASqliteColumnsForStructure(columns)) {
+        if ([names containsObject:[column name]]) {
+            [common addObject:[column name]];
+        }
+    }
+
+    if ([common count] > 0) {
+        NSString *list = [common componentsJoinedByString:@", "];
+        if (![self copyRowsFromTable:table toTable:destination columns:list rowid:rowid progress:progress]) {
+            return NO;
+        }
+    }
+
+    if (![self execute:RASqliteSF(@"DROP TABLE %@", table)]) {
+        return NO;
+    }
+
+    if (![self execute:RASqliteSF(@"ALTER TABLE %@ RENAME TO %@", destination, table)]) {
+        return NO;
+    }
+
+    for (NSDictionary *definition in definitions) {
+        // Definitions referencing columns that have been removed can not be
+        // recreated, which should not fail the whole migration.
+        NSError *error = [self error];
+        if (![self execute:[definition getColumn:@"sql"]]) {
+            RASqliteWarningLog(@"Unable to recreate %@ `%@` for table `%@`.",
+                    [definition getColumn:@"type"], [definition getColumn:@"name"], table);
+            [self setError:error];
+        }
+    }
+
+    return YES;
+}
+
+- (BOOL)copyRowsFromTable:(NSString *)table toTable:(NSString *)destination columns:(NSString *)list rowid:(BOOL)rowid progress:(RASqliteMigrationProgress)progress {
+    NSDictionary *row = [self fetchRow:RASqliteSF(@"SELECT COUNT(*) AS total FROM %@", table)];
+    if (!row) {
+        return NO;
+    }
+    NSUInteger total = [[row getColumn:@"total"] unsignedIntegerValue];
+
+    if (!rowid) {
+        if (![self execute:RASqliteSF(@"INSERT INTO %@(%@) SELECT %@ FROM %@", destination, list, list, table)]) {
+            return NO;
+        }
+
+        if (progress) {
+            progress(total, total);
+        }
+        return YES;
+    }
+
+    // The rows are copied in batches ordered by the rowid, i.e. each batch
+    // seeks from the last copied rowid and the progress can be reported
+    // between the batches. The rowid is copied to keep references intact.
+    NSString *sql = RASqliteSF(@"INSERT INTO %@(rowid, %@) SELECT rowid, %@ FROM %@ WHERE rowid > ? ORDER BY rowid LIMIT %lu",
+            destination, list, list, table, (unsigned long) RASqliteMigrationBatchSize);
+    NSString *last = RASqliteSF(@"SELECT MAX(rowid) AS last FROM %@", destination);
+
+    NSNumber *rowId = @(LLONG_MIN);
+    NSUInteger copied = 0;
+    while (copied < total) {
+        if (![self execute:sql withParam:rowId]) {
+            return NO;
+        }
+
+        NSUInteger changes = [[self rowCount] unsignedIntegerValue];
+        if (0 == changes) {
+            break;
+        }
+        copied += changes;
+        rowId = [[self fetchRow:last] getColumn:@"last"];
+
+        RASqliteDebugLog(@"Copied %lu of %lu rows from table `%@`.", (unsigned long) copied, (unsigned long) total, table);
+        if (progress) {
+            progress(copied, total);
+        }
+    }
+
+    return YES;
+}
 
-            // Check that whether the column matches the nullable setting.
-            if ([column isNullable] == [[tColumn getColumn:@"notnull"] boolValue]) {
-                RASqliteDebugLog(@"Column nullable option at index `%i` do not match column given for structure `%@`.", index, table);
-                valid = NO;
+- (BOOL)createFullTextTable:(NSString *)table withColumns:(NSArray *)columns {
+    RASqliteFullTextOptions *fullText = RASqliteFullTextOptionsForStructure(columns);
+    NSArray *names = RASqliteColumnNamesForStructure(columns);
+
+    BOOL __block created = NO;
+
+    [self queueWithBlock:^(RASqlite *db) {
+        NSDictionary *row = [db fetchRow:@"SELECT name FROM sqlite_master WHERE type = 'table' AND name = ?" withParam:table];
+        BOOL exists = row != nil;
+
+        NSString *sql = RASqliteSF(@"CREATE VIRTUAL TABLE IF NOT EXISTS %@", [fullText definitionForTable:table columns:names]);
+        RASqliteDebugLog(@"Create query: %@", sql);
+
+        created = [db execute:sql];
+
+        NSDictionary *triggers = [fullText triggersForTable:table columns:names];
+        for (NSString *trigger in triggers) {
+            if (!created) {
                 break;
             }
+            created = [db execute:RASqliteSF(@"CREATE TRIGGER IF NOT EXISTS %@", triggers[trigger])];
+        }
 
-            // TODO: Check the default value, `dflt_value` from tColumn.
-            // TODO: Check for unique columns.
-            // TODO: Check for autoincremental.
+        // The triggers only handle changes from now on, the existing rows
+        // within the content table have to be indexed.
+        if (created && !exists && [fullText contentTable]) {
+            created = [db execute:RASqliteSF(@"INSERT INTO %@(%@) VALUES('rebuild')", table, table)];
+        }
 
-            index++;
+        if (created) {
+            RASqliteDebugLog(@"Full-text table `%@` have been created.", table);
+            return;
         }
+
+        RASqliteDebugLog(@"Full-text table `%@` have not been created.", table);
     }];
 
-    return valid;
+    return created;
 }
 
-- (BOOL)checkTable:(NSString *)table withColumns:(NSArray *)columns status:(RASqliteTableCheckStatus **)status {
-    return [self checkTable:table withColumns:columns];
+- (BOOL)matchTriggersForFullTextTable:(NSString *)table withColumns:(NSArray *)columns {
+    RASqliteFullTextOptions *fullText = RASqliteFullTextOptionsForStructure(columns);
+    NSDictionary *triggers = [fullText triggersForTable:table columns:RASqliteColumnNamesForStructure(columns)];
+
+    // Triggers left over from a previous content table should not exist,
+    // i.e. every trigger name have to be checked.
+    NSArray *rows = [self fetch:@"SELECT name, sql FROM sqlite_master WHERE type = 'trigger' AND name IN (?, ?, ?)"
+                     withParams:RASqliteFullTextTriggerNames(table)];
+    if (!rows || [rows count] != [triggers count]) {
+        return NO;
+    }
+
+    for (NSDictionary *row in rows) {
+        NSString *definition = triggers[[row getColumn:@"name"]];
+        if (!definition || ![[row getColumn:@"sql"] isEqualToString:RASqliteSF(@"CREATE TRIGGER %@", definition)]) {
+            return NO;
+        }
+    }
+
+    return YES;
+}
+
+- (BOOL)rebuildFullTextTable:(NSString *)table withColumns:(NSArray *)columns tableColumns:(NSArray *)tColumns {
+    for (NSString *trigger in RASqliteFullTextTriggerNames(table)) {
+        if (![self execute:RASqliteSF(@"DROP TRIGGER IF EXISTS %@", trigger)]) {
+            return NO;
+        }
+    }
+
+    // The content is stored within the existing table, i.e. it have to be
+    // kept until the rows have been copied to the new table.
+    NSString *source = RASqliteSF(@"rasqlite_migration_%@", table);
+    if (![self execute:RASqliteSF(@"DROP TABLE IF EXISTS %@", source)]) {
+        return NO;
+    }
+
+    if (![self execute:RASqliteSF(@"ALTER TABLE %@ RENAME TO %@", table, source)]) {
+        return NO;
+    }
+
+    if (![self createFullTextTable:table withColumns:columns]) {
+        return NO;
+    }
+
+    // An external content index have already been rebuilt from the content
+    // table, only content stored within the table have to be copied.
+    if (![RASqliteFullTextOptionsForStructure(columns) contentTable]) {
+        NSMutableSet *names = [[NSMutableSet alloc] init];
+        for (NSDictionary *tColumn in tColumns) {
+            [names addObject:[tColumn getColumn:@"name"]];
+        }
+
+        NSMutableArray *common = [[NSMutableArray alloc] init];
+        for (NSString *name in RASqliteColumnNamesForStructure(columns)) {
+            if ([names containsObject:name]) {
+                [common addObject:name];
+            }
+        }
+
+        if ([common count] > 0) {
+            NSString *list = [common componentsJoinedByString:@", "];
+            NSString *sql = RASqliteSF(@"INSERT INTO %@(rowid, %@) SELECT rowid, %@ FROM %@", table, list, list, source);
+            if (![self execute:sql]) {
+                return NO;
+            }
+        }
+    }
+
+    return [self execute:RASqliteSF(@"DROP TABLE %@", source)];
 }
 
 - (BOOL)create {
@@ -180,7 +1559,7 @@ static NSString *RASqliteRemoveTableException = @"Remove table";
         created = YES;
 
         // Loops through each of the tables and attempt to create their structure.
-        for (NSString *table in tables) {
+        for (NSString *table in RASqliteTableNamesForStructure(tables)) {
             if (!createTable(db, selector, table, tables[table])) {
                 created = NO;
                 break;
@@ -204,63 +1583,26 @@ static NSString *RASqliteRemoveTableException = @"Remove table";
                     format:@"Unable to create table without defined columns."];
     }
 
+    RASqliteCheckCompressionForStructure(table, columns);
+
+    if (RASqliteFullTextOptionsForStructure(columns)) {
+        return [self createFullTextTable:table withColumns:columns];
+    }
+
     // Keeps track on whether the table was created.
     BOOL __block created = NO;
 
     [self queueWithBlock:^(RASqlite *db) {
-        // The create query will be constructed with a list of items, each
-        // item represent their column name, data type, constraints, etc.
-        NSMutableArray *list = [[NSMutableArray alloc] init];
-        NSMutableString *item;
-
-        // Assemble the columns and data types for the structure.
-        for (RASqliteColumn *column in columns) {
-            // The column have to be of type `RASqliteColumn`.
-            if (![column isKindOfClass:[RASqliteColumn class]]) {
-                [NSException raise:NSInvalidArgumentException
-                            format:@"Column defined for table `%@` is not of type `RASqliteColumn.", table];
-            }
-
-            // Start with building the item with the column name and type.
-            item = [[NSMutableString alloc] init];
-            [item appendFormat:@"%@ %@", [column name], [column type]];
-
-            // Check if the column should be unique.
-            if ([column isUnique]) {
-                [item appendString:@" UNIQUE"];
-            }
-
-            // Handle if the column should be nullable or not.
-            if (![column isNullable]) {
-                [item appendString:@" NOT"];
-            }
-            [item appendString:@" NULL"];
-
-            // Check if the column should be a primary key.
-            if ([column isPrimaryKey]) {
-                [item appendString:@" PRIMARY KEY"];
-
-                // Column have to be of type `integer` to use `autoincremental`.
-                if ([column isAutoIncrement] && RASqliteInteger == [column numericType]) {
-                    [item appendString:@" AUTOINCREMENT"];
-                }
-            } else {
-                // If the column have a default value available, use it.
-                // Have to check for nil since default value can be @0.
-                if ([column defaultValue] != nil) {
-                    [item appendFormat:@" DEFAULT `%@`", [column defaultValue]];
-                }
-            }
-
-            // Add the item to the list of columns.
-            [list addObject:item];
-        }
         // Build the actual sql query for creating the table.
-        NSString *sql = RASqliteSF(@"CREATE TABLE IF NOT EXISTS %@(%@)", table, [list componentsJoinedByString:@","]);
+        NSString *sql = RASqliteSF(@"CREATE TABLE IF NOT EXISTS %@", RASqliteTableDefinition(table, columns));
         RASqliteDebugLog(@"Create query: %@", sql);
 
         // Attempt to create the database table.
         created = [db execute:sql];
+        if (created) {
+            created = [db createIndexesForTable:table withColumns:columns];
+        }
+
         if (created) {
             RASqliteDebugLog(@"Table `%@` have been created.", table);
             return;
@@ -283,6 +1625,16 @@ static NSString *RASqliteRemoveTableException = @"Remove table";
     BOOL __block removed = NO;
 
     [self queueWithBlock:^(RASqlite *db) {
+        // Triggers for full-text tables belong to the content table, i.e.
+        // they are not removed together with the table.
+        if (RASqliteFullTextOptionsForStructure([db structure][table])) {
+            for (NSString *trigger in RASqliteFullTextTriggerNames(table)) {
+                if (![db execute:RASqliteSF(@"DROP TRIGGER IF EXISTS %@", trigger)]) {
+                    return;
+                }
+            }
+        }
+
         // Attempt to remove the database table.
         removed = [db execute:RASqliteSF(@"DROP TABLE IF EXISTS %@", table)];
         if (removed) {
@@ -296,4 +1648,172 @@ static NSString *RASqliteRemoveTableException = @"Remove table";
     return removed;
 }
 
+- (BOOL)upsertRows:(NSArray *)rows intoTable:(NSString *)table inserted:(NSUInteger *)inserted updated:(NSUInteger *)updated {
+    NSArray *structure = [self structure][table];
+    if (!structure) {
+        [NSException raise:RASqliteUpsertException
+                    format:@"Unable to upsert rows, table `%@` is not defined within the structure.", table];
+    }
+
+    NSArray *columns = RASqliteColumnsForStructure(structure);
+    NSMutableArray *keys = [[NSMutableArray alloc] init];
+    for (RASqliteColumn *column in columns) {
+        if ([column isPrimaryKey]) {
+            [keys addObject:[column name]];
+        }
+    }
+
+    if ([keys count] == 0) {
+        [NSException raise:RASqliteUpsertException
+                    format:@"Unable to upsert rows, table `%@` do not have a primary key.", table];
+    }
+
+    // Tables without rowid do not change the last insert id, the inserted rows
+    // have to be counted instead.
+    BOOL rowid = ![RASqliteOptionsForStructure(structure) isWithoutRowid];
+    NSMutableDictionary *queries = [[NSMutableDictionary alloc] init];
+
+    NSUInteger insertedRows = 0;
+    NSUInteger updatedRows = 0;
+
+    BOOL upserted = YES;
+    for (NSUInteger offset = 0; offset < [rows count] && upserted; offset += RASqliteUpsertBatchSize) {
+        NSRange range = NSMakeRange(offset, MIN(RASqliteUpsertBatchSize, [rows count] - offset));
+
+        // Each chunk is dispatched separately, i.e. other queries do not have
+        // to wait for every row to be upserted.
+        @autoreleasepool {
+            upserted = [self upsertChunk:[rows subarrayWithRange:range]
+                               intoTable:table
+                                 columns:columns
+                                    keys:keys
+                                 queries:queries
+                                   rowid:rowid
+                                inserted:&insertedRows
+                                 updated:&updatedRows];
+        }
+    }
+
+    if (inserted) {
+        *inserted = insertedRows;
+    }
+    if (updated) {
+        *updated = updatedRows;
+    }
+
+    return upserted;
+}
+
+- (BOOL)upsertRows:(NSArray *)rows intoTable:(NSString *)table {
+    return [self upsertRows:rows intoTable:table inserted:NULL updated:NULL];
+}
+
+- (BOOL)upsertChunk:(NSArray *)rows intoTable:(NSString *)table columns:(NSArray *)columns keys:(NSArray *)keys queries:(NSMutableDictionary *)queries rowid:(BOOL)rowid inserted:(NSUInteger *)inserted updated:(NSUInteger *)updated {
+    BOOL __block upserted = NO;
+
+    NSUInteger __block insertedRows = 0;
+    NSUInteger __block updatedRows = 0;
+
+    [self queueWithBlock:^(RASqlite *db) {
+        // Using a savepoint instead of a transaction, since the upsert might
+        // be executed from within an already active transaction.
+        if (![db execute:@"SAVEPOINT rasqlite_upsert"]) {
+            return;
+        }
+
+        NSString *count = RASqliteSF(@"SELECT COUNT(*) AS count FROM %@", table);
+        NSUInteger before = 0;
+        if (!rowid) {
+            before = [[[db fetchRow:count] getColumn:@"count"] unsignedIntegerValue];
+        }
+
+        upserted = YES;
+        NSUInteger changed = 0;
+        for (NSDictionary *row in rows) {
+            // The columns within the row determines which query to use.
+            NSMutableIndexSet *indexes = [[NSMutableIndexSet alloc] init];
+            [columns enumerateObjectsUsingBlock:^(RASqliteColumn *column, NSUInteger index, BOOL *stop) {
+                if (row[[column name]]) {
+                    [indexes addIndex:index];
+                }
+            }];
+
+            NSArray *query = queries[indexes];
+            if (!query) {
+                NSArray *rColumns = [columns objectsAtIndexes:indexes];
+                query = @[RASqliteUpsertQuery(table, rColumns, keys), rColumns];
+                queries[indexes] = query;
+            }
+
+            NSMutableArray *params = [[NSMutableArray alloc] initWithCapacity:[query[1] count]];
+            for (RASqliteColumn *column in query[1]) {
+                [params addObject:[column bindableValue:row[[column name]]]];
+            }
+
+            if (rowid) {
+                [db setLastInsertId:@(RASqliteUpsertSentinelId)];
+            }
+
+            if (![db executeCached:query[0] withParams:params]) {
+                upserted = NO;
+                break;
+            }
+
+            // Conflicting rows with nothing to update are neither inserted
+            // nor updated, i.e. no rows are changed.
+            if (rowid && [[db lastInsertId] longLongValue] != RASqliteUpsertSentinelId) {
+                insertedRows++;
+            } else if ([[db rowCount] unsignedIntegerValue] > 0) {
+                changed++;
+            }
+        }
+
+        if (upserted && !rowid) {
+            NSUInteger after = [[[db fetchRow:count] getColumn:@"count"] unsignedIntegerValue];
+            insertedRows = after - before;
+            changed -= insertedRows;
+        }
+        updatedRows = changed;
+
+        if (!upserted) {
+            RASqliteErrorLog(@"Unable to upsert rows into `%@`, rolling back chunk.", table);
+            [db execute:@"ROLLBACK TO SAVEPOINT rasqlite_upsert"];
+        }
+        [db execute:@"RELEASE SAVEPOINT rasqlite_upsert"];
+    }];
+
+    if (upserted) {
+        *inserted += insertedRows;
+        *updated += updatedRows;
+    }
+
+    return upserted;
+}
+
+- (NSArray *)search:(NSString *)text inTable:(NSString *)table limit:(NSUInteger)limit {
+    NSString *query = RASqliteSearchQuery(text);
+    if (!query) {
+        return @[];
+    }
+
+    return [self searchWithExpression:query inTable:table limit:limit];
+}
+
+- (NSArray *)searchWithExpression:(NSString *)query inTable:(NSString *)table limit:(NSUInteger)limit {
+    NSArray *structure = [self structure][table];
+    if (!RASqliteFullTextOptionsForStructure(structure)) {
+        [NSException raise:RASqliteSearchException
+                    format:@"Unable to search table, `%@` is not defined as a full-text table within the structure.", table];
+    }
+
+    // The hidden `rank` column is `bm25` by default, and ordering by it lets
+    // FTS5 optimize the ranking of the hits.
+    NSString *columns = [RASqliteColumnNamesForStructure(structure) componentsJoinedByString:@", "];
+    NSString *sql = RASqliteSF(@"SELECT rowid, %@, rank, snippet(%@, -1, '<b>', '</b>', '...', 16) AS snippet "
+                                       "FROM %@ WHERE %@ MATCH ? ORDER BY rank LIMIT ?",
+            columns, table, table, table);
+
+    return [self fetchCached:sql withParams:@[query, @(limit)]];
+}
+
 @end
\ No newline at end of file
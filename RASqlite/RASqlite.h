@@ -19,13 +19,29 @@ FOUNDATION_EXPORT const unsigned char RASqliteVersionString[];
 
 #import "RASqliteLog.h"
 #import "RASqliteTransaction.h"
+#import "RASqliteCancellationToken.h"
+#import "RASqliteTableChange.h"
+#import "RASqliteFunctionArguments.h"
+#import "RASqliteArray.h"
 
 // Definition for column structure.
 #import "RASqliteColumn.h"
 
+// Definition for index structure.
+#import "RASqliteIndex.h"
+
+// Definition for table options.
+#import "RASqliteTableOptions.h"
+
+// Definition for full-text tables.
+#import "RASqliteFullTextOptions.h"
+
 // Consistent way of dealing with `nil` values within dictionaries.
 #import "NSDictionary+RASqlite.h"
 
+// Keyset pagination for queries.
+#import "RASqlitePager.h"
+
 // -- -- Exception
 
 /// Exception name for issues with column constrains.
@@ -48,6 +64,20 @@ NS_INLINE RASqliteColumn *RAColumn(NSString *name, RASqliteDataType type) {
     return [[RASqliteColumn alloc] initWithName:name type:type];
 };
 
+/**
+ Shorthand for index initialization.
+
+ @param name Name of the index.
+ @param columns Names of the indexed columns, in order.
+
+ @return Initialized index.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+NS_INLINE RASqliteIndex *RAIndex(NSString *name, NSArray *columns) {
+    return [[RASqliteIndex alloc] initWithName:name columns:columns];
+};
+
 /**
  Shorthand for builing an `NSString` with format.
 
@@ -97,8 +127,73 @@ NS_INLINE RASqliteColumn *RAColumn(NSString *name, RASqliteDataType type) {
  */
 - (instancetype)initWithName:(NSString *)name;
 
+/**
+ Initialize with the absolute path for an immutable database file.
+
+ The database is opened read-only with `immutable=1`, i.e. SQLite do not
+ acquire any locks or check for journals, and the file is memory-mapped.
+
+ @param path Absolute path for the existing database file.
+
+ @throws NSInvalidArgumentException If the path is `nil`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ The connection is not serialized on the query queue, i.e. the instance can
+ only be used by a single thread. Use `immutableDatabaseWithPath:` to retrieve
+ the connection for the calling thread.
+
+ @par
+ The file must not change while it is open, e.g. reference data shipped
+ within the application bundle. The directory is neither created nor checked
+ for write permissions.
+ */
+- (instancetype)initWithImmutablePath:(NSString *)path;
+
+/**
+ Retrieve the immutable database connection for the calling thread.
+
+ @param path Absolute path for the existing database file.
+
+ @return Connection confined to the calling thread.
+
+ @code
+ NSDictionary *row = [[RASqlite immutableDatabaseWithPath:path] fetchRow:@"SELECT * FROM city WHERE id = ?" withParam:@1];
+ @endcode
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ Each thread get its own connection, which is kept until the thread exits.
+ Reads on different threads are performed concurrently.
+
+ @par
+ The worker threads for dispatch queues are reused and rarely exit, i.e. the
+ connection and its memory map are kept for as long as the worker thread is
+ alive. Call `closeImmutableDatabaseWithPath:` at the end of the dispatched
+ block, or use a dedicated thread, to release the connection.
+ */
++ (instancetype)immutableDatabaseWithPath:(NSString *)path;
+
+/**
+ Close the immutable database connection for the calling thread.
+
+ @param path Absolute path for the database file.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ Only the connection for the calling thread is closed, and the next call to
+ `immutableDatabaseWithPath:` on the thread opens a new connection.
+ */
++ (void)closeImmutableDatabaseWithPath:(NSString *)path;
+
 #pragma mark - Database
 
+/// Stores whether the database have been initialized as immutable.
+@property(nonatomic, readonly, getter = isImmutable) BOOL immutable;
+
 /// Stores the defined structure for the database tables.
 @property(nonatomic, readonly, copy) NSDictionary *structure;
 
@@ -160,9 +255,338 @@ NS_INLINE RASqliteColumn *RAColumn(NSString *name, RASqliteDataType type) {
  */
 - (BOOL)close;
 
+#pragma mark - Diagnostics
+
+/**
+ Stores whether the query plan advisor is enabled, disabled by default.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ When enabled, `EXPLAIN QUERY PLAN` is executed the first time each distinct
+ query is prepared. Queries performing a full table scan without an index, or
+ building temporary B-trees, are logged with the warning-level and included in
+ the `queryPlanReport`. Disabling the advisor will discard the report.
+ */
+@property(atomic, getter = isQueryPlanAdvisorEnabled) BOOL queryPlanAdvisorEnabled;
+
+/**
+ Retrieve the offending queries found by the query plan advisor.
+
+ @return Array with a dictionary for each of the offending queries.
+
+ @code
+ for (NSDictionary *entry in [db queryPlanReport]) {
+	NSLog(@"%@ on %@: %@", entry[@"query"], entry[@"tables"], entry[@"plan"]);
+ }
+ @endcode
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ Each dictionary contains the `query`, the involved `tables`, and the offending
+ details from the query `plan`. If the advisor is disabled, `nil` is returned.
+ */
+- (NSArray *)queryPlanReport;
+
+/**
+ Stores whether the query profiling is enabled, disabled by default.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ When enabled, every query is tracked by its normalized form with the number of
+ calls, rows returned, time spent preparing and executing, and the latency
+ including the time waiting for the queue. Disabling the profiling will discard
+ the collected statistics.
+ */
+@property(atomic, getter = isProfilingEnabled) BOOL profilingEnabled;
+
+/**
+ Stores the latency threshold, in seconds, for logging slow queries.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ Slow queries are logged with the warning-level while the profiling is
+ enabled. The default value is zero, i.e. slow queries are not logged.
+ */
+@property(atomic) NSTimeInterval slowQueryThreshold;
+
+/**
+ Retrieve the collected query statistics.
+
+ @return Normalized queries with their statistics.
+
+ @code
+ NSDictionary *snapshot = [db profileSnapshot];
+ for (NSString *query in snapshot) {
+	NSLog(@"%@: %@ calls, p99 %@ s", query, snapshot[query][@"count"], snapshot[query][@"p99"]);
+ }
+ @endcode
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ The statistics for each query contains the `count`, `rows`, `prepareTime`,
+ `executionTime`, and the latency percentiles `p50`, `p95`, `p99`, and
+ `maximum`. Every time is in seconds. If the profiling is disabled, `nil` is
+ returned.
+ */
+- (NSDictionary *)profileSnapshot;
+
+/**
+ Retrieve the statistics for the query queue.
+
+ @return Statistics for the query queue.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ The statistics contains the number of `dispatched` blocks, `reentrant`
+ dispatches from within the queue, current `depth` and `maximumDepth` of
+ callers either waiting for or executing on the queue, and percentiles for the
+ `waitTime` and `executionTime`. The queue is shared between the database
+ instances, i.e. so are the statistics.
+ */
+- (NSDictionary *)queueStatistics;
+
+#pragma mark - Cancellation
+
+/**
+ Stores the time budget, in seconds, for executing each query.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ The budget is measured from when the query starts executing on the queue, and
+ queries exceeding the budget are interrupted with the `RASqliteErrorInterrupt`
+ error code. The default value is zero, i.e. queries have no time budget.
+
+ @par
+ The budget applies to every statement executed by the library, including
+ each statement within scripts, and the statements for upsert, import,
+ export, and pagination.
+ */
+@property(atomic) NSTimeInterval queryTimeout;
+
+/**
+ Interrupt the query currently executing against the database.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ The method do not dispatch to the queue, i.e. it can be called from any thread
+ while a query is blocking the queue. If the interrupted query is modifying the
+ database within a transaction, the transaction is rolled back.
+ */
+- (void)interrupt;
+
+#pragma mark - Observation
+
+/**
+ Observe the changes to the table.
+
+ @param table Name of the table to observe.
+ @param queue Queue on which the handler is called.
+ @param handler Block receiving the changed rows, once for each committed transaction.
+
+ @return Opaque observer, used with `removeObserver:`.
+
+ @code
+ id observer = [rasqlite observeTable:@"user" queue:queue handler:^(RASqliteTableChange *change) {
+    // Reload the changed rows, i.e. `[change updatedRowids]`.
+ }];
+ @endcode
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ The changed rowids are collected with the update hook while the transaction is
+ active, and delivered as a single change after the commit have completed.
+ Changes within a rolled back transaction, or rolled back to a savepoint, e.g.
+ a failed chunk within `importStream:intoTable:format:`, are not delivered.
+
+ @par
+ SQLite do not report changes to tables without rowid, or rows removed with
+ `DELETE` without `WHERE`.
+ */
+- (id)observeTable:(NSString *)table queue:(dispatch_queue_t)queue handler:(RASqliteChangeHandler)handler;
+
+/**
+ Observe the changes to the table, with the handler called on the main queue.
+
+ @param table Name of the table to observe.
+ @param handler Block receiving the changed rows, once for each committed transaction.
+
+ @return Opaque observer, used with `removeObserver:`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (id)observeTable:(NSString *)table handler:(RASqliteChangeHandler)handler;
+
+/**
+ Remove the table observer.
+
+ @param observer Observer returned by `observeTable:queue:handler:`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ Once removed the handler is not called, even for changes that have already
+ been committed but not yet delivered.
+ */
+- (void)removeObserver:(id)observer;
+
+#pragma mark - Cache
+
+/**
+ Stores the memory limit, in bytes, for the result cache.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ The results for `fetch:` and `fetchRow:` are cached by query and parameters,
+ and invalidated once any of the tables read by the query is changed. The
+ least recently used results are evicted when the limit is reached. The
+ default value is zero, i.e. the cache is disabled.
+
+ @par
+ Results are only cached outside of transactions, and queries calling
+ functions that are not deterministic, e.g. `random()` or `datetime()`, are
+ never cached. The cached results are immutable and shared between callers.
+ */
+@property(atomic) NSUInteger resultCacheLimit;
+
+/**
+ Remove every cached result.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)removeAllCachedResults;
+
+#pragma mark - Function
+
+/**
+ Register a custom scalar SQL function.
+
+ @param name Name of the function.
+ @param arity Number of arguments, or -1 for any number of arguments.
+ @param deterministic Whether the function always returns the same result for the same arguments.
+ @param block Block implementing the function.
+
+ @return `YES` if the function have been registered, otherwise `NO`.
+
+ @code
+ [rasqlite registerFunction:@"distance" arity:2 deterministic:YES block:^id(RASqliteFunctionArguments *arguments) {
+    return @(fabs([arguments doubleAtIndex:0] - [arguments doubleAtIndex:1]));
+ }];
+ [rasqlite fetch:@"SELECT id FROM place WHERE distance(lat, ?) < 0.5" withParam:@59.3];
+ @endcode
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ The function is registered again every time the connection is opened, and an
+ existing function with the same name and arity is replaced. Deterministic
+ functions can be used within indexes and are evaluated once for constant
+ arguments, while results for queries calling functions that are not
+ deterministic are never cached.
+
+ @par
+ The block is executed on the database queue, i.e. it must not dispatch
+ synchronously to the queue from another thread.
+ */
+- (BOOL)registerFunction:(NSString *)name arity:(int)arity deterministic:(BOOL)deterministic block:(RASqliteFunctionBlock)block;
+
+/**
+ Register a custom aggregate SQL function.
+
+ @param name Name of the function.
+ @param arity Number of arguments, or -1 for any number of arguments.
+ @param deterministic Whether the function always returns the same result for the same arguments.
+ @param step Block called for every row within the group.
+ @param final Block calculating the result for the group.
+
+ @return `YES` if the function have been registered, otherwise `NO`.
+
+ @code
+ [rasqlite registerAggregate:@"median" arity:1 deterministic:YES step:^(NSMutableDictionary *context, RASqliteFunctionArguments *arguments) {
+    // Collect the value within the context.
+ } final:^id(NSMutableDictionary *context) {
+    // Calculate the median from the collected values.
+ }];
+ @endcode
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ Each group have its own context, which is released once the result have
+ been calculated.
+ */
+- (BOOL)registerAggregate:(NSString *)name arity:(int)arity deterministic:(BOOL)deterministic step:(RASqliteAggregateStepBlock)step final:(RASqliteAggregateFinalBlock)final;
+
+#pragma mark - Maintenance
+
+/**
+ Stores the interval, in seconds, between the scheduled maintenance passes.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ The passes are only performed while the query queue is idle and the
+ connection is open outside of a transaction. Each pass is limited in time
+ and yields to queued queries, remaining work is resumed with the next pass.
+ The default value is zero, i.e. no maintenance is scheduled.
+
+ @par
+ See `performMaintenance` for the work performed by each pass.
+ */
+@property(atomic) NSTimeInterval maintenanceInterval;
+
+/**
+ Perform a maintenance pass.
+
+ The pass performs, in order:
+ - `PRAGMA optimize`, once 1000 rows have changed since the last optimization,
+ - `PRAGMA incremental_vacuum` in steps, if `auto_vacuum` is incremental,
+ - `PRAGMA integrity_check` for one table, spreading the checks for every
+   table over a week.
+
+ @return `YES` if the pass have been performed, otherwise `NO`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ A failed integrity check is reported with the `RASqliteErrorIntegrity` code.
+ */
+- (BOOL)performMaintenance;
+
 #pragma mark - Query
 #pragma mark -- Fetch
 
+/**
+ Fetch a result set from the database, with parameters and cancellation token.
+
+ @param sql Query to perform against the database.
+ @param params Parameters to bind to the query.
+ @param token Token for cancelling the query, or `nil`.
+
+ @code
+ RASqliteCancellationToken *token = [RASqliteCancellationToken tokenWithTimeout:2.0];
+ NSArray *results = [self fetch:@"SELECT foo FROM bar WHERE baz = ?" withParams:@[@53] cancellationToken:token];
+ @endcode
+
+ @return Result from query, or `nil` if nothing was found or an error has occurred.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ If the token is cancelled, or its time budget expires, the query is
+ interrupted and fails with the `RASqliteErrorInterrupt` error code.
+ */
+- (NSArray *)fetch:(NSString *)sql withParams:(NSArray *)params cancellationToken:(RASqliteCancellationToken *)token;
+
 /**
  Fetch a result set from the database, with parameters.
 
@@ -290,6 +714,23 @@ NS_INLINE RASqliteColumn *RAColumn(NSString *name, RASqliteDataType type) {
  */
 - (NSDictionary *)fetchRow:(NSString *)sql withParams:(NSArray *)params;
 
+/**
+ Fetch a row from the database, with parameters and cancellation token.
+
+ @param sql Query to perform against the database.
+ @param params Parameters to bind to the query.
+ @param token Token for cancelling the query, or `nil`.
+
+ @return Row from query, or `nil` if nothing was found or an error has occurred.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ If the token is cancelled, or its time budget expires, the query is
+ interrupted and fails with the `RASqliteErrorInterrupt` error code.
+ */
+- (NSDictionary *)fetchRow:(NSString *)sql withParams:(NSArray *)params cancellationToken:(RASqliteCancellationToken *)token;
+
 /**
  Fetch a row from the database, with a parameter.
 
@@ -377,6 +818,23 @@ NS_INLINE RASqliteColumn *RAColumn(NSString *name, RASqliteDataType type) {
  */
 - (BOOL)execute:(NSString *)sql withParams:(NSArray *)params;
 
+/**
+ Execute update query, with parameters and cancellation token.
+
+ @param sql Query to perform against the database.
+ @param params Parameters to bind to the query.
+ @param token Token for cancelling the query, or `nil`.
+
+ @return `YES` if query was successfully executed, otherwise `NO`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ If the token is cancelled, or its time budget expires, the query is
+ interrupted and fails with the `RASqliteErrorInterrupt` error code.
+ */
+- (BOOL)execute:(NSString *)sql withParams:(NSArray *)params cancellationToken:(RASqliteCancellationToken *)token;
+
 /**
  Execute update query, with a parameter.
 
@@ -427,6 +885,96 @@ NS_INLINE RASqliteColumn *RAColumn(NSString *name, RASqliteDataType type) {
  */
 - (BOOL)execute:(NSString *)sql;
 
+#pragma mark -- Script
+
+/**
+ Execute every statement within the script.
+
+ @param script Script with statements separated by semicolons.
+ @param transaction `YES` if the statements should be executed within a single transaction.
+
+ @code
+ BOOL success = [db executeScript:@"INSERT INTO foo(bar) VALUES(1); INSERT INTO foo(bar) VALUES(2);" inTransaction:YES];
+ @endcode
+
+ @return `YES` if every statement was successfully executed, otherwise `NO`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ The statements are executed in order with a single dispatch to the queue, and
+ execution stops at the first failing statement. The error message includes
+ the byte offset of the failing statement within the script, the offset is
+ also available from the user info under the `RASqliteErrorOffsetKey`. Within a
+ transaction every statement is rolled back if one of them fails.
+
+ @par
+ If a transaction already is active, e.g. within `queueTransactionWithBlock:`,
+ the statements are executed within a savepoint instead, i.e. only the
+ statements from the script are rolled back.
+ */
+- (BOOL)executeScript:(NSString *)script inTransaction:(BOOL)transaction;
+
+/**
+ Execute every statement within the script, with cancellation token.
+
+ @param script Script with statements separated by semicolons.
+ @param transaction `YES` if the statements should be executed within a single transaction.
+ @param token Token for cancelling the script, or `nil`.
+
+ @return `YES` if every statement was successfully executed, otherwise `NO`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ Cancelling the token interrupts the executing statement and skips the
+ remaining statements, i.e. the script fails the same way as if a statement
+ failed.
+ */
+- (BOOL)executeScript:(NSString *)script inTransaction:(BOOL)transaction cancellationToken:(RASqliteCancellationToken *)token;
+
+/**
+ Execute every statement within the script, without transaction.
+
+ @param script Script with statements separated by semicolons.
+
+ @return `YES` if every statement was successfully executed, otherwise `NO`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (BOOL)executeScript:(NSString *)script;
+
+/**
+ Execute every statement within the script file.
+
+ @param path Path to the script file.
+ @param transaction `YES` if the statements should be executed within a single transaction.
+
+ @return `YES` if every statement was successfully executed, otherwise `NO`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ The file is read line by line and each statement is executed as soon as it is
+ complete, i.e. the script is never loaded into memory as a whole. The offset
+ within the error message, and under the `RASqliteErrorOffsetKey`, is relative
+ to the beginning of the file.
+ */
+- (BOOL)executeScriptAtPath:(NSString *)path inTransaction:(BOOL)transaction;
+
+/**
+ Execute every statement within the script file, with cancellation token.
+
+ @param path Path to the script file.
+ @param transaction `YES` if the statements should be executed within a single transaction.
+ @param token Token for cancelling the script, or `nil`.
+
+ @return `YES` if every statement was successfully executed, otherwise `NO`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (BOOL)executeScriptAtPath:(NSString *)path inTransaction:(BOOL)transaction cancellationToken:(RASqliteCancellationToken *)token;
+
 #pragma mark -- Queue
 
 /**
@@ -7,6 +7,9 @@
 //
 
 #import "RASqlite.h"
+#import "RASqlite+RASqliteStatement.h"
+
+#import <pthread.h>
 
 // -- -- Exception
 
@@ -28,9 +31,121 @@ static NSString *RASqliteNestedTransactionException = @"Nested transactions";
 // for the rest of the application. These are specific for RASqlite.
 #import "NSError+RASqlite.h"
 
+#import "RASqliteArrayModule.h"
 #import "RASqliteBinder.h"
+#import "RASqliteChangeTracker.h"
+#import "RASqliteFunction.h"
+#import "RASqliteHistogram.h"
+#import "RASqliteMaintenance.h"
 #import "RASqliteMapper.h"
+#import "RASqliteProfiler.h"
+#import "RASqliteQueryPlanAdvisor.h"
 #import "RASqliteQueue.h"
+#import "RASqliteResultCache.h"
+#import "RASqliteStatementCache.h"
+
+/// Maximum number of cached statements for each database.
+static const NSUInteger RASqliteStatementCacheCapacity = 32;
+
+/// Number of virtual machine instructions between the checks of the time budget.
+static const int RASqliteProgressInterval = 1000;
+
+/// Time budget, in seconds, for each maintenance pass.
+static const NSTimeInterval RASqliteMaintenanceBudget = 0.1;
+
+/// Size of the memory map for immutable databases, capped by SQLite to the maximum size for the platform.
+static const sqlite3_int64 RASqliteImmutableMapSize = 1LL << 30;
+
+/// Format for the key to the immutable connection within the thread dictionary.
+static NSString *const RASqliteImmutableThreadKeyFormat = @"me.raatiniemi.rasqlite.immutable.%@";
+
+/// Time budget for the query executing on the connection.
+typedef struct {
+    /// Monotonic timestamp for when the query should be interrupted, zero without budget.
+    uint64_t deadline;
+
+    /// Token for cancelling the query, retained by the caller during the query.
+    __unsafe_unretained RASqliteCancellationToken *token;
+} RASqliteBudget;
+
+/**
+ Progress handler checking whether the executing query should be interrupted.
+
+ @param context Time budget for the executing query.
+
+ @return Non-zero if the query should be interrupted, otherwise zero.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static int RASqliteProgressHandler(void *context) {
+    RASqliteBudget *budget = context;
+    if (budget->deadline > 0 && RASqliteTimestamp() >= budget->deadline) {
+        return 1;
+    }
+
+    return budget->token && [budget->token isCancelled];
+}
+
+/**
+ Retrieve the error code for the failed query.
+
+ @param code Result code from SQLite.
+
+ @return Error code for the failed query.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static RASqliteErrorCode RASqliteQueryErrorCode(int code) {
+    return code == SQLITE_INTERRUPT ? RASqliteErrorInterrupt : RASqliteErrorQuery;
+}
+
+/**
+ Step the statement, the change tracker is notified once the statement is done.
+
+ @param statement Statement to step.
+ @param changes Change tracker for the connection.
+
+ @return Result code from the step.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static inline int RASqliteStep(sqlite3_stmt *statement, RASqliteChangeTracker *changes) {
+    int code = sqlite3_step(statement);
+    if (code != SQLITE_ROW) {
+        [changes didFinishStatement:sqlite3_sql(statement) result:code];
+    }
+
+    return code;
+}
+
+/**
+ Build the key for the cached result.
+
+ @param row Whether the result is a single row.
+ @param sql Query for the result.
+ @param params Parameters bound to the query.
+
+ @return Key for the result.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ The parameters are copied, i.e. mutating the array passed by the caller does
+ not change the key for the stored result. Numbers are paired with their type,
+ since `@1`, `@1.0`, and `@YES` are equal but bound as different values.
+ */
+static NSArray *RASqliteResultCacheKey(BOOL row, NSString *sql, NSArray *params) {
+    NSMutableArray *values = [[NSMutableArray alloc] initWithCapacity:[params count]];
+    for (id value in params) {
+        if ([value isKindOfClass:[NSNumber class]]) {
+            [values addObject:@[value, @([value objCType])]];
+        } else {
+            [values addObject:value];
+        }
+    }
+
+    return @[@(row), sql, values];
+}
 
 /**
  RASqlite is a simple library for working with SQLite databases on iOS and Mac OS X.
@@ -41,8 +156,30 @@ static NSString *RASqliteNestedTransactionException = @"Nested transactions";
 @private
     sqlite3 *_database;
 
+    /// Guards the connection handle while it is opened or closed, since the
+    /// handle is interrupted from outside of the query queue.
+    pthread_mutex_t _databaseLock;
+
     RASqliteQueue *_queue;
 
+    RASqliteQueryPlanAdvisor *_advisor;
+
+    RASqliteBudget _budget;
+
+    RASqliteStatementCache *_statements;
+
+    RASqliteChangeTracker *_changes;
+
+    RASqliteResultCache *_results;
+
+    /// Tables written by the cached statements, keyed by query.
+    NSMutableDictionary *_writes;
+
+    NSMutableDictionary *_functions;
+
+    RASqliteMaintenance *_maintenance;
+    NSTimeInterval _maintenanceInterval;
+
     NSString *_path;
 }
 
@@ -52,6 +189,9 @@ static NSString *RASqliteNestedTransactionException = @"Nested transactions";
 /// Number of attempts before the retry timeout is reached.
 @property(atomic) NSUInteger maxNumberOfRetriesBeforeTimeout;
 
+/// Stores the profiler, `nil` unless the profiling is enabled.
+@property(strong, atomic) RASqliteProfiler *profiler;
+
 #pragma mark - Path
 
 /**
@@ -80,8 +220,135 @@ static NSString *RASqliteNestedTransactionException = @"Nested transactions";
  */
 - (BOOL)isConnectionOpenOrCanBeOpened;
 
+/**
+ Configure the newly opened database connection.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ Registers the connection specific hooks, e.g. the profile trace.
+ */
+- (void)configureConnection;
+
+#pragma mark - Diagnostics
+
+/**
+ Record the query call for the profiling.
+
+ @param sql Query that have been called.
+ @param rows Number of rows returned by the query.
+ @param start Timestamp from before the query was dispatched to the queue.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)profileQuery:(NSString *)sql rows:(NSUInteger)rows since:(uint64_t)start;
+
+#pragma mark - Cancellation
+
+/**
+ Begin the time budget for the query.
+
+ @param token Token for cancelling the query, or `nil`.
+
+ @return The previous time budget, have to be restored with `endBudget:`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ Queries executed within another query call, e.g. within `queueWithBlock:`,
+ keep the earliest deadline of the two.
+ */
+- (RASqliteBudget)beginBudgetWithToken:(RASqliteCancellationToken *)token;
+
+/**
+ End the time budget for the query, and restore the previous.
+
+ @param budget The previous time budget.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)endBudget:(RASqliteBudget)budget;
+
+/**
+ Check whether the query have been cancelled before it started executing.
+
+ @param token Token for cancelling the query, or `nil`.
+
+ @return `YES` if the query have been cancelled, otherwise `NO`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (BOOL)isCancelledWithToken:(RASqliteCancellationToken *)token;
+
+#pragma mark - Function
+
+/**
+ Add the function, and register it if the connection is open.
+
+ @param function Function to add.
+
+ @return `YES` if the function have been added, otherwise `NO`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (BOOL)addFunction:(RASqliteFunction *)function;
+
+#pragma mark - Maintenance
+
+/**
+ Perform a scheduled maintenance pass, if the connection is open outside of a transaction.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)performScheduledMaintenance;
+
+/**
+ Perform a maintenance pass within the time budget, on the query queue.
+
+ @return An error if one occurred, otherwise `nil`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (NSError *)maintainDatabase;
+
 #pragma mark - Query
 
+/**
+ Prepare the statement for the query.
+
+ @param statement Statement to be prepared.
+ @param sql Query to prepare the statement for.
+
+ @return `YES` if the statement was prepared, otherwise `NO`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ If the query plan advisor is enabled, the query plan is analyzed the first
+ time the query is prepared.
+ */
+- (BOOL)prepareStatement:(sqlite3_stmt **)statement withQuery:(NSString *)sql;
+
+/**
+ Prepare the first statement from the SQL bytes.
+
+ @param statement Reference to the statement, `NULL` if the SQL only contain
+ whitespace or comments.
+ @param sql SQL bytes to prepare the statement from.
+ @param tail Reference to the beginning of the next statement, or `NULL`.
+ @param query Query for the profiler and the advisor, if `nil` the SQL of the
+ prepared statement is used.
+
+ @return Result code from the prepare.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ Every statement is prepared through here, i.e. both queries and the
+ statements within scripts are profiled and analyzed by the advisor.
+ */
+- (int)prepareStatement:(sqlite3_stmt **)statement withBytes:(const char *)sql tail:(const char **)tail query:(NSString *)query;
+
 /**
  Bind the parameters to the statement.
 
@@ -94,6 +361,60 @@ static NSString *RASqliteNestedTransactionException = @"Nested transactions";
  */
 - (BOOL)bindParameters:(NSArray *)parameters toStatement:(sqlite3_stmt **)statement;
 
+/**
+ Prepare the statement for the statement cache, collecting the written tables.
+
+ @param statement Statement to be prepared.
+ @param sql Query to prepare the statement for.
+
+ @return `YES` if the statement was prepared, otherwise `NO`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (BOOL)prepareCachedStatement:(sqlite3_stmt **)statement withQuery:(NSString *)sql;
+
+/**
+ Invalidate the cached results for the tables written by the cached statement.
+
+ @param statement Statement that have been executed.
+ @param sql Query for the statement.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ The authorizer is only called when the statement is prepared, i.e. reused
+ statements would otherwise not invalidate results for tables without rowid
+ or rows removed by the truncate optimization.
+ */
+- (void)invalidateResultsForStatement:(sqlite3_stmt *)statement withQuery:(NSString *)sql;
+
+#pragma mark -- Script
+
+/**
+ Execute the statements, on the query queue.
+
+ @param sql Statements to execute, separated by semicolons.
+ @param offset Offset of the statements within the script, used for the error message.
+ @param token Token for cancelling the statements, or `nil`.
+
+ @return `YES` if every statement was successfully executed, otherwise `NO`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (BOOL)executeStatements:(const char *)sql offset:(NSUInteger)offset cancellationToken:(RASqliteCancellationToken *)token;
+
+/**
+ Execute the script block on the query queue, optionally within a transaction.
+
+ @param block Block executing the statements, returns `NO` on failure.
+ @param transaction `YES` if the block should be executed within a transaction.
+
+ @return `YES` if the block was successfully executed, and committed, otherwise `NO`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (BOOL)queueScriptWithBlock:(BOOL (^)(void))block inTransaction:(BOOL)transaction;
+
 #pragma mark -- Transaction
 
 /**
@@ -177,6 +498,11 @@ static NSString *RASqliteNestedTransactionException = @"Nested transactions";
         [self setPath:path];
 
         _queue = [RASqliteQueue sharedQueue];
+        _statements = [[RASqliteStatementCache alloc] initWithCapacity:RASqliteStatementCacheCapacity];
+        _writes = [[NSMutableDictionary alloc] init];
+        pthread_mutex_init(&_databaseLock, NULL);
+        _changes = [[RASqliteChangeTracker alloc] init];
+        _functions = [[NSMutableDictionary alloc] init];
 
         // Set the number of retry attempts before a timeout is triggered.
         self.maxNumberOfRetriesBeforeTimeout = 0;
@@ -190,6 +516,68 @@ static NSString *RASqliteNestedTransactionException = @"Nested transactions";
     return [self initWithPath:RASqliteSF(@"%@/%@", directories[0], name)];
 }
 
+- (instancetype)initWithImmutablePath:(NSString *)path {
+    if (self = [super init]) {
+        // The file is only read, i.e. the directory do not have to be
+        // created or writeable.
+        if (path == nil) {
+            [NSException raise:NSInvalidArgumentException
+                        format:@"The supplied path can not be `nil`."];
+        }
+        [self setPath:path];
+
+        _immutable = YES;
+
+        // The connection is confined to a single thread, i.e. the blocks do
+        // not have to be serialized with other connections.
+        _queue = [RASqliteQueue directQueue];
+        _statements = [[RASqliteStatementCache alloc] initWithCapacity:RASqliteStatementCacheCapacity];
+        _writes = [[NSMutableDictionary alloc] init];
+        pthread_mutex_init(&_databaseLock, NULL);
+        _changes = [[RASqliteChangeTracker alloc] init];
+        _functions = [[NSMutableDictionary alloc] init];
+
+        self.maxNumberOfRetriesBeforeTimeout = 0;
+    }
+    return self;
+}
+
++ (instancetype)immutableDatabaseWithPath:(NSString *)path {
+    NSMutableDictionary *dictionary = [[NSThread currentThread] threadDictionary];
+    NSString *key = RASqliteSF(RASqliteImmutableThreadKeyFormat, path);
+
+    RASqlite *database = dictionary[key];
+    if (!database) {
+        database = [[self alloc] initWithImmutablePath:path];
+        dictionary[key] = database;
+    }
+
+    return database;
+}
+
++ (void)closeImmutableDatabaseWithPath:(NSString *)path {
+    NSMutableDictionary *dictionary = [[NSThread currentThread] threadDictionary];
+    NSString *key = RASqliteSF(RASqliteImmutableThreadKeyFormat, path);
+
+    // The connection is closed explicitly, since the instance might still be
+    // referenced by the caller.
+    RASqlite *database = dictionary[key];
+    [database close];
+    [dictionary removeObjectForKey:key];
+}
+
+- (void)dealloc {
+    // Nothing else can reference the instance, i.e. the connection can be
+    // closed without the queue, e.g. when the thread for an immutable
+    // connection exits.
+    if (_database) {
+        [_statements removeAllStatements];
+        [_results detachFromDatabase:_database];
+        sqlite3_close(_database);
+    }
+    pthread_mutex_destroy(&_databaseLock);
+}
+
 #pragma mark - Path
 
 - (BOOL)checkPath:(NSString *)path {
@@ -251,18 +639,36 @@ static NSString *RASqliteNestedTransactionException = @"Nested transactions";
             return;
         }
 
+        // Immutable databases are opened via URI, the parameters tell SQLite
+        // that the file can not change, i.e. no locking or journal checks.
+        NSString *filename = [self path];
+        int openFlags = flags;
+        if (_immutable) {
+            NSCharacterSet *allowed = [NSCharacterSet URLPathAllowedCharacterSet];
+            filename = RASqliteSF(@"file:%@?mode=ro&immutable=1", [filename stringByAddingPercentEncodingWithAllowedCharacters:allowed]);
+            openFlags = SQLITE_OPEN_READONLY | SQLITE_OPEN_URI | SQLITE_OPEN_NOMUTEX;
+        }
+
         // Attempt to open the database.
-        int code = sqlite3_open_v2([[self path] UTF8String], &_database, flags, NULL);
+        sqlite3 *database;
+        int code = sqlite3_open_v2([filename UTF8String], &database, openFlags, NULL);
         if (code == SQLITE_OK) {
+            pthread_mutex_lock(&_databaseLock);
+            _database = database;
+            pthread_mutex_unlock(&_databaseLock);
+
             // The database was successfully opened.
             RASqliteInfoLog(@"Database `%@` have successfully been opened.", [[self path] lastPathComponent]);
+            [self configureConnection];
             return;
         }
 
-        // Something went wrong...
-        const char *errmsg = sqlite3_errmsg(_database);
+        // Something went wrong, the handle is allocated even if the open
+        // failed and have to be closed.
+        const char *errmsg = sqlite3_errmsg(database);
         NSString *message = RASqliteSF(@"Unable to open database: %s", errmsg);
         RASqliteErrorLog(@"%@", message);
+        sqlite3_close(database);
 
         error = [NSError code:RASqliteErrorOpen message:message];
         [self setError:error];
@@ -279,7 +685,7 @@ static NSString *RASqliteNestedTransactionException = @"Nested transactions";
     NSError __block *error;
 
     [_queue dispatchBlock:^{
-        if (_database) {
+        if (!_database) {
             RASqliteDebugLog(@"Database is already closed.");
             return;
         }
@@ -292,6 +698,11 @@ static NSString *RASqliteNestedTransactionException = @"Nested transactions";
             return;
         }
 
+        // The connection can not be closed while statements are prepared.
+        [_statements removeAllStatements];
+        [_writes removeAllObjects];
+        [_results detachFromDatabase:_database];
+
         int code;
 
         // Checks of number of attempts, will prevent infinite loops.
@@ -300,9 +711,15 @@ static NSString *RASqliteNestedTransactionException = @"Nested transactions";
         // Repeat the close process until the database is closed, an error
         // occurs, or the retry attempts have been depleted.
         do {
+            // The interrupt is not allowed while the connection is closing.
+            pthread_mutex_lock(&_databaseLock);
             code = sqlite3_close(_database);
             if (SQLITE_OK == code) {
                 _database = nil;
+            }
+            pthread_mutex_unlock(&_databaseLock);
+
+            if (SQLITE_OK == code) {
                 RASqliteInfoLog(@"Database `%@` have successfully been closed.", [[self path] lastPathComponent]);
                 return;
             }
@@ -342,62 +759,545 @@ static NSString *RASqliteNestedTransactionException = @"Nested transactions";
     return _database || [self open];
 }
 
-#pragma mark - Query
+- (void)configureConnection {
+    [[self profiler] attachToDatabase:_database];
 
-- (BOOL)bindParameters:(NSArray *)parameters toStatement:(sqlite3_stmt **)statement {
-    NSError *error = [RASqliteBinder bindParameters:parameters toStatement:statement];
-    if (error) {
-        [self setError:error];
+    // The pages for immutable databases are read directly from the mapping,
+    // instead of being copied into the page cache.
+    if (_immutable) {
+        NSString *pragma = RASqliteSF(@"PRAGMA mmap_size = %lld", RASqliteImmutableMapSize);
+        if (sqlite3_exec(_database, [pragma UTF8String], NULL, NULL, NULL) != SQLITE_OK) {
+            RASqliteWarningLog(@"Unable to memory-map database: %s", sqlite3_errmsg(_database));
+        }
     }
 
-    return error == nil;
-}
+    // The handler is only checking the budget, unless a budget is active the
+    // overhead is negligible.
+    sqlite3_progress_handler(_database, RASqliteProgressInterval, RASqliteProgressHandler, &_budget);
 
-#pragma mark -- Fetch
+    // Changes are only collected for observed tables.
+    [_changes attachToDatabase:_database];
+    [_results attachToDatabase:_database];
 
-- (NSArray *)fetch:(NSString *)sql withParams:(NSArray *)params {
-    NSMutableArray __block *results;
+    // Custom functions do not persist between connections.
+    for (RASqliteFunction *function in [_functions allValues]) {
+        int code = [function registerWithDatabase:_database];
+        if (code != SQLITE_OK) {
+            RASqliteErrorLog(@"Unable to register function `%@`: %s", [function name], sqlite3_errstr(code));
+        }
+    }
+
+    // The table-valued function for bound arrays is available on every connection.
+    int code = [RASqliteArrayModule registerWithDatabase:_database];
+    if (code != SQLITE_OK) {
+        RASqliteErrorLog(@"Unable to register function `rasqlite_array`: %s", sqlite3_errstr(code));
+    }
+}
 
+#pragma mark - Diagnostics
+
+- (void)setQueryPlanAdvisorEnabled:(BOOL)enabled {
     [_queue dispatchBlock:^{
-        if (!self.isConnectionOpenOrCanBeOpened) {
+        if (!enabled) {
+            _advisor = nil;
             return;
         }
 
-        NSError __block *error;
+        if (!_advisor) {
+            _advisor = [[RASqliteQueryPlanAdvisor alloc] init];
+        }
+    }];
+}
 
-        sqlite3_stmt *statement;
-        int code = sqlite3_prepare_v2(_database, [sql UTF8String], -1, &statement, NULL);
+- (BOOL)isQueryPlanAdvisorEnabled {
+    BOOL __block enabled = NO;
 
-        if (code != SQLITE_OK) {
-            // Something went wrong...
-            const char *errmsg = sqlite3_errmsg(_database);
-            NSString *message = RASqliteSF(@"Failed to prepare statement `%@`: %s", sql, errmsg);
-            RASqliteErrorLog(@"%@", message);
+    [_queue dispatchBlock:^{
+        enabled = _advisor != nil;
+    }];
 
-            error = [NSError code:RASqliteErrorQuery message:message];
-            [self setError:error];
-            sqlite3_finalize(statement);
+    return enabled;
+}
+
+- (NSArray *)queryPlanReport {
+    NSArray __block *report;
+
+    [_queue dispatchBlock:^{
+        report = [_advisor report];
+    }];
+
+    return report;
+}
+
+- (void)setProfilingEnabled:(BOOL)enabled {
+    [_queue dispatchBlock:^{
+        RASqliteProfiler *profiler = [self profiler];
+        if (enabled == (profiler != nil)) {
             return;
         }
 
-        // If we have parameters, we need to bind them to the statement.
-        if (params) {
-            [self bindParameters:params toStatement:&statement];
+        if (enabled) {
+            profiler = [[RASqliteProfiler alloc] init];
+            [self setProfiler:profiler];
+
+            if (_database) {
+                [profiler attachToDatabase:_database];
+            }
+            return;
         }
 
-        // Get the pointer for the method, performance improvement.
-        SEL selector = @selector(fetchColumns:);
+        // The trace have to be removed before the profiler is released,
+        // since the trace is referencing the profiler.
+        if (_database) {
+            [profiler detachFromDatabase:_database];
+        }
+        [self setProfiler:nil];
+    }];
+}
 
-        typedef NSDictionary *(*fetch)(id, SEL, sqlite3_stmt **);
-        fetch fetchColumns = (fetch) [[RASqliteMapper class] methodForSelector:selector];
+- (BOOL)isProfilingEnabled {
+    return [self profiler] != nil;
+}
 
-        NSDictionary *row;
-        results = [[NSMutableArray alloc] init];
+- (NSDictionary *)profileSnapshot {
+    return [[self profiler] snapshot];
+}
+
+- (NSDictionary *)queueStatistics {
+    return [_queue statistics];
+}
+
+- (void)profileQuery:(NSString *)sql rows:(NSUInteger)rows since:(uint64_t)start {
+    RASqliteProfiler *profiler = [self profiler];
+    if (!profiler) {
+        return;
+    }
+
+    uint64_t latency = RASqliteTimestamp() - start;
+    [profiler recordQuery:sql rows:rows latency:latency];
+
+    NSTimeInterval threshold = [self slowQueryThreshold];
+    if (threshold > 0 && latency >= threshold * 1000000000.0) {
+        RASqliteWarningLog(@"Slow query took %.3f ms: %@", latency / 1000000.0, sql);
+    }
+}
+
+#pragma mark - Cancellation
+
+- (void)interrupt {
+    // The interrupt is safe to call from any thread, as long as the
+    // connection is open, i.e. the connection can not be closed meanwhile.
+    pthread_mutex_lock(&_databaseLock);
+    if (_database) {
+        sqlite3_interrupt(_database);
+    }
+    pthread_mutex_unlock(&_databaseLock);
+}
+
+- (RASqliteBudget)beginBudgetWithToken:(RASqliteCancellationToken *)token {
+    RASqliteBudget previous = _budget;
+
+    NSTimeInterval timeout = [self queryTimeout];
+    if (timeout > 0) {
+        uint64_t deadline = RASqliteTimestamp() + (uint64_t) (timeout * 1000000000.0);
+        if (!_budget.deadline || deadline < _budget.deadline) {
+            _budget.deadline = deadline;
+        }
+    }
+
+    if (token) {
+        _budget.token = token;
+    }
+
+    return previous;
+}
+
+- (void)endBudget:(RASqliteBudget)budget {
+    _budget = budget;
+}
+
+- (BOOL)isCancelledWithToken:(RASqliteCancellationToken *)token {
+    if (![token isCancelled]) {
+        return NO;
+    }
+
+    NSString *message = @"Query have been cancelled before execution.";
+    RASqliteInfoLog(@"%@", message);
+
+    NSError *error = [NSError code:RASqliteErrorInterrupt message:message];
+    [self setError:error];
+    return YES;
+}
+
+#pragma mark - Observation
+
+- (id)observeTable:(NSString *)table queue:(dispatch_queue_t)queue handler:(RASqliteChangeHandler)handler {
+    if (!table || !queue || !handler) {
+        [NSException raise:NSInvalidArgumentException
+                    format:@"Unable to observe table without name, queue, and handler."];
+    }
+
+    return [_changes addObserverForTable:table queue:queue handler:handler];
+}
+
+- (id)observeTable:(NSString *)table handler:(RASqliteChangeHandler)handler {
+    return [self observeTable:table queue:dispatch_get_main_queue() handler:handler];
+}
+
+- (void)removeObserver:(id)observer {
+    [_changes removeObserver:observer];
+}
+
+#pragma mark - Cache
+
+- (void)setResultCacheLimit:(NSUInteger)limit {
+    [_queue dispatchBlock:^{
+        if (limit == 0) {
+            if (_database) {
+                [_results detachFromDatabase:_database];
+            }
+            _results = nil;
+            [_changes setUpdateHandler:nil];
+            return;
+        }
+
+        if (_results) {
+            [_results setLimit:limit];
+            return;
+        }
+
+        RASqliteResultCache *results = [[RASqliteResultCache alloc] initWithLimit:limit];
+        for (RASqliteFunction *function in [_functions allValues]) {
+            if (![function isDeterministic]) {
+                [results addVolatileFunction:[function name]];
+            }
+        }
+
+        if (_database) {
+            [results attachToDatabase:_database];
+        }
+
+        // Every changed row invalidates the results depending on its table.
+        [_changes setUpdateHandler:^(const char *table) {
+            [results invalidateTable:table];
+        }];
+        _results = results;
+    }];
+}
+
+- (NSUInteger)resultCacheLimit {
+    NSUInteger __block limit = 0;
+
+    [_queue dispatchBlock:^{
+        limit = [_results limit];
+    }];
+
+    return limit;
+}
+
+- (void)removeAllCachedResults {
+    [_queue dispatchBlock:^{
+        [_results removeAllResults];
+    }];
+}
+
+#pragma mark - Function
+
+- (BOOL)addFunction:(RASqliteFunction *)function {
+    NSError __block *error;
+
+    [_queue dispatchBlock:^{
+        _functions[[function key]] = function;
+
+        // Results for functions that are not deterministic can not be cached.
+        if (![function isDeterministic]) {
+            [_results addVolatileFunction:[function name]];
+        }
+
+        // Without an open connection the function is registered once the
+        // connection is opened.
+        if (!_database) {
+            return;
+        }
+
+        int code = [function registerWithDatabase:_database];
+        if (code == SQLITE_OK) {
+            return;
+        }
+
+        const char *errmsg = sqlite3_errmsg(_database);
+        NSString *message = RASqliteSF(@"Unable to register function `%@`: %s", [function name], errmsg);
+        RASqliteErrorLog(@"%@", message);
+
+        [_functions removeObjectForKey:[function key]];
+
+        error = [NSError code:RASqliteErrorQuery message:message];
+        [self setError:error];
+    }];
+
+    return error == nil;
+}
+
+- (BOOL)registerFunction:(NSString *)name arity:(int)arity deterministic:(BOOL)deterministic block:(RASqliteFunctionBlock)block {
+    if (!name || !block) {
+        [NSException raise:NSInvalidArgumentException
+                    format:@"Unable to register function without name and block."];
+    }
+
+    RASqliteFunction *function = [[RASqliteFunction alloc] initWithName:name
+                                                                  arity:arity
+                                                          deterministic:deterministic
+                                                                  block:block];
+    return [self addFunction:function];
+}
+
+- (BOOL)registerAggregate:(NSString *)name arity:(int)arity deterministic:(BOOL)deterministic step:(RASqliteAggregateStepBlock)step final:(RASqliteAggregateFinalBlock)final {
+    if (!name || !step || !final) {
+        [NSException raise:NSInvalidArgumentException
+                    format:@"Unable to register aggregate without name, step, and final block."];
+    }
+
+    RASqliteFunction *function = [[RASqliteFunction alloc] initWithName:name
+                                                                  arity:arity
+                                                          deterministic:deterministic
+                                                                   step:step
+                                                                  final:final];
+    return [self addFunction:function];
+}
+
+#pragma mark - Maintenance
+
+- (void)setMaintenanceInterval:(NSTimeInterval)interval {
+    // The passes are performed on a background thread, while the immutable
+    // connection is confined to a single thread.
+    if (_immutable) {
+        RASqliteWarningLog(@"Maintenance can not be scheduled for immutable database.");
+        return;
+    }
+
+    [_queue dispatchBlock:^{
+        _maintenanceInterval = interval;
+        if (interval <= 0) {
+            [_maintenance cancel];
+            return;
+        }
+
+        if (!_maintenance) {
+            _maintenance = [[RASqliteMaintenance alloc] initWithQueue:_queue];
+        }
+
+        RASqlite __weak *weakSelf = self;
+        [_maintenance scheduleWithInterval:interval handler:^{
+            [weakSelf performScheduledMaintenance];
+        }];
+    }];
+}
+
+- (NSTimeInterval)maintenanceInterval {
+    NSTimeInterval __block interval = 0;
+
+    [_queue dispatchBlock:^{
+        interval = _maintenanceInterval;
+    }];
+
+    return interval;
+}
+
+- (BOOL)performMaintenance {
+    NSError __block *error;
+
+    [_queue dispatchBlock:^{
+        if (!self.isConnectionOpenOrCanBeOpened) {
+            error = [self error];
+            return;
+        }
+
+        if (!sqlite3_get_autocommit(_database)) {
+            NSString *message = @"Maintenance can not be performed within a transaction.";
+            RASqliteErrorLog(@"%@", message);
+
+            error = [NSError code:RASqliteErrorTransaction message:message];
+            [self setError:error];
+            return;
+        }
+
+        if (!_maintenance) {
+            _maintenance = [[RASqliteMaintenance alloc] initWithQueue:_queue];
+        }
+
+        error = [self maintainDatabase];
+        if (error) {
+            [self setError:error];
+        }
+    }];
+
+    return error == nil;
+}
+
+- (void)performScheduledMaintenance {
+    [_queue dispatchBlock:^{
+        // Scheduled maintenance do not open the connection, or interfere
+        // with active transactions.
+        if (!_database || !sqlite3_get_autocommit(_database)) {
+            return;
+        }
+
+        [self maintainDatabase];
+    }];
+}
+
+- (NSError *)maintainDatabase {
+    RASqliteBudget budget = _budget;
+
+    // The progress handler interrupts statements exceeding the budget.
+    _budget.deadline = RASqliteTimestamp() + (uint64_t) (RASqliteMaintenanceBudget * 1000000000.0);
+    NSError *error = [_maintenance performOnDatabase:_database deadline:_budget.deadline];
+
+    [self endBudget:budget];
+
+    return error;
+}
+
+#pragma mark - Query
+
+- (int)prepareStatement:(sqlite3_stmt **)statement withBytes:(const char *)sql tail:(const char **)tail query:(NSString *)query {
+    RASqliteProfiler *profiler = [self profiler];
+    uint64_t start = profiler ? RASqliteTimestamp() : 0;
+
+    int code = sqlite3_prepare_v2(_database, sql, -1, statement, tail);
+    if (code != SQLITE_OK || !*statement) {
+        return code;
+    }
+
+    if (!query && (profiler || _advisor)) {
+        query = @(sqlite3_sql(*statement));
+    }
+
+    if (profiler) {
+        [profiler recordPrepare:RASqliteTimestamp() - start forQuery:query];
+    }
+
+    if (_advisor) {
+        [_advisor analyzeQuery:query forDatabase:_database];
+    }
+
+    return code;
+}
+
+- (BOOL)prepareStatement:(sqlite3_stmt **)statement withQuery:(NSString *)sql {
+    int code = [self prepareStatement:statement withBytes:[sql UTF8String] tail:NULL query:sql];
+    if (code != SQLITE_OK) {
+        // Something went wrong...
+        const char *errmsg = sqlite3_errmsg(_database);
+        NSString *message = RASqliteSF(@"Failed to prepare statement `%@`: %s", sql, errmsg);
+        RASqliteErrorLog(@"%@", message);
+
+        NSError *error = [NSError code:RASqliteErrorQuery message:message];
+        [self setError:error];
+        sqlite3_finalize(*statement);
+        return NO;
+    }
+
+    return YES;
+}
+
+- (BOOL)bindParameters:(NSArray *)parameters toStatement:(sqlite3_stmt **)statement {
+    NSError *error = [RASqliteBinder bindParameters:parameters toStatement:statement];
+    if (error) {
+        [self setError:error];
+    }
+
+    return error == nil;
+}
+
+- (BOOL)prepareCachedStatement:(sqlite3_stmt **)statement withQuery:(NSString *)sql {
+    if (!_results) {
+        return [self prepareStatement:statement withQuery:sql];
+    }
+
+    [_results beginCollectingWrites];
+    BOOL prepared = [self prepareStatement:statement withQuery:sql];
+    NSSet *tables = [_results endCollectingWrites];
+
+    if (prepared) {
+        _writes[sql] = tables;
+    }
+
+    return prepared;
+}
+
+- (void)invalidateResultsForStatement:(sqlite3_stmt *)statement withQuery:(NSString *)sql {
+    if (!_results || sqlite3_stmt_readonly(statement)) {
+        return;
+    }
+
+    // Statements prepared before the result cache was enabled do not have
+    // their written tables collected.
+    NSSet *tables = _writes[sql];
+    if (!tables) {
+        [_results removeAllResults];
+        return;
+    }
+
+    [_results invalidateTables:tables];
+}
+
+#pragma mark -- Fetch
+
+- (NSArray *)fetch:(NSString *)sql withParams:(NSArray *)params cancellationToken:(RASqliteCancellationToken *)token {
+    NSMutableArray __block *results;
+    NSArray __block *cached;
+    uint64_t start = RASqliteTimestamp();
+
+    [_queue dispatchBlock:^{
+        if (!self.isConnectionOpenOrCanBeOpened || [self isCancelledWithToken:token]) {
+            return;
+        }
+
+        NSError __block *error;
+
+        NSArray *key;
+        if (_results) {
+            key = RASqliteResultCacheKey(NO, sql, params);
+            cached = [_results resultForKey:key];
+            if (cached) {
+                return;
+            }
+
+            [_results beginCollecting];
+        }
+
+        sqlite3_stmt *statement;
+        BOOL prepared = [self prepareStatement:&statement withQuery:sql];
+
+        NSSet *tables;
+        BOOL cacheable = _results && [_results endCollecting:&tables];
+        if (!prepared) {
+            return;
+        }
+
+        int code;
+
+        // If we have parameters, we need to bind them to the statement.
+        if (params) {
+            [self bindParameters:params toStatement:&statement];
+        }
+
+        // Get the pointer for the method, performance improvement.
+        SEL selector = @selector(fetchColumns:);
+
+        typedef NSDictionary *(*fetch)(id, SEL, sqlite3_stmt **);
+        fetch fetchColumns = (fetch) [[RASqliteMapper class] methodForSelector:selector];
+
+        NSDictionary *row;
+        results = [[NSMutableArray alloc] init];
+
+        RASqliteBudget budget = [self beginBudgetWithToken:token];
 
         // Looping through the results, until an error occurs or
         // the query is done.
         do {
-            code = sqlite3_step(statement);
+            code = RASqliteStep(statement, _changes);
             if (code == SQLITE_DONE) {
                 break;
             }
@@ -414,19 +1314,37 @@ static NSString *RASqliteNestedTransactionException = @"Nested transactions";
             NSString *message = RASqliteSF(@"Unable to fetch row: %s", errmsg);
             RASqliteErrorLog(@"%@", message);
 
-            error = [NSError code:RASqliteErrorQuery message:message];
+            error = [NSError code:RASqliteQueryErrorCode(code) message:message];
             [self setError:error];
 
             // Since an error has occurred we need to reset the results.
             results = nil;
-        } while (NO);
+        } while (code == SQLITE_ROW);
 
+        // Results within a transaction might be rolled back, i.e. only
+        // results outside of transactions can be cached.
+        if (results && cacheable && sqlite3_stmt_readonly(statement) && sqlite3_get_autocommit(_database)) {
+            [_results storeResult:[[NSArray alloc] initWithArray:results copyItems:YES] forKey:key tables:tables];
+        }
+
+        [self endBudget:budget];
         sqlite3_finalize(statement);
     }];
 
+    if (cached) {
+        [self profileQuery:sql rows:[cached count] since:start];
+        return cached;
+    }
+
+    [self profileQuery:sql rows:[results count] since:start];
+
     return results;
 }
 
+- (NSArray *)fetch:(NSString *)sql withParams:(NSArray *)params {
+    return [self fetch:sql withParams:params cancellationToken:nil];
+}
+
 - (NSArray *)fetch:(NSString *)sql withParam:(id)param {
     return [self fetch:sql withParams:@[param]];
 }
@@ -435,38 +1353,51 @@ static NSString *RASqliteNestedTransactionException = @"Nested transactions";
     return [self fetch:sql withParams:nil];
 }
 
-- (NSDictionary *)fetchRow:(NSString *)sql withParams:(NSArray *)params {
+- (NSDictionary *)fetchRow:(NSString *)sql withParams:(NSArray *)params cancellationToken:(RASqliteCancellationToken *)token {
     NSDictionary __block *row;
+    uint64_t start = RASqliteTimestamp();
 
     [_queue dispatchBlock:^{
-        if (!self.isConnectionOpenOrCanBeOpened) {
+        if (!self.isConnectionOpenOrCanBeOpened || [self isCancelledWithToken:token]) {
             return;
         }
 
         NSError *error;
 
-        sqlite3_stmt *statement;
-        int code = sqlite3_prepare_v2(_database, [sql UTF8String], -1, &statement, NULL);
+        NSArray *key;
+        if (_results) {
+            key = RASqliteResultCacheKey(YES, sql, params);
 
-        if (code != SQLITE_OK) {
-            // Something went wrong...
-            const char *errmsg = sqlite3_errmsg(_database);
-            NSString *message = RASqliteSF(@"Failed to prepare statement `%@`: %s", sql, errmsg);
-            RASqliteErrorLog(@"%@", message);
+            // Queries without any row are cached as `NSNull`.
+            id result = [_results resultForKey:key];
+            if (result) {
+                row = result == [NSNull null] ? nil : result;
+                return;
+            }
 
-            error = [NSError code:RASqliteErrorQuery message:message];
-            [self setError:error];
-            sqlite3_finalize(statement);
+            [_results beginCollecting];
+        }
+
+        sqlite3_stmt *statement;
+        BOOL prepared = [self prepareStatement:&statement withQuery:sql];
+
+        NSSet *tables;
+        BOOL cacheable = _results && [_results endCollecting:&tables];
+        if (!prepared) {
             return;
         }
 
+        int code;
+
         // If we have parameters, we need to bind them to the statement.
         if (params) {
             [self bindParameters:params toStatement:&statement];
         }
 
+        RASqliteBudget budget = [self beginBudgetWithToken:token];
+
         do {
-            code = sqlite3_step(statement);
+            code = RASqliteStep(statement, _changes);
             if (code == SQLITE_DONE) {
                 RASqliteDebugLog(@"No rows were found with query: %@", sql);
                 break;
@@ -486,16 +1417,28 @@ static NSString *RASqliteNestedTransactionException = @"Nested transactions";
             NSString *message = RASqliteSF(@"Failed to retrieve result: %s", errmsg);
             RASqliteErrorLog(@"%@", message);
 
-            error = [NSError code:RASqliteErrorQuery message:message];
+            error = [NSError code:RASqliteQueryErrorCode(code) message:message];
             [self setError:error];
         } while (NO);
 
+        if (!error && cacheable && sqlite3_stmt_readonly(statement) && sqlite3_get_autocommit(_database)) {
+            row = [row copy];
+            [_results storeResult:row ?: [NSNull null] forKey:key tables:tables];
+        }
+
+        [self endBudget:budget];
         sqlite3_finalize(statement);
     }];
 
+    [self profileQuery:sql rows:row ? 1 : 0 since:start];
+
     return row;
 }
 
+- (NSDictionary *)fetchRow:(NSString *)sql withParams:(NSArray *)params {
+    return [self fetchRow:sql withParams:params cancellationToken:nil];
+}
+
 - (NSDictionary *)fetchRow:(NSString *)sql withParam:(id)param {
     return [self fetchRow:sql withParams:@[param]];
 }
@@ -506,37 +1449,33 @@ static NSString *RASqliteNestedTransactionException = @"Nested transactions";
 
 #pragma mark -- Update
 
-- (BOOL)execute:(NSString *)sql withParams:(NSArray *)params {
+- (BOOL)execute:(NSString *)sql withParams:(NSArray *)params cancellationToken:(RASqliteCancellationToken *)token {
     BOOL __block success = NO;
+    uint64_t start = RASqliteTimestamp();
 
     [_queue dispatchBlock:^{
-        if (!self.isConnectionOpenOrCanBeOpened) {
+        if (!self.isConnectionOpenOrCanBeOpened || [self isCancelledWithToken:token]) {
             return;
         }
 
         NSError *error;
 
         sqlite3_stmt *statement;
-        int code = sqlite3_prepare_v2(_database, [sql UTF8String], -1, &statement, NULL);
-
-        if (code != SQLITE_OK) {
-            // Something went wrong...
-            const char *errmsg = sqlite3_errmsg(_database);
-            NSString *message = RASqliteSF(@"Failed to prepare statement `%@`: %s", sql, errmsg);
-            RASqliteErrorLog(@"%@", message);
-
-            error = [NSError code:RASqliteErrorQuery message:message];
-            [self setError:error];
-            sqlite3_finalize(statement);
+        if (![self prepareStatement:&statement withQuery:sql]) {
+            return;
         }
 
+        int code;
+
         // If we have parameters, we need to bind them to the statement.
         if (params) {
             [self bindParameters:params toStatement:&statement];
         }
 
+        RASqliteBudget budget = [self beginBudgetWithToken:token];
+
         do {
-            code = sqlite3_step(statement);
+            code = RASqliteStep(statement, _changes);
             if (code == SQLITE_DONE) {
                 // Statement have been successfully executed.
                 success = YES;
@@ -548,16 +1487,187 @@ static NSString *RASqliteNestedTransactionException = @"Nested transactions";
             NSString *message = RASqliteSF(@"Failed to execute query: %s", errmsg);
             RASqliteErrorLog(@"%@", message);
 
-            error = [NSError code:RASqliteErrorQuery message:message];
+            error = [NSError code:RASqliteQueryErrorCode(code) message:message];
             [self setError:error];
         } while (NO);
 
+        [self endBudget:budget];
         sqlite3_finalize(statement);
     }];
 
+    [self profileQuery:sql rows:0 since:start];
+
+    return success;
+}
+
+- (BOOL)execute:(NSString *)sql withParams:(NSArray *)params {
+    return [self execute:sql withParams:params cancellationToken:nil];
+}
+
+- (BOOL)executeCached:(NSString *)sql withParams:(NSArray *)params cancellationToken:(RASqliteCancellationToken *)token {
+    BOOL __block success = NO;
+    uint64_t start = RASqliteTimestamp();
+
+    [_queue dispatchBlock:^{
+        if (!self.isConnectionOpenOrCanBeOpened || [self isCancelledWithToken:token]) {
+            return;
+        }
+
+        // The statement is checked out from the cache while in use, and only
+        // prepared if it is not already available.
+        sqlite3_stmt *statement = [_statements checkOutStatementForQuery:sql];
+        if (!statement && ![self prepareCachedStatement:&statement withQuery:sql]) {
+            return;
+        }
+
+        if (params && ![self bindParameters:params toStatement:&statement]) {
+            [_statements checkInStatement:statement forQuery:sql];
+            return;
+        }
+
+        RASqliteBudget budget = [self beginBudgetWithToken:token];
+        int code = RASqliteStep(statement, _changes);
+        [self endBudget:budget];
+        [self invalidateResultsForStatement:statement withQuery:sql];
+
+        success = code == SQLITE_DONE;
+        if (!success) {
+            const char *errmsg = sqlite3_errmsg(_database);
+            NSString *message = RASqliteSF(@"Failed to execute query: %s", errmsg);
+            RASqliteErrorLog(@"%@", message);
+
+            NSError *error = [NSError code:RASqliteQueryErrorCode(code) message:message];
+            [self setError:error];
+        }
+
+        [_statements checkInStatement:statement forQuery:sql];
+    }];
+
+    [self profileQuery:sql rows:0 since:start];
+
     return success;
 }
 
+- (BOOL)executeCached:(NSString *)sql withParams:(NSArray *)params {
+    return [self executeCached:sql withParams:params cancellationToken:nil];
+}
+
+- (NSArray *)fetchCached:(NSString *)sql withParams:(NSArray *)params cancellationToken:(RASqliteCancellationToken *)token {
+    NSMutableArray __block *results;
+    uint64_t start = RASqliteTimestamp();
+
+    [_queue dispatchBlock:^{
+        if (!self.isConnectionOpenOrCanBeOpened || [self isCancelledWithToken:token]) {
+            return;
+        }
+
+        sqlite3_stmt *statement = [_statements checkOutStatementForQuery:sql];
+        if (!statement && ![self prepareCachedStatement:&statement withQuery:sql]) {
+            return;
+        }
+
+        if (params && ![self bindParameters:params toStatement:&statement]) {
+            [_statements checkInStatement:statement forQuery:sql];
+            return;
+        }
+
+        results = [[NSMutableArray alloc] init];
+
+        RASqliteBudget budget = [self beginBudgetWithToken:token];
+
+        int code;
+        while ((code = RASqliteStep(statement, _changes)) == SQLITE_ROW) {
+            [results addObject:[RASqliteMapper fetchColumns:&statement]];
+        }
+
+        [self endBudget:budget];
+        [self invalidateResultsForStatement:statement withQuery:sql];
+
+        if (code != SQLITE_DONE) {
+            const char *errmsg = sqlite3_errmsg(_database);
+            NSString *message = RASqliteSF(@"Unable to fetch row: %s", errmsg);
+            RASqliteErrorLog(@"%@", message);
+
+            NSError *error = [NSError code:RASqliteQueryErrorCode(code) message:message];
+            [self setError:error];
+
+            results = nil;
+        }
+
+        [_statements checkInStatement:statement forQuery:sql];
+    }];
+
+    [self profileQuery:sql rows:[results count] since:start];
+
+    return results;
+}
+
+- (NSArray *)fetchCached:(NSString *)sql withParams:(NSArray *)params {
+    return [self fetchCached:sql withParams:params cancellationToken:nil];
+}
+
+- (BOOL)stepQuery:(NSString *)sql withParams:(NSArray *)params cancellationToken:(RASqliteCancellationToken *)token usingBlock:(BOOL (^)(sqlite3_stmt *statement))block {
+    BOOL __block success = NO;
+    NSUInteger __block rows = 0;
+    uint64_t start = RASqliteTimestamp();
+
+    [_queue dispatchBlock:^{
+        if (!self.isConnectionOpenOrCanBeOpened || [self isCancelledWithToken:token]) {
+            return;
+        }
+
+        sqlite3_stmt *statement;
+        if (![self prepareStatement:&statement withQuery:sql]) {
+            return;
+        }
+
+        if (params && ![self bindParameters:params toStatement:&statement]) {
+            sqlite3_finalize(statement);
+            return;
+        }
+
+        // The budget includes the time spent within the block, e.g. when
+        // writing the rows to a stream.
+        RASqliteBudget budget = [self beginBudgetWithToken:token];
+
+        int code;
+        while ((code = RASqliteStep(statement, _changes)) == SQLITE_ROW) {
+            rows++;
+
+            BOOL proceed;
+            @autoreleasepool {
+                proceed = block(statement);
+            }
+
+            if (!proceed) {
+                break;
+            }
+        }
+
+        [self endBudget:budget];
+
+        success = code == SQLITE_DONE;
+        if (code != SQLITE_DONE && code != SQLITE_ROW) {
+            const char *errmsg = sqlite3_errmsg(_database);
+            NSString *message = RASqliteSF(@"Unable to step row: %s", errmsg);
+            RASqliteErrorLog(@"%@", message);
+
+            NSError *error = [NSError code:RASqliteQueryErrorCode(code) message:message];
+            [self setError:error];
+        }
+
+        sqlite3_finalize(statement);
+    }];
+
+    [self profileQuery:sql rows:rows since:start];
+
+    return success;
+}
+
+- (BOOL)stepQuery:(NSString *)sql withParams:(NSArray *)params usingBlock:(BOOL (^)(sqlite3_stmt *statement))block {
+    return [self stepQuery:sql withParams:params cancellationToken:nil usingBlock:block];
+}
+
 - (BOOL)execute:(NSString *)sql withParam:(id)param {
     return [self execute:sql withParams:@[param]];
 }
@@ -566,6 +1676,188 @@ static NSString *RASqliteNestedTransactionException = @"Nested transactions";
     return [self execute:sql withParams:nil];
 }
 
+#pragma mark -- Script
+
+- (BOOL)executeStatements:(const char *)sql offset:(NSUInteger)offset cancellationToken:(RASqliteCancellationToken *)token {
+    const char *tail = sql;
+
+    // The tail from the prepare points to the beginning of the next
+    // statement, continue until every statement have been executed.
+    while (*tail) {
+        // Skip the leading whitespace, the offset should point to the
+        // beginning of the statement.
+        if (isspace((unsigned char) *tail)) {
+            tail++;
+            continue;
+        }
+
+        // The remaining statements are skipped once the script is cancelled.
+        if ([self isCancelledWithToken:token]) {
+            return NO;
+        }
+
+        sqlite3_stmt *statement;
+        const char *next;
+
+        NSUInteger position = offset + (NSUInteger) (tail - sql);
+        int code = [self prepareStatement:&statement withBytes:tail tail:&next query:nil];
+        if (code != SQLITE_OK) {
+            const char *errmsg = sqlite3_errmsg(_database);
+            NSString *message = RASqliteSF(@"Failed to prepare statement at offset %lu: %s", (unsigned long) position, errmsg);
+            RASqliteErrorLog(@"%@", message);
+
+            NSError *error = [NSError code:RASqliteErrorQuery message:message];
+            [self setError:[error errorWithOffset:position]];
+            return NO;
+        }
+
+        // Whitespace and comments do not result in a statement.
+        if (!statement) {
+            tail = next;
+            continue;
+        }
+
+        // Rows returned by the statement are ignored. Each statement within
+        // the script have its own budget.
+        RASqliteBudget budget = [self beginBudgetWithToken:token];
+        do {
+            code = RASqliteStep(statement, _changes);
+        } while (code == SQLITE_ROW);
+        [self endBudget:budget];
+
+        if (code != SQLITE_DONE) {
+            const char *errmsg = sqlite3_errmsg(_database);
+            NSString *message = RASqliteSF(@"Failed to execute statement at offset %lu: %s", (unsigned long) position, errmsg);
+            RASqliteErrorLog(@"%@", message);
+
+            NSError *error = [NSError code:RASqliteQueryErrorCode(code) message:message];
+            [self setError:[error errorWithOffset:position]];
+            sqlite3_finalize(statement);
+            return NO;
+        }
+
+        sqlite3_finalize(statement);
+        tail = next;
+    }
+
+    return YES;
+}
+
+- (BOOL)queueScriptWithBlock:(BOOL (^)(void))block inTransaction:(BOOL)transaction {
+    BOOL __block success = NO;
+
+    [_queue dispatchBlock:^{
+        if (!self.isConnectionOpenOrCanBeOpened) {
+            return;
+        }
+
+        // Using a savepoint instead of a transaction, if the script is
+        // executed from within an already active transaction.
+        BOOL savepoint = transaction && [self inTransaction];
+        if (savepoint) {
+            if (![self execute:@"SAVEPOINT rasqlite_script"]) {
+                return;
+            }
+        } else if (transaction && ![self beginTransaction]) {
+            return;
+        }
+
+        success = block();
+        if (!transaction) {
+            return;
+        }
+
+        if (savepoint) {
+            if (!success) {
+                [self execute:@"ROLLBACK TO SAVEPOINT rasqlite_script"];
+            }
+            BOOL released = [self execute:@"RELEASE SAVEPOINT rasqlite_script"];
+            success = success && released;
+            return;
+        }
+
+        if (success) {
+            success = [self commit];
+        } else if ([self inTransaction]) {
+            [self rollBack];
+        }
+    }];
+
+    return success;
+}
+
+- (BOOL)executeScript:(NSString *)script inTransaction:(BOOL)transaction cancellationToken:(RASqliteCancellationToken *)token {
+    return [self queueScriptWithBlock:^BOOL {
+        return [self executeStatements:[script UTF8String] offset:0 cancellationToken:token];
+    } inTransaction:transaction];
+}
+
+- (BOOL)executeScript:(NSString *)script inTransaction:(BOOL)transaction {
+    return [self executeScript:script inTransaction:transaction cancellationToken:nil];
+}
+
+- (BOOL)executeScript:(NSString *)script {
+    return [self executeScript:script inTransaction:NO];
+}
+
+- (BOOL)executeScriptAtPath:(NSString *)path inTransaction:(BOOL)transaction cancellationToken:(RASqliteCancellationToken *)token {
+    FILE *file = fopen([path fileSystemRepresentation], "r");
+    if (!file) {
+        NSString *message = RASqliteSF(@"Unable to open script `%@`: %s", path, strerror(errno));
+        RASqliteErrorLog(@"%@", message);
+
+        NSError *error = [NSError code:RASqliteErrorQuery message:message];
+        [self setError:error];
+        return NO;
+    }
+
+    BOOL success = [self queueScriptWithBlock:^BOOL {
+        NSMutableData *buffer = [[NSMutableData alloc] init];
+
+        // Offset of the buffer, and the position within the file.
+        NSUInteger offset = 0;
+        NSUInteger position = 0;
+
+        char *line = NULL;
+        size_t capacity = 0;
+        ssize_t length;
+
+        BOOL executed = YES;
+        while (executed && (length = getline(&line, &capacity, file)) > 0) {
+            position += (NSUInteger) length;
+
+            // The buffer is null-terminated while checking whether the
+            // statements are complete, e.g. triggers span multiple lines.
+            [buffer appendBytes:line length:(NSUInteger) length];
+            [buffer appendBytes:"" length:1];
+            if (!sqlite3_complete([buffer bytes])) {
+                [buffer setLength:[buffer length] - 1];
+                continue;
+            }
+
+            executed = [self executeStatements:[buffer bytes] offset:offset cancellationToken:token];
+            [buffer setLength:0];
+            offset = position;
+        }
+        free(line);
+
+        // The last statement is not required to end with a semicolon.
+        if (executed && [buffer length] > 0) {
+            [buffer appendBytes:"" length:1];
+            executed = [self executeStatements:[buffer bytes] offset:offset cancellationToken:token];
+        }
+
+        return executed;
+    } inTransaction:transaction];
+    fclose(file);
+
+    return success;
+}
+
+- (BOOL)executeScriptAtPath:(NSString *)path inTransaction:(BOOL)transaction {
+    return [self executeScriptAtPath:path inTransaction:transaction cancellationToken:nil];
+}
+
 #pragma mark -- Transaction
 
 - (BOOL)beginTransaction:(RASqliteTransaction)type {
@@ -618,6 +1910,7 @@ static NSString *RASqliteNestedTransactionException = @"Nested transactions";
     [_queue dispatchBlock:^{
         char *errmsg;
         int code = sqlite3_exec(_database, "ROLLBACK TRANSACTION", 0, 0, &errmsg);
+        [_changes didFinishStatement:"ROLLBACK TRANSACTION" result:code];
 
         success = (code == SQLITE_OK);
         if (success) {
@@ -640,6 +1933,7 @@ static NSString *RASqliteNestedTransactionException = @"Nested transactions";
     [_queue dispatchBlock:^{
         char *errmsg;
         int code = sqlite3_exec(_database, "COMMIT TRANSACTION", 0, 0, &errmsg);
+        [_changes didFinishStatement:"COMMIT TRANSACTION" result:code];
 
         success = (code == SQLITE_OK);
         if (success) {
@@ -698,7 +1992,9 @@ static NSString *RASqliteNestedTransactionException = @"Nested transactions";
 
         if (commit) {
             [self commit];
-        } else {
+        } else if ([self inTransaction]) {
+            // An interrupted query might already have rolled back the
+            // transaction, and rolling back again would replace the error.
             [self rollBack];
         }
     }];
@@ -722,6 +2018,14 @@ static NSString *RASqliteNestedTransactionException = @"Nested transactions";
     return insertId;
 }
 
+- (void)setLastInsertId:(NSNumber *)insertId {
+    [_queue dispatchBlock:^{
+        if (_database) {
+            sqlite3_set_last_insert_rowid(_database, [insertId longLongValue]);
+        }
+    }];
+}
+
 - (NSNumber *)rowCount {
     NSNumber __block *count;
 
@@ -0,0 +1,67 @@
+//
+//  RASqliteArray.h
+//  RASqlite
+//
+//  Created by Tobias Raatiniemi on 2017-01-01.
+//  Copyright (c) 2017 Raatiniemi. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ Array of values bound as a single parameter to the `rasqlite_array` function.
+
+ The `rasqlite_array` table-valued function is available on every connection,
+ and returns one row for every value within the bound array. The statement do
+ not depend on the number of values, i.e. it is prepared once and kept within
+ the statement cache.
+
+ @code
+ RASqliteArray *ids = [[RASqliteArray alloc] initWithValues:@[@1, @2, @3]];
+ NSArray *rows = [rasqlite fetch:@"SELECT * FROM user WHERE id IN rasqlite_array(?)" withParam:ids];
+ @endcode
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ The array is bound by pointer, which require SQLite 3.20, i.e. macOS 10.14
+ or iOS 12. On earlier versions the array can not be bound.
+ */
+@interface RASqliteArray : NSObject
+
+/// Stores the number of values within the array.
+@property(nonatomic, readonly) NSUInteger count;
+
+#pragma mark - Initialization
+
+/**
+ Initialize with the values.
+
+ @param values Values of type `NSNumber`, `NSString`, `NSData`, or `NSNull`.
+
+ @return Initialized array.
+
+ @throws NSInvalidArgumentException If a value is of an unsupported type.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ Arrays with only integer values are stored as a packed buffer.
+ */
+- (instancetype)initWithValues:(NSArray *)values;
+
+/**
+ Initialize with a buffer of integers.
+
+ @param integers Buffer of integers, copied by the array.
+ @param count Number of integers within the buffer.
+
+ @return Initialized array.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (instancetype)initWithIntegers:(const int64_t *)integers count:(NSUInteger)count;
+
+- (id)init __unavailable;
+
+@end
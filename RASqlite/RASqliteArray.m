@@ -0,0 +1,134 @@
+//
+//  RASqliteArray.m
+//  RASqlite
+//
+//  Created by Tobias Raatiniemi on 2017-01-01.
+//  Copyright (c) 2017 Raatiniemi. All rights reserved.
+//
+
+#import "RASqliteArray.h"
+#import "RASqliteArrayModule.h"
+
+@interface RASqliteArray () {
+@private
+    /// Packed integers, if every value is an integer.
+    NSData *_integers;
+
+    /// Values, if any value is not an integer.
+    NSArray *_values;
+}
+
+@end
+
+@implementation RASqliteArray
+
+#pragma mark - Initialization
+
+- (instancetype)initWithValues:(NSArray *)values {
+    if (self = [super init]) {
+        BOOL integers = YES;
+        for (id value in values) {
+            if ([value isKindOfClass:[NSNumber class]]) {
+                const char *type = [value objCType];
+                if (strcmp(type, @encode(double)) == 0 || strcmp(type, @encode(float)) == 0) {
+                    integers = NO;
+                }
+                continue;
+            }
+
+            if (![value isKindOfClass:[NSString class]] && ![value isKindOfClass:[NSData class]]
+                    && ![value isKindOfClass:[NSNull class]]) {
+                [NSException raise:NSInvalidArgumentException
+                            format:@"Unable to use type `%@` within array.", [value class]];
+            }
+            integers = NO;
+        }
+
+        _count = [values count];
+        if (!integers) {
+            _values = [values copy];
+            return self;
+        }
+
+        NSMutableData *data = [[NSMutableData alloc] initWithLength:_count * sizeof(int64_t)];
+        int64_t *buffer = [data mutableBytes];
+
+        NSUInteger index = 0;
+        for (NSNumber *value in values) {
+            buffer[index++] = [value longLongValue];
+        }
+        _integers = data;
+    }
+
+    return self;
+}
+
+- (instancetype)initWithIntegers:(const int64_t *)integers count:(NSUInteger)count {
+    if (self = [super init]) {
+        _count = count;
+        _integers = [[NSData alloc] initWithBytes:integers length:count * sizeof(int64_t)];
+    }
+
+    return self;
+}
+
+#pragma mark - Equality
+
+// The arrays are used within the keys for the result cache.
+
+- (BOOL)isEqual:(id)object {
+    if (self == object) {
+        return YES;
+    }
+
+    if (![object isKindOfClass:[RASqliteArray class]]) {
+        return NO;
+    }
+
+    RASqliteArray *array = object;
+    if (_integers) {
+        return [_integers isEqualToData:array->_integers];
+    }
+
+    return [_values isEqualToArray:array->_values];
+}
+
+- (NSUInteger)hash {
+    return _integers ? [_integers hash] : [_values hash];
+}
+
+#pragma mark - Module
+
+- (void)resultForValueAtIndex:(NSUInteger)index context:(sqlite3_context *)context {
+    if (_integers) {
+        const int64_t *buffer = [_integers bytes];
+        sqlite3_result_int64(context, buffer[index]);
+        return;
+    }
+
+    id value = _values[index];
+    if ([value isKindOfClass:[NSNull class]]) {
+        sqlite3_result_null(context);
+        return;
+    }
+
+    if ([value isKindOfClass:[NSString class]]) {
+        sqlite3_result_text(context, [value UTF8String], -1, SQLITE_TRANSIENT);
+        return;
+    }
+
+    if ([value isKindOfClass:[NSNumber class]]) {
+        const char *type = [value objCType];
+        if (strcmp(type, @encode(double)) == 0 || strcmp(type, @encode(float)) == 0) {
+            sqlite3_result_double(context, [value doubleValue]);
+            return;
+        }
+
+        sqlite3_result_int64(context, [value longLongValue]);
+        return;
+    }
+
+    sqlite3_result_blob(context, [value bytes], (int) [value length], SQLITE_TRANSIENT);
+}
+
+@end
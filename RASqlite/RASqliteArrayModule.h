@@ -0,0 +1,68 @@
+//
+//  RASqliteArrayModule.h
+//  RASqlite
+//
+//  Created by Tobias Raatiniemi on 2017-01-01.
+//  Copyright (c) 2017 Raatiniemi. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import <sqlite3.h>
+
+#import "RASqliteArray.h"
+
+/**
+ Table-valued function returning the values of a bound `RASqliteArray`.
+
+ The function is implemented as an eponymous virtual table, in the style of
+ the `carray` extension, with a hidden column for the bound array, i.e.
+ `rasqlite_array(?)` is equivalent to `rasqlite_array WHERE pointer = ?`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+@interface RASqliteArrayModule : NSObject
+
+/**
+ Register the function on the database connection.
+
+ @param database Database connection.
+
+ @return Result code from `sqlite3_create_module`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ The function is not registered if binding by pointer is not supported.
+ */
++ (int)registerWithDatabase:(sqlite3 *)database;
+
+/**
+ Bind the array by pointer to the statement.
+
+ @param array Array to bind, retained until the binding is replaced.
+ @param statement Statement to be bound.
+ @param index Index of the parameter.
+
+ @return Result code from `sqlite3_bind_pointer`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
++ (int)bindArray:(RASqliteArray *)array toStatement:(sqlite3_stmt *)statement index:(int)index;
+
+- (id)init __unavailable;
+
+@end
+
+@interface RASqliteArray (RASqliteArrayModule)
+
+/**
+ Set the value at the index as the result for the column.
+
+ @param index Index of the value.
+ @param context Context for the column result.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)resultForValueAtIndex:(NSUInteger)index context:(sqlite3_context *)context;
+
+@end
@@ -0,0 +1,201 @@
+//
+//  RASqliteArrayModule.m
+//  RASqlite
+//
+//  Created by Tobias Raatiniemi on 2017-01-01.
+//  Copyright (c) 2017 Raatiniemi. All rights reserved.
+//
+
+#import "RASqliteArrayModule.h"
+
+/// Name of the table-valued function.
+static const char *RASqliteArrayModuleName = "rasqlite_array";
+
+/// Type for the bound pointer, pointers bound with other types are ignored.
+static const char *RASqliteArrayPointerType = "rasqlite_array";
+
+/// Column for the values, and the hidden column for the bound array.
+enum {
+    RASqliteArrayColumnValue = 0,
+    RASqliteArrayColumnPointer = 1
+};
+
+/// Cursor iterating the values of the bound array.
+typedef struct {
+    sqlite3_vtab_cursor base;
+
+    /// Retained array, or `NULL` if no array have been bound.
+    const void *array;
+
+    sqlite3_int64 index;
+    sqlite3_int64 count;
+} RASqliteArrayCursor;
+
+/**
+ Release the bound array, called by SQLite when the binding is replaced.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static void RASqliteArrayRelease(void *pointer) {
+    (void) (__bridge_transfer RASqliteArray *) pointer;
+}
+
+static int RASqliteArrayConnect(sqlite3 *database, void *aux, int argc, const char *const *argv, sqlite3_vtab **vtab, char **error) {
+    int code = sqlite3_declare_vtab(database, "CREATE TABLE x(value, pointer HIDDEN)");
+    if (code != SQLITE_OK) {
+        return code;
+    }
+
+    *vtab = sqlite3_malloc(sizeof(sqlite3_vtab));
+    if (!*vtab) {
+        return SQLITE_NOMEM;
+    }
+    memset(*vtab, 0, sizeof(sqlite3_vtab));
+
+    return SQLITE_OK;
+}
+
+static int RASqliteArrayDisconnect(sqlite3_vtab *vtab) {
+    sqlite3_free(vtab);
+    return SQLITE_OK;
+}
+
+static int RASqliteArrayBestIndex(sqlite3_vtab *vtab, sqlite3_index_info *info) {
+    for (int i = 0; i < info->nConstraint; i++) {
+        const struct sqlite3_index_constraint *constraint = &info->aConstraint[i];
+        if (constraint->iColumn != RASqliteArrayColumnPointer || constraint->op != SQLITE_INDEX_CONSTRAINT_EQ
+                || !constraint->usable) {
+            continue;
+        }
+
+        info->aConstraintUsage[i].argvIndex = 1;
+        info->aConstraintUsage[i].omit = 1;
+        info->idxNum = 1;
+        info->estimatedCost = 1;
+        info->estimatedRows = 100;
+
+        return SQLITE_OK;
+    }
+
+    // Without the bound array there are no rows, the cost prevents the
+    // planner from choosing a plan where the array is not available.
+    info->idxNum = 0;
+    info->estimatedCost = 2147483647;
+    info->estimatedRows = 2147483647;
+
+    return SQLITE_OK;
+}
+
+static int RASqliteArrayOpen(sqlite3_vtab *vtab, sqlite3_vtab_cursor **cursor) {
+    RASqliteArrayCursor *arrayCursor = sqlite3_malloc(sizeof(RASqliteArrayCursor));
+    if (!arrayCursor) {
+        return SQLITE_NOMEM;
+    }
+    memset(arrayCursor, 0, sizeof(RASqliteArrayCursor));
+
+    *cursor = &arrayCursor->base;
+    return SQLITE_OK;
+}
+
+static int RASqliteArrayClose(sqlite3_vtab_cursor *cursor) {
+    RASqliteArrayCursor *arrayCursor = (RASqliteArrayCursor *) cursor;
+    if (arrayCursor->array) {
+        (void) (__bridge_transfer RASqliteArray *) arrayCursor->array;
+    }
+
+    sqlite3_free(arrayCursor);
+    return SQLITE_OK;
+}
+
+static int RASqliteArrayFilter(sqlite3_vtab_cursor *cursor, int idxNum, const char *idxStr, int argc, sqlite3_value **argv) {
+    RASqliteArrayCursor *arrayCursor = (RASqliteArrayCursor *) cursor;
+    if (arrayCursor->array) {
+        (void) (__bridge_transfer RASqliteArray *) arrayCursor->array;
+        arrayCursor->array = NULL;
+    }
+
+    arrayCursor->index = 0;
+    arrayCursor->count = 0;
+
+    if (idxNum != 1 || argc < 1) {
+        return SQLITE_OK;
+    }
+
+    // The cursor keeps its own reference, the binding can be replaced while
+    // the cursor is still open.
+    if (@available(macOS 10.14, iOS 12.0, *)) {
+        void *pointer = sqlite3_value_pointer(argv[0], RASqliteArrayPointerType);
+        if (pointer) {
+            arrayCursor->array = (__bridge_retained void *) (__bridge RASqliteArray *) pointer;
+            arrayCursor->count = (sqlite3_int64) [(__bridge RASqliteArray *) pointer count];
+        }
+    }
+
+    return SQLITE_OK;
+}
+
+static int RASqliteArrayNext(sqlite3_vtab_cursor *cursor) {
+    ((RASqliteArrayCursor *) cursor)->index++;
+    return SQLITE_OK;
+}
+
+static int RASqliteArrayEof(sqlite3_vtab_cursor *cursor) {
+    RASqliteArrayCursor *arrayCursor = (RASqliteArrayCursor *) cursor;
+    return arrayCursor->index >= arrayCursor->count;
+}
+
+static int RASqliteArrayColumn(sqlite3_vtab_cursor *cursor, sqlite3_context *context, int column) {
+    RASqliteArrayCursor *arrayCursor = (RASqliteArrayCursor *) cursor;
+    if (column != RASqliteArrayColumnValue) {
+        sqlite3_result_null(context);
+        return SQLITE_OK;
+    }
+
+    RASqliteArray *array = (__bridge RASqliteArray *) arrayCursor->array;
+    [array resultForValueAtIndex:(NSUInteger) arrayCursor->index context:context];
+
+    return SQLITE_OK;
+}
+
+static int RASqliteArrayRowid(sqlite3_vtab_cursor *cursor, sqlite3_int64 *rowid) {
+    *rowid = ((RASqliteArrayCursor *) cursor)->index + 1;
+    return SQLITE_OK;
+}
+
+/// Eponymous-only module, i.e. `CREATE VIRTUAL TABLE` is not supported.
+static sqlite3_module RASqliteArrayModuleDefinition = {
+    0,
+    NULL,
+    RASqliteArrayConnect,
+    RASqliteArrayBestIndex,
+    RASqliteArrayDisconnect,
+    NULL,
+    RASqliteArrayOpen,
+    RASqliteArrayClose,
+    RASqliteArrayFilter,
+    RASqliteArrayNext,
+    RASqliteArrayEof,
+    RASqliteArrayColumn,
+    RASqliteArrayRowid
+};
+
+@implementation RASqliteArrayModule
+
++ (int)registerWithDatabase:(sqlite3 *)database {
+    if (@available(macOS 10.14, iOS 12.0, *)) {
+        return sqlite3_create_module(database, RASqliteArrayModuleName, &RASqliteArrayModuleDefinition, NULL);
+    }
+
+    return SQLITE_OK;
+}
+
++ (int)bindArray:(RASqliteArray *)array toStatement:(sqlite3_stmt *)statement index:(int)index {
+    if (@available(macOS 10.14, iOS 12.0, *)) {
+        void *pointer = (__bridge_retained void *) array;
+        return sqlite3_bind_pointer(statement, index, pointer, RASqliteArrayPointerType, RASqliteArrayRelease);
+    }
+
+    return SQLITE_MISUSE;
+}
+
+@end
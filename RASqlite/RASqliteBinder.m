@@ -10,6 +10,8 @@
 
 #import "RASqlite.h"
 #import "NSError+RASqlite.h"
+#import "RASqliteCompressor.h"
+#import "RASqliteArrayModule.h"
 
 typedef BOOL (*isClass)(id, SEL, Class);
 
@@ -36,6 +38,10 @@ typedef BOOL (*isClass)(id, SEL, Class);
 
 - (int)bindBlob:(id)parameter toIndex:(unsigned int)index;
 
+- (int)bindCompressed:(RASqliteCompressedValue *)parameter toIndex:(unsigned int)index;
+
+- (int)bindArray:(RASqliteArray *)parameter toIndex:(unsigned int)index;
+
 @end
 
 @implementation RASqliteBinder
@@ -92,6 +98,14 @@ typedef BOOL (*isClass)(id, SEL, Class);
         return [self bindNumber:parameter toIndex:index];
     }
 
+    if (_isKindOfClass(parameter, _selector, [RASqliteCompressedValue class])) {
+        return [self bindCompressed:parameter toIndex:index];
+    }
+
+    if (_isKindOfClass(parameter, _selector, [RASqliteArray class])) {
+        return [self bindArray:parameter toIndex:index];
+    }
+
     return [self bindBlob:parameter toIndex:index];
 }
 
@@ -125,4 +139,23 @@ typedef BOOL (*isClass)(id, SEL, Class);
     return sqlite3_bind_blob(*_statement, index, [parameter bytes], length, SQLITE_TRANSIENT);
 }
 
+- (int)bindCompressed:(RASqliteCompressedValue *)parameter toIndex:(unsigned int)index {
+    NSData *compressed = [RASqliteCompressor compressValue:[parameter value]
+                                               compression:[parameter compression]
+                                                 threshold:[parameter threshold]];
+
+    // Values that should not be compressed are bound as is.
+    if (!compressed) {
+        return [self bindParameter:[parameter value] toIndex:index];
+    }
+
+    return [self bindBlob:compressed toIndex:index];
+}
+
+- (int)bindArray:(RASqliteArray *)parameter toIndex:(unsigned int)index {
+    // The array is bound by pointer, i.e. the values are not copied and the
+    // number of values do not affect the statement.
+    return [RASqliteArrayModule bindArray:parameter toStatement:*_statement index:(int) index];
+}
+
 @end
@@ -0,0 +1,81 @@
+//
+//  RASqliteCancellationToken.h
+//  RASqlite
+//
+//  Created by Tobias Raatiniemi on 2016-12-21.
+//  Copyright (c) 2016 Raatiniemi. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ Token for cancelling queries, optionally with a time budget.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ The token is checked periodically while the query is executed, i.e. a query
+ can be cancelled from another thread while it is running. Cancelled queries
+ are interrupted and fail with the `RASqliteErrorInterrupt` error code.
+ */
+@interface RASqliteCancellationToken : NSObject
+
+#pragma mark - Initialization
+
+/**
+ Initialize token without time budget.
+
+ @return Initialized token.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (instancetype)init;
+
+/**
+ Initialize token with time budget.
+
+ @param timeout Time budget in seconds, from the initialization of the token.
+
+ @return Initialized token.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ The budget includes the time spent waiting for the database queue, i.e. it is
+ the latest point in time the query should be completed.
+ */
+- (instancetype)initWithTimeout:(NSTimeInterval)timeout;
+
+/**
+ Build token with time budget.
+
+ @param timeout Time budget in seconds, from the initialization of the token.
+
+ @return Initialized token.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
++ (instancetype)tokenWithTimeout:(NSTimeInterval)timeout;
+
+#pragma mark - Cancellation
+
+/**
+ Cancel the queries using the token.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ The method is thread-safe, and cancellation can not be undone.
+ */
+- (void)cancel;
+
+/**
+ Check whether the token have been cancelled, or the time budget have expired.
+
+ @return `YES` if the token have been cancelled or have expired, otherwise `NO`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (BOOL)isCancelled;
+
+@end
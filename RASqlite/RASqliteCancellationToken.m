@@ -0,0 +1,63 @@
+//
+//  RASqliteCancellationToken.m
+//  RASqlite
+//
+//  Created by Tobias Raatiniemi on 2016-12-21.
+//  Copyright (c) 2016 Raatiniemi. All rights reserved.
+//
+
+#import "RASqliteCancellationToken.h"
+
+#import <stdatomic.h>
+
+#import "RASqliteHistogram.h"
+
+@interface RASqliteCancellationToken () {
+@private
+    atomic_bool _cancelled;
+
+    /// Monotonic timestamp for when the token expires, zero without budget.
+    uint64_t _deadline;
+}
+
+@end
+
+@implementation RASqliteCancellationToken
+
+#pragma mark - Initialization
+
+- (instancetype)init {
+    return [self initWithTimeout:0];
+}
+
+- (instancetype)initWithTimeout:(NSTimeInterval)timeout {
+    if (self = [super init]) {
+        atomic_init(&_cancelled, false);
+
+        if (timeout > 0) {
+            _deadline = RASqliteTimestamp() + (uint64_t) (timeout * 1000000000.0);
+        }
+    }
+
+    return self;
+}
+
++ (instancetype)tokenWithTimeout:(NSTimeInterval)timeout {
+    return [[self alloc] initWithTimeout:timeout];
+}
+
+#pragma mark - Cancellation
+
+- (void)cancel {
+    atomic_store_explicit(&_cancelled, true, memory_order_relaxed);
+}
+
+- (BOOL)isCancelled {
+    if (atomic_load_explicit(&_cancelled, memory_order_relaxed)) {
+        return YES;
+    }
+
+    return _deadline > 0 && RASqliteTimestamp() >= _deadline;
+}
+
+@end
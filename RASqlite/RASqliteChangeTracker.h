@@ -0,0 +1,84 @@
+//
+//  RASqliteChangeTracker.h
+//  RASqlite
+//
+//  Created by Tobias Raatiniemi on 2016-12-26.
+//  Copyright (c) 2016 Raatiniemi. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import <sqlite3.h>
+
+#import "RASqliteTableChange.h"
+
+/**
+ Collects the changed rows with the update hook and notifies the table observers.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ The changes are collected while the transaction is active and delivered once
+ the commit have completed, changes within a rolled back transaction or rolled
+ back to a savepoint are discarded. Only rows within observed tables are
+ collected.
+
+ @par
+ SQLite do not invoke the update hook for tables without rowid, for rows
+ removed by the truncate optimization, i.e. `DELETE` without `WHERE`, or for
+ rows replaced by `ON CONFLICT REPLACE`.
+ */
+@interface RASqliteChangeTracker : NSObject
+
+/// Stores the block called for every changed row, regardless of the observers.
+@property(copy, nonatomic) void (^updateHandler)(const char *table);
+
+/**
+ Register the update, commit, and rollback hooks on the database connection.
+
+ @param database Database connection to track.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ The tracker have to be kept alive until the connection have been closed.
+ */
+- (void)attachToDatabase:(sqlite3 *)database;
+
+/**
+ Notify the tracker that the statement is done, i.e. it will not be stepped again.
+
+ @param sql Statement that have been executed.
+ @param code Result code from the last step, or from the execution.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ The pending changes are delivered once the statement completing the commit
+ is done, e.g. `COMMIT` or `RELEASE`. The statement is also used for tracking
+ the savepoints, since SQLite do not call the rollback hook for `ROLLBACK TO`.
+ */
+- (void)didFinishStatement:(const char *)sql result:(int)code;
+
+/**
+ Add observer for changes to the table.
+
+ @param table Name of the table to observe.
+ @param queue Queue on which the handler is called.
+ @param handler Block receiving the changes, once for each committed transaction.
+
+ @return Opaque observer, used for removing the observer.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (id)addObserverForTable:(NSString *)table queue:(dispatch_queue_t)queue handler:(RASqliteChangeHandler)handler;
+
+/**
+ Remove the observer, its handler will not be called for later commits.
+
+ @param observer Observer returned when the observer was added.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)removeObserver:(id)observer;
+
+@end
@@ -0,0 +1,520 @@
+//
+//  RASqliteChangeTracker.m
+//  RASqlite
+//
+//  Created by Tobias Raatiniemi on 2016-12-26.
+//  Copyright (c) 2016 Raatiniemi. All rights reserved.
+//
+
+#import "RASqliteChangeTracker.h"
+
+#import <pthread.h>
+#import <stdatomic.h>
+
+/**
+ Observer for changes to a table.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+@interface RASqliteChangeObserver : NSObject
+
+/// Stores the name of the observed table.
+@property(copy, nonatomic) NSString *table;
+
+/// Stores the queue on which the handler is called.
+@property(strong, nonatomic) dispatch_queue_t queue;
+
+/// Stores the block receiving the changes.
+@property(copy, nonatomic) RASqliteChangeHandler handler;
+
+/// Stores whether the observer have been removed.
+@property(atomic, getter = isRemoved) BOOL removed;
+
+@end
+
+@implementation RASqliteChangeObserver
+
+@end
+
+@interface RASqliteChangeTracker () {
+@private
+    pthread_mutex_t _lock;
+
+    NSMutableDictionary *_observers;
+
+    /// Incremented when observers are added or removed, invalidates the cached lookup.
+    atomic_uint _generation;
+
+    /// Number of observers, checked without the lock.
+    atomic_uint _count;
+
+    // -- -- Pending changes, only accessed from within the hooks.
+
+    /// Database connection for the hooks.
+    sqlite3 *_database;
+
+    /// Pending changes for the transaction, followed by one level for each savepoint.
+    NSMutableArray *_levels;
+
+    /// Names of the active savepoints, in lowercase.
+    NSMutableArray *_savepoints;
+
+    /// Changed rowids for each table, i.e. inserted, updated, and deleted,
+    /// within the innermost level.
+    NSMutableDictionary *_pending;
+
+    /// Stores whether the commit hook have been called for the statement.
+    BOOL _committing;
+
+    /// Name of the table for the last change.
+    char *_lastTable;
+
+    /// Changed rowids for the last table, `nil` if the table is not observed.
+    __unsafe_unretained NSArray *_lastChanges;
+
+    /// Generation for the cached lookup.
+    unsigned int _lastGeneration;
+}
+
+/**
+ Record the changed row, if the table is observed.
+
+ @param operation Type of change, i.e. `SQLITE_INSERT`, `SQLITE_UPDATE`, or `SQLITE_DELETE`.
+ @param table Name of the changed table.
+ @param rowid Rowid for the changed row.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)recordOperation:(int)operation table:(const char *)table rowid:(sqlite3_int64)rowid;
+
+/**
+ Mark the pending changes as committing, delivered once the statement is done.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)commit;
+
+/**
+ Discard the pending changes.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)rollback;
+
+/**
+ Update the levels for the savepoint statement, i.e. `SAVEPOINT`, `RELEASE`,
+ and `ROLLBACK TO`. Other statements are ignored.
+
+ @param sql Statement that have been executed.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)trackSavepoint:(const char *)sql;
+
+/**
+ Merge the levels above the level into it.
+
+ @param level Index of the level to merge into.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)mergeIntoLevel:(NSUInteger)level;
+
+/**
+ Deliver the pending changes to the observers.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)deliver;
+
+@end
+
+/**
+ Skip the keyword at the beginning of the statement.
+
+ @param sql Statement to check.
+ @param keyword Keyword, in uppercase.
+
+ @return Remainder of the statement after the keyword, or `NULL` if the
+ statement do not begin with the keyword.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static const char *RASqliteChangeTrackerKeyword(const char *sql, const char *keyword) {
+    while (isspace((unsigned char) *sql)) {
+        sql++;
+    }
+
+    size_t length = strlen(keyword);
+    if (strncasecmp(sql, keyword, length) != 0) {
+        return NULL;
+    }
+
+    char c = sql[length];
+    if (isalnum((unsigned char) c) || c == '_' || (c & 0x80)) {
+        return NULL;
+    }
+
+    return sql + length;
+}
+
+/**
+ Read the savepoint name, quoted or unquoted.
+
+ @param sql Remainder of the statement, beginning with the name.
+
+ @return Name of the savepoint in lowercase, since names are case insensitive.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static NSString *RASqliteChangeTrackerName(const char *sql) {
+    while (isspace((unsigned char) *sql)) {
+        sql++;
+    }
+
+    const char *end;
+    if (*sql == '"' || *sql == '`' || *sql == '\'' || *sql == '[') {
+        char quote = *sql == '[' ? ']' : *sql;
+        end = strchr(++sql, quote) ?: sql + strlen(sql);
+    } else {
+        end = sql;
+        while (isalnum((unsigned char) *end) || *end == '_' || *end == '$' || (*end & 0x80)) {
+            end++;
+        }
+    }
+
+    NSString *name = [[NSString alloc] initWithBytes:sql length:(NSUInteger) (end - sql) encoding:NSUTF8StringEncoding];
+    return [name lowercaseString];
+}
+
+/**
+ Callback for the SQLite update hook, records the changed row.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static void RASqliteChangeTrackerUpdate(void *context, int operation, const char *database, const char *table, sqlite3_int64 rowid) {
+    RASqliteChangeTracker *tracker = (__bridge RASqliteChangeTracker *) context;
+    [tracker recordOperation:operation table:table rowid:rowid];
+}
+
+/**
+ Callback for the SQLite commit hook, marks the pending changes as committing.
+
+ @return Zero, i.e. the commit is never converted into a rollback.
+
+ @note
+ The commit can still fail after the hook have been called, e.g. if the
+ database is busy, i.e. the changes are not delivered from within the hook.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static int RASqliteChangeTrackerCommit(void *context) {
+    RASqliteChangeTracker *tracker = (__bridge RASqliteChangeTracker *) context;
+    [tracker commit];
+
+    return 0;
+}
+
+/**
+ Callback for the SQLite rollback hook, discards the pending changes.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static void RASqliteChangeTrackerRollback(void *context) {
+    RASqliteChangeTracker *tracker = (__bridge RASqliteChangeTracker *) context;
+    [tracker rollback];
+}
+
+@implementation RASqliteChangeTracker
+
+- (instancetype)init {
+    if (self = [super init]) {
+        pthread_mutex_init(&_lock, NULL);
+        _observers = [[NSMutableDictionary alloc] init];
+        _savepoints = [[NSMutableArray alloc] init];
+
+        _pending = [[NSMutableDictionary alloc] init];
+        _levels = [[NSMutableArray alloc] initWithObjects:_pending, nil];
+
+        atomic_init(&_generation, 1);
+        atomic_init(&_count, 0);
+    }
+
+    return self;
+}
+
+- (void)dealloc {
+    free(_lastTable);
+    pthread_mutex_destroy(&_lock);
+}
+
+- (void)attachToDatabase:(sqlite3 *)database {
+    void *context = (__bridge void *) self;
+    _database = database;
+
+    sqlite3_update_hook(database, RASqliteChangeTrackerUpdate, context);
+    sqlite3_commit_hook(database, RASqliteChangeTrackerCommit, context);
+    sqlite3_rollback_hook(database, RASqliteChangeTrackerRollback, context);
+}
+
+#pragma mark - Observer
+
+- (id)addObserverForTable:(NSString *)table queue:(dispatch_queue_t)queue handler:(RASqliteChangeHandler)handler {
+    RASqliteChangeObserver *observer = [[RASqliteChangeObserver alloc] init];
+    [observer setTable:table];
+    [observer setQueue:queue];
+    [observer setHandler:handler];
+
+    pthread_mutex_lock(&_lock);
+    NSMutableArray *observers = _observers[table];
+    if (!observers) {
+        observers = [[NSMutableArray alloc] init];
+        _observers[table] = observers;
+    }
+    [observers addObject:observer];
+
+    atomic_fetch_add(&_count, 1);
+    atomic_fetch_add(&_generation, 1);
+    pthread_mutex_unlock(&_lock);
+
+    return observer;
+}
+
+- (void)removeObserver:(id)observer {
+    if (![observer isKindOfClass:[RASqliteChangeObserver class]]) {
+        return;
+    }
+
+    RASqliteChangeObserver *tObserver = observer;
+    [tObserver setRemoved:YES];
+
+    pthread_mutex_lock(&_lock);
+    NSMutableArray *observers = _observers[[tObserver table]];
+    if ([observers indexOfObjectIdenticalTo:tObserver] != NSNotFound) {
+        [observers removeObjectIdenticalTo:tObserver];
+        if ([observers count] == 0) {
+            [_observers removeObjectForKey:[tObserver table]];
+        }
+
+        atomic_fetch_sub(&_count, 1);
+        atomic_fetch_add(&_generation, 1);
+    }
+    pthread_mutex_unlock(&_lock);
+}
+
+#pragma mark - Hook
+
+- (void)recordOperation:(int)operation table:(const char *)table rowid:(sqlite3_int64)rowid {
+    if (_updateHandler) {
+        _updateHandler(table);
+    }
+
+    if (atomic_load_explicit(&_count, memory_order_relaxed) == 0) {
+        return;
+    }
+
+    // Changes usually target the same table in sequence, e.g. bulk inserts,
+    // i.e. the lookup for the table is cached until the observers change.
+    unsigned int generation = atomic_load_explicit(&_generation, memory_order_acquire);
+    if (generation != _lastGeneration || !_lastTable || strcmp(_lastTable, table) != 0) {
+        free(_lastTable);
+        _lastTable = strdup(table);
+        _lastGeneration = generation;
+
+        NSString *name = @(table);
+
+        pthread_mutex_lock(&_lock);
+        BOOL observed = _observers[name] != nil;
+        pthread_mutex_unlock(&_lock);
+
+        NSArray *changes = nil;
+        if (observed) {
+            changes = _pending[name];
+            if (!changes) {
+                changes = @[[NSMutableSet set], [NSMutableSet set], [NSMutableSet set]];
+                _pending[name] = changes;
+            }
+        }
+
+        // The changes are retained by the pending dictionary.
+        _lastChanges = changes;
+    }
+
+    if (!_lastChanges) {
+        return;
+    }
+
+    NSUInteger index = operation == SQLITE_INSERT ? 0 : (operation == SQLITE_UPDATE ? 1 : 2);
+    [(NSMutableSet *) _lastChanges[index] addObject:@(rowid)];
+}
+
+- (void)commit {
+    _committing = YES;
+}
+
+- (void)rollback {
+    _pending = [[NSMutableDictionary alloc] init];
+    _levels = [[NSMutableArray alloc] initWithObjects:_pending, nil];
+    [_savepoints removeAllObjects];
+    _committing = NO;
+
+    _lastChanges = nil;
+
+    // Force the lookup for the next change, since the pending changes for
+    // the cached table have been reset.
+    _lastGeneration = 0;
+}
+
+- (void)didFinishStatement:(const char *)sql result:(int)code {
+    BOOL done = code == SQLITE_DONE || code == SQLITE_OK;
+    if (done && sql) {
+        [self trackSavepoint:sql];
+    }
+
+    BOOL committing = _committing;
+    _committing = NO;
+
+    // The changes are kept until the transaction have been completed, i.e.
+    // the commit is done once the connection is back in autocommit mode.
+    if (!_database || !sqlite3_get_autocommit(_database)) {
+        return;
+    }
+
+    if (committing && done) {
+        [self deliver];
+    }
+
+    // Changes from statements that failed outside of a transaction are
+    // discarded, i.e. they are not delivered with the next commit.
+    if ([_levels count] > 1 || [_pending count] > 0) {
+        [self rollback];
+    }
+}
+
+- (void)trackSavepoint:(const char *)sql {
+    // Only savepoint statements are of interest, i.e. the common statements
+    // can be rejected with the first character.
+    const char *rest = sql;
+    while (isspace((unsigned char) *rest)) {
+        rest++;
+    }
+
+    char c = (char) toupper((unsigned char) *rest);
+    if (c != 'S' && c != 'R') {
+        return;
+    }
+
+    NSString *name;
+    NSUInteger index;
+    if ((rest = RASqliteChangeTrackerKeyword(sql, "SAVEPOINT"))) {
+        _pending = [[NSMutableDictionary alloc] init];
+        [_levels addObject:_pending];
+        [_savepoints addObject:RASqliteChangeTrackerName(rest)];
+    } else if ((rest = RASqliteChangeTrackerKeyword(sql, "RELEASE"))) {
+        rest = RASqliteChangeTrackerKeyword(rest, "SAVEPOINT") ?: rest;
+        name = RASqliteChangeTrackerName(rest);
+        index = [_savepoints indexOfObjectWithOptions:NSEnumerationReverse passingTest:^BOOL(id savepoint, NSUInteger i, BOOL *stop) {
+            return [savepoint isEqualToString:name];
+        }];
+        if (index == NSNotFound) {
+            return;
+        }
+
+        // The released savepoint and every savepoint within it are merged
+        // into the enclosing level.
+        [self mergeIntoLevel:index];
+        [_savepoints removeObjectsInRange:NSMakeRange(index, [_savepoints count] - index)];
+    } else if ((rest = RASqliteChangeTrackerKeyword(sql, "ROLLBACK"))) {
+        rest = RASqliteChangeTrackerKeyword(rest, "TRANSACTION") ?: rest;
+        if (!(rest = RASqliteChangeTrackerKeyword(rest, "TO"))) {
+            return;
+        }
+
+        rest = RASqliteChangeTrackerKeyword(rest, "SAVEPOINT") ?: rest;
+        name = RASqliteChangeTrackerName(rest);
+        index = [_savepoints indexOfObjectWithOptions:NSEnumerationReverse passingTest:^BOOL(id savepoint, NSUInteger i, BOOL *stop) {
+            return [savepoint isEqualToString:name];
+        }];
+        if (index == NSNotFound) {
+            return;
+        }
+
+        // The rollback hook is not called when rolling back to a savepoint,
+        // the changes since the savepoint are discarded while the savepoint
+        // remains active.
+        NSUInteger level = index + 1;
+        [_levels removeObjectsInRange:NSMakeRange(level, [_levels count] - level)];
+        [_savepoints removeObjectsInRange:NSMakeRange(level, [_savepoints count] - level)];
+
+        _pending = [[NSMutableDictionary alloc] init];
+        [_levels addObject:_pending];
+    } else {
+        return;
+    }
+
+    // The cached lookup references the pending changes for the previous level.
+    _lastChanges = nil;
+    _lastGeneration = 0;
+}
+
+- (void)mergeIntoLevel:(NSUInteger)level {
+    NSMutableDictionary *target = _levels[level];
+    for (NSUInteger i = level + 1; i < [_levels count]; i++) {
+        NSDictionary *changes = _levels[i];
+        for (NSString *table in changes) {
+            NSArray *existing = target[table];
+            if (!existing) {
+                target[table] = changes[table];
+                continue;
+            }
+
+            for (NSUInteger operation = 0; operation < 3; operation++) {
+                [(NSMutableSet *) existing[operation] unionSet:changes[table][operation]];
+            }
+        }
+    }
+
+    [_levels removeObjectsInRange:NSMakeRange(level + 1, [_levels count] - level - 1)];
+    _pending = target;
+}
+
+- (void)deliver {
+    // Changes within savepoints that have not been released are committed
+    // together with the transaction.
+    [self mergeIntoLevel:0];
+    if ([_pending count] == 0) {
+        return;
+    }
+
+    NSDictionary *pending = _pending;
+    [self rollback];
+
+    for (NSString *table in pending) {
+        NSArray *changes = pending[table];
+
+        pthread_mutex_lock(&_lock);
+        NSArray *observers = [_observers[table] copy];
+        pthread_mutex_unlock(&_lock);
+
+        if ([observers count] == 0) {
+            continue;
+        }
+
+        RASqliteTableChange *change = [[RASqliteTableChange alloc] initWithTable:table
+                                                                        inserted:changes[0]
+                                                                         updated:changes[1]
+                                                                         deleted:changes[2]];
+
+        // The commit have been completed, i.e. queries executed from within
+        // the handler observe the committed rows.
+        for (RASqliteChangeObserver *observer in observers) {
+            dispatch_async([observer queue], ^{
+                if (![observer isRemoved]) {
+                    [observer handler](change);
+                }
+            });
+        }
+    }
+}
+
+@end
@@ -28,6 +28,20 @@ typedef NS_ENUM(short int, RASqliteDataType) {
             RASqliteBlob
 };
 
+// -- -- Compression
+
+/// Available compression algorithms for column values.
+typedef NS_ENUM(short int, RASqliteCompression) {
+    /// Values are stored as is.
+            RASqliteCompressionNone,
+
+    /// Values are compressed with LZ4, i.e. fast with moderate compression, only available on Apple platforms.
+            RASqliteCompressionLZ4,
+
+    /// Values are compressed with zlib, i.e. slower with better compression.
+            RASqliteCompressionZlib
+};
+
 /**
  Defines the column for the table, used while creating and checking structure.
 
@@ -61,6 +75,12 @@ typedef NS_ENUM(short int, RASqliteDataType) {
 /// Stores whether or not the column is nullable.
 @property(nonatomic, getter = isNullable) BOOL nullable;
 
+/// Stores the algorithm used for compressing values, defaults to `RASqliteCompressionNone`.
+@property(nonatomic) RASqliteCompression compression;
+
+/// Stores the minimum size, in bytes, for values to be compressed, defaults to 256.
+@property(nonatomic) NSUInteger compressionThreshold;
+
 #pragma mark - Initialization
 
 /**
@@ -158,4 +178,47 @@ typedef NS_ENUM(short int, RASqliteDataType) {
  */
 - (void)setNullable:(BOOL)nullable;
 
+/**
+ Stores the algorithm used for compressing values.
+
+ @param compression Algorithm used for compressing values.
+
+ @throws NSException If column is not type `RASqliteText` or `RASqliteBlob`.
+ @throws NSException If column is primary key or unique.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ Compressed values are stored as blobs marked with a header, and are
+ decompressed to their original type when fetched, i.e. rows written before
+ compression was enabled are still readable. Values below the threshold, or
+ values that do not shrink, are stored as is.
+
+ @par
+ Compressed columns can only be compared with other compressed values, i.e.
+ they can not be indexed or used within `WHERE` clauses.
+ */
+- (void)setCompression:(RASqliteCompression)compression;
+
+#pragma mark - Binding
+
+/**
+ Prepare the value for binding to the column.
+
+ @param value Value to be bound.
+
+ @return Value to be bound, compressed while binding if the column is compressed.
+
+ @code
+ [rasqlite execute:@"INSERT INTO document(payload) VALUES(?)" withParam:[column bindableValue:payload]];
+ @endcode
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ Values bound with `upsertRows:intoTable:` or imported with
+ `importStream:intoTable:format:` are prepared automatically.
+ */
+- (id)bindableValue:(id)value;
+
 @end
\ No newline at end of file
@@ -11,6 +11,10 @@
 // -- -- Import
 
 #import "RASqlite.h"
+#import "RASqliteCompressor.h"
+
+/// Default minimum size, in bytes, for values to be compressed.
+static const NSUInteger RASqliteCompressionThreshold = 256;
 
 /// Name for `integer` type in SQLite.
 static NSString *_integer = @"INTEGER";
@@ -40,6 +44,9 @@ static NSString *_text = @"TEXT";
     BOOL _autoIncrement;
     BOOL _unique;
     BOOL _nullable;
+
+    RASqliteCompression _compression;
+    NSUInteger _compressionThreshold;
 }
 
 /// Stores the name of the column.
@@ -71,6 +78,10 @@ static NSString *_text = @"TEXT";
 
 @synthesize nullable = _nullable;
 
+@synthesize compression = _compression;
+
+@synthesize compressionThreshold = _compressionThreshold;
+
 #pragma mark - Initialization
 
 - (instancetype)initWithName:(NSString *)name type:(RASqliteDataType)type {
@@ -112,6 +123,9 @@ static NSString *_text = @"TEXT";
         _autoIncrement = NO;
         _unique = NO;
         _nullable = NO;
+
+        _compression = RASqliteCompressionNone;
+        _compressionThreshold = RASqliteCompressionThreshold;
     }
     return self;
 }
@@ -154,6 +168,11 @@ static NSString *_text = @"TEXT";
                     format:@"Primary key columns can not be `nullable`."];
     }
 
+    if (primaryKey && RASqliteCompressionNone != [self compression]) {
+        [NSException raise:RASqliteColumnConstrainException
+                    format:@"Primary key columns can not be compressed."];
+    }
+
     _primaryKey = primaryKey;
 }
 
@@ -173,6 +192,11 @@ static NSString *_text = @"TEXT";
                     format:@"Unique columns can not be `nullable`."];
     }
 
+    if (unique && RASqliteCompressionNone != [self compression]) {
+        [NSException raise:RASqliteColumnConstrainException
+                    format:@"Unique columns can not be compressed."];
+    }
+
     _unique = unique;
 }
 
@@ -190,4 +214,38 @@ static NSString *_text = @"TEXT";
     _nullable = nullable;
 }
 
+- (void)setCompression:(RASqliteCompression)compression {
+    if (RASqliteCompressionNone != compression) {
+        if (RASqliteText != [self numericType] && RASqliteBlob != [self numericType]) {
+            [NSException raise:RASqliteColumnConstrainException
+                        format:@"Compression is only available for `text` and `blob` columns."];
+        }
+
+        // The compressed values can not be compared with uncompressed values,
+        // i.e. the constraints would not be enforced.
+        if ([self isPrimaryKey] || [self isUnique]) {
+            [NSException raise:RASqliteColumnConstrainException
+                        format:@"Compression can not be set to primary key or unique columns."];
+        }
+    }
+
+    _compression = compression;
+}
+
+#pragma mark - Binding
+
+- (id)bindableValue:(id)value {
+    if (RASqliteCompressionNone == [self compression]) {
+        return value;
+    }
+
+    if (![value isKindOfClass:[NSString class]] && ![value isKindOfClass:[NSData class]]) {
+        return value;
+    }
+
+    return [[RASqliteCompressedValue alloc] initWithValue:value
+                                              compression:[self compression]
+                                                threshold:[self compressionThreshold]];
+}
+
 @end
\ No newline at end of file
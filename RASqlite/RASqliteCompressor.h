@@ -0,0 +1,89 @@
+//
+//  RASqliteCompressor.h
+//  RASqlite
+//
+//  Created by Tobias Raatiniemi on 2016-12-30.
+//  Copyright (c) 2016 Raatiniemi. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+#import "RASqliteColumn.h"
+
+/**
+ Compresses and decompresses column values.
+
+ Compressed values are prefixed with a header, consisting of a marker, the
+ algorithm, the original type, and the original length. Values without the
+ header are stored as is, i.e. compressed and uncompressed values can be mixed
+ within the same column.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+@interface RASqliteCompressor : NSObject
+
+/**
+ Compress the value.
+
+ @param value Value to compress, either `NSString` or `NSData`.
+ @param compression Algorithm used for compressing the value.
+ @param threshold Minimum size, in bytes, for the value to be compressed.
+
+ @return Compressed value with header, or `nil` if the value should be stored as is.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ Values below the threshold, values that do not shrink, and values that
+ already have been compressed are not compressed.
+ */
++ (NSData *)compressValue:(id)value compression:(RASqliteCompression)compression threshold:(NSUInteger)threshold;
+
+/**
+ Decompress the value, if it have been compressed.
+
+ @param bytes Bytes for the stored value.
+ @param length Number of bytes for the stored value.
+
+ @return Decompressed `NSString` or `NSData`, or `nil` if the value have not been compressed.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
++ (id)decompressBytes:(const void *)bytes length:(NSUInteger)length;
+
+- (id)init __unavailable;
+
+@end
+
+/**
+ Value that should be compressed while binding.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+@interface RASqliteCompressedValue : NSObject
+
+/// Stores the value to compress.
+@property(strong, nonatomic, readonly) id value;
+
+/// Stores the algorithm used for compressing the value.
+@property(nonatomic, readonly) RASqliteCompression compression;
+
+/// Stores the minimum size, in bytes, for the value to be compressed.
+@property(nonatomic, readonly) NSUInteger threshold;
+
+/**
+ Initialize with the value and the compression settings from the column.
+
+ @param value Value to compress.
+ @param compression Algorithm used for compressing the value.
+ @param threshold Minimum size, in bytes, for the value to be compressed.
+
+ @return Initialized value.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (instancetype)initWithValue:(id)value compression:(RASqliteCompression)compression threshold:(NSUInteger)threshold;
+
+- (id)init __unavailable;
+
+@end
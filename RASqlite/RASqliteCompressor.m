@@ -0,0 +1,269 @@
+//
+//  RASqliteCompressor.m
+//  RASqlite
+//
+//  Created by Tobias Raatiniemi on 2016-12-30.
+//  Copyright (c) 2016 Raatiniemi. All rights reserved.
+//
+
+#import "RASqliteCompressor.h"
+
+#ifdef __APPLE__
+#import <compression.h>
+#else
+#import <zlib.h>
+#endif
+
+/// Marker for compressed values, the leading null byte never occur within text.
+static const uint8_t RASqliteCompressorMarker[] = {0x00, 'R', 'A', 'Z'};
+
+/// Length of the header, i.e. marker, algorithm, type, and original length.
+static const NSUInteger RASqliteCompressorHeaderLength = 10;
+
+/// Type of the original value, stored within the header.
+static const uint8_t RASqliteCompressorText = 't';
+static const uint8_t RASqliteCompressorBlob = 'b';
+
+#ifdef __APPLE__
+
+/**
+ Retrieve the algorithm for the compression library.
+
+ @param compression Algorithm used for compressing values.
+
+ @return Algorithm for the compression library, or zero if not supported.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static compression_algorithm RASqliteCompressorAlgorithm(RASqliteCompression compression) {
+    switch (compression) {
+        case RASqliteCompressionLZ4:
+            return COMPRESSION_LZ4;
+        case RASqliteCompressionZlib:
+            return COMPRESSION_ZLIB;
+        default:
+            return 0;
+    }
+}
+
+#endif
+
+/**
+ Check whether the algorithm is supported on the platform.
+
+ @param compression Algorithm used for compressing values.
+
+ @return `YES` if the algorithm is supported, otherwise `NO`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ LZ4 is only available with the compression library on Apple platforms, on
+ other platforms such values are stored as is and not decompressed.
+ */
+static BOOL RASqliteCompressorIsSupported(RASqliteCompression compression) {
+#ifdef __APPLE__
+    return RASqliteCompressorAlgorithm(compression) != 0;
+#else
+    return compression == RASqliteCompressionZlib;
+#endif
+}
+
+/**
+ Encode the bytes with the algorithm.
+
+ @param compression Algorithm used for compressing the bytes.
+ @param destination Buffer for the compressed bytes.
+ @param capacity Size of the buffer, in bytes.
+ @param source Bytes to compress.
+ @param length Number of bytes to compress.
+
+ @return Number of compressed bytes, or zero if the bytes do not fit within the buffer.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ The compression library uses raw deflate for zlib, i.e. without the zlib
+ header and checksum, and the fallback have to use the same format for values
+ to be readable on every platform.
+ */
+static size_t RASqliteCompressorEncode(RASqliteCompression compression, uint8_t *destination, size_t capacity, const uint8_t *source, size_t length) {
+#ifdef __APPLE__
+    return compression_encode_buffer(destination, capacity, source, length, NULL, RASqliteCompressorAlgorithm(compression));
+#else
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return 0;
+    }
+
+    stream.next_in = (Bytef *) source;
+    stream.avail_in = (uInt) length;
+    stream.next_out = destination;
+    stream.avail_out = (uInt) capacity;
+
+    int code = deflate(&stream, Z_FINISH);
+    size_t size = code == Z_STREAM_END ? stream.total_out : 0;
+    deflateEnd(&stream);
+
+    return size;
+#endif
+}
+
+/**
+ Decode the bytes with the algorithm.
+
+ @param compression Algorithm used for compressing the bytes.
+ @param destination Buffer for the decompressed bytes.
+ @param capacity Size of the buffer, in bytes.
+ @param source Compressed bytes.
+ @param length Number of compressed bytes.
+
+ @return Number of decompressed bytes, or zero if the bytes could not be decompressed.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static size_t RASqliteCompressorDecode(RASqliteCompression compression, uint8_t *destination, size_t capacity, const uint8_t *source, size_t length) {
+#ifdef __APPLE__
+    return compression_decode_buffer(destination, capacity, source, length, NULL, RASqliteCompressorAlgorithm(compression));
+#else
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    if (inflateInit2(&stream, -MAX_WBITS) != Z_OK) {
+        return 0;
+    }
+
+    stream.next_in = (Bytef *) source;
+    stream.avail_in = (uInt) length;
+    stream.next_out = destination;
+    stream.avail_out = (uInt) capacity;
+
+    int code = inflate(&stream, Z_FINISH);
+    size_t size = code == Z_STREAM_END ? stream.total_out : 0;
+    inflateEnd(&stream);
+
+    return size;
+#endif
+}
+
+/**
+ Check whether the bytes are prefixed with the compression marker.
+
+ @param bytes Bytes for the value.
+ @param length Number of bytes for the value.
+
+ @return `YES` if the bytes are prefixed with the marker, otherwise `NO`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static BOOL RASqliteCompressorHasMarker(const void *bytes, NSUInteger length) {
+    return length >= RASqliteCompressorHeaderLength
+            && memcmp(bytes, RASqliteCompressorMarker, sizeof(RASqliteCompressorMarker)) == 0;
+}
+
+@implementation RASqliteCompressor
+
++ (NSData *)compressValue:(id)value compression:(RASqliteCompression)compression threshold:(NSUInteger)threshold {
+    if (!RASqliteCompressorIsSupported(compression)) {
+        return nil;
+    }
+
+    NSData *data;
+    uint8_t type;
+    if ([value isKindOfClass:[NSString class]]) {
+        data = [value dataUsingEncoding:NSUTF8StringEncoding];
+        type = RASqliteCompressorText;
+    } else if ([value isKindOfClass:[NSData class]]) {
+        data = value;
+        type = RASqliteCompressorBlob;
+    } else {
+        return nil;
+    }
+
+    // Values that already have been compressed, e.g. imported from an export
+    // of the raw column, should not be compressed again.
+    NSUInteger length = [data length];
+    if (length < threshold || length <= RASqliteCompressorHeaderLength || length > UINT32_MAX
+            || RASqliteCompressorHasMarker([data bytes], length)) {
+        return nil;
+    }
+
+    // The compressed value have to be smaller than the original value,
+    // including the header, otherwise it is stored as is.
+    NSMutableData *compressed = [[NSMutableData alloc] initWithLength:length];
+    uint8_t *bytes = [compressed mutableBytes];
+
+    size_t size = RASqliteCompressorEncode(compression,
+                                           bytes + RASqliteCompressorHeaderLength,
+                                           length - RASqliteCompressorHeaderLength,
+                                           [data bytes],
+                                           length);
+    if (size == 0) {
+        return nil;
+    }
+
+    memcpy(bytes, RASqliteCompressorMarker, sizeof(RASqliteCompressorMarker));
+    bytes[4] = (uint8_t) compression;
+    bytes[5] = type;
+
+    uint32_t original = NSSwapHostIntToBig((uint32_t) length);
+    memcpy(bytes + 6, &original, sizeof(original));
+
+    [compressed setLength:RASqliteCompressorHeaderLength + size];
+    return compressed;
+}
+
++ (id)decompressBytes:(const void *)bytes length:(NSUInteger)length {
+    if (!RASqliteCompressorHasMarker(bytes, length)) {
+        return nil;
+    }
+
+    const uint8_t *header = bytes;
+    RASqliteCompression compression = (RASqliteCompression) header[4];
+    uint8_t type = header[5];
+    if (!RASqliteCompressorIsSupported(compression) || (type != RASqliteCompressorText && type != RASqliteCompressorBlob)) {
+        return nil;
+    }
+
+    uint32_t original;
+    memcpy(&original, header + 6, sizeof(original));
+    original = NSSwapBigIntToHost(original);
+    if (original == 0) {
+        return nil;
+    }
+
+    NSMutableData *data = [[NSMutableData alloc] initWithLength:original];
+    size_t size = RASqliteCompressorDecode(compression,
+                                           [data mutableBytes],
+                                           original,
+                                           header + RASqliteCompressorHeaderLength,
+                                           length - RASqliteCompressorHeaderLength);
+
+    // Values that can not be decompressed to their original length are not
+    // considered to be compressed, i.e. blobs that happen to have the marker.
+    if (size != original) {
+        return nil;
+    }
+
+    if (type == RASqliteCompressorText) {
+        return [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding];
+    }
+
+    return data;
+}
+
+@end
+
+@implementation RASqliteCompressedValue
+
+- (instancetype)initWithValue:(id)value compression:(RASqliteCompression)compression threshold:(NSUInteger)threshold {
+    if (self = [super init]) {
+        _value = value;
+        _compression = compression;
+        _threshold = threshold;
+    }
+
+    return self;
+}
+
+@end
@@ -0,0 +1,76 @@
+//
+//  RASqliteFullTextOptions.h
+//  RASqlite
+//
+//  Created by Tobias Raatiniemi on 2016-12-24.
+//  Copyright (c) 2016 Raatiniemi. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ Defines the table as an FTS5 full-text table, used while creating and checking structure.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ The options are defined together with the columns within the table structure,
+ i.e. the columns are the indexed columns and their data types are ignored.
+
+ @par
+ With a content table the full-text table only stores the index, the content is
+ read from the content table and the index is kept in sync with triggers on the
+ content table. The content table have to be defined within the same structure.
+
+ @code
+ RASqliteFullTextOptions *options = [[RASqliteFullTextOptions alloc] init];
+ [options setContentTable:@"user"];
+ [options setContentRowid:@"id"];
+
+ @{@"user_search": @[RAColumn(@"name", RASqliteText), RAColumn(@"email", RASqliteText), options]};
+ @endcode
+ */
+@interface RASqliteFullTextOptions : NSObject
+
+/// Stores the name of the external content table, or `nil` to store the content.
+@property(copy, nonatomic) NSString *contentTable;
+
+/// Stores the name of the integer primary key within the content table, `rowid` by default.
+@property(copy, nonatomic) NSString *contentRowid;
+
+/// Stores the tokenizer, e.g. `unicode61 remove_diacritics 2`.
+@property(copy, nonatomic) NSString *tokenizer;
+
+/// Stores the lengths of the prefix indexes, e.g. `@[@2, @3]` for type-ahead search.
+@property(copy, nonatomic) NSArray *prefixes;
+
+#pragma mark - Definition
+
+/**
+ Build the table definition, i.e. the table name followed by the module arguments.
+
+ @param table Name of the full-text table.
+ @param columns Names of the indexed columns, in order.
+
+ @return Definition for the table, used with `CREATE VIRTUAL TABLE`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (NSString *)definitionForTable:(NSString *)table columns:(NSArray *)columns;
+
+/**
+ Build the triggers keeping the index in sync with the content table.
+
+ @param table Name of the full-text table.
+ @param columns Names of the indexed columns, in order.
+
+ @return Trigger definitions keyed by the trigger name, used with `CREATE TRIGGER`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ Without content table there are no triggers, i.e. an empty dictionary is returned.
+ */
+- (NSDictionary *)triggersForTable:(NSString *)table columns:(NSArray *)columns;
+
+@end
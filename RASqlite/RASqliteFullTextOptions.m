@@ -0,0 +1,103 @@
+//
+//  RASqliteFullTextOptions.m
+//  RASqlite
+//
+//  Created by Tobias Raatiniemi on 2016-12-24.
+//  Copyright (c) 2016 Raatiniemi. All rights reserved.
+//
+
+#import "RASqliteFullTextOptions.h"
+
+// -- -- Import
+
+#import "RASqlite.h"
+
+/**
+ Quote value as an SQL string literal.
+
+ @param value Value to quote.
+
+ @return Quoted value, with the single quotes escaped.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static NSString *RASqliteQuote(NSString *value) {
+    return RASqliteSF(@"'%@'", [value stringByReplacingOccurrencesOfString:@"'" withString:@"''"]);
+}
+
+@interface RASqliteFullTextOptions () {
+@private
+    NSString *_contentTable;
+    NSString *_contentRowid;
+    NSString *_tokenizer;
+    NSArray *_prefixes;
+}
+
+@end
+
+@implementation RASqliteFullTextOptions
+
+@synthesize contentTable = _contentTable;
+
+@synthesize contentRowid = _contentRowid;
+
+@synthesize tokenizer = _tokenizer;
+
+@synthesize prefixes = _prefixes;
+
+#pragma mark - Definition
+
+- (NSString *)definitionForTable:(NSString *)table columns:(NSArray *)columns {
+    NSMutableArray *arguments = [[NSMutableArray alloc] initWithArray:columns];
+
+    if ([self contentTable]) {
+        [arguments addObject:RASqliteSF(@"content=%@", RASqliteQuote([self contentTable]))];
+
+        if ([self contentRowid]) {
+            [arguments addObject:RASqliteSF(@"content_rowid=%@", RASqliteQuote([self contentRowid]))];
+        }
+    }
+
+    if ([self tokenizer]) {
+        [arguments addObject:RASqliteSF(@"tokenize=%@", RASqliteQuote([self tokenizer]))];
+    }
+
+    if ([[self prefixes] count] > 0) {
+        NSString *prefixes = [[self prefixes] componentsJoinedByString:@" "];
+        [arguments addObject:RASqliteSF(@"prefix=%@", RASqliteQuote(prefixes))];
+    }
+
+    return RASqliteSF(@"%@ USING fts5(%@)", table, [arguments componentsJoinedByString:@", "]);
+}
+
+- (NSDictionary *)triggersForTable:(NSString *)table columns:(NSArray *)columns {
+    NSString *content = [self contentTable];
+    if (!content) {
+        return @{};
+    }
+
+    NSString *rowid = [self contentRowid] ?: @"rowid";
+    NSString *list = [columns componentsJoinedByString:@", "];
+
+    NSMutableArray *newValues = [[NSMutableArray alloc] initWithObjects:RASqliteSF(@"new.%@", rowid), nil];
+    NSMutableArray *oldValues = [[NSMutableArray alloc] initWithObjects:RASqliteSF(@"old.%@", rowid), nil];
+    for (NSString *column in columns) {
+        [newValues addObject:RASqliteSF(@"new.%@", column)];
+        [oldValues addObject:RASqliteSF(@"old.%@", column)];
+    }
+
+    // Rows are removed from an external content index by inserting the old
+    // values with the special `delete` command.
+    NSString *insert = RASqliteSF(@"INSERT INTO %@(rowid, %@) VALUES(%@);",
+            table, list, [newValues componentsJoinedByString:@", "]);
+    NSString *delete = RASqliteSF(@"INSERT INTO %@(%@, rowid, %@) VALUES('delete', %@);",
+            table, table, list, [oldValues componentsJoinedByString:@", "]);
+
+    return @{
+            RASqliteSF(@"%@_ai", table): RASqliteSF(@"%@_ai AFTER INSERT ON %@ BEGIN %@ END", table, content, insert),
+            RASqliteSF(@"%@_ad", table): RASqliteSF(@"%@_ad AFTER DELETE ON %@ BEGIN %@ END", table, content, delete),
+            RASqliteSF(@"%@_au", table): RASqliteSF(@"%@_au AFTER UPDATE ON %@ BEGIN %@ %@ END", table, content, delete, insert)
+    };
+}
+
+@end
@@ -0,0 +1,93 @@
+//
+//  RASqliteFunction.h
+//  RASqlite
+//
+//  Created by Tobias Raatiniemi on 2016-12-28.
+//  Copyright (c) 2016 Raatiniemi. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import <sqlite3.h>
+
+#import "RASqliteFunctionArguments.h"
+
+/**
+ Definition of a custom SQL function, registered on every opened connection.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ Exceptions raised by the blocks are caught and reported as an error for the
+ query, since they can not be unwound through SQLite.
+ */
+@interface RASqliteFunction : NSObject
+
+/// Stores the name of the function.
+@property(copy, nonatomic, readonly) NSString *name;
+
+/// Stores the number of arguments, or -1 for any number of arguments.
+@property(nonatomic, readonly) int arity;
+
+/// Stores whether the function always returns the same result for the same arguments.
+@property(nonatomic, readonly, getter=isDeterministic) BOOL deterministic;
+
+#pragma mark - Initialization
+
+/**
+ Initialize scalar function.
+
+ @param name Name of the function.
+ @param arity Number of arguments, or -1 for any number of arguments.
+ @param deterministic Whether the function always returns the same result for the same arguments.
+ @param block Block implementing the function.
+
+ @return Initialized function.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (instancetype)initWithName:(NSString *)name arity:(int)arity deterministic:(BOOL)deterministic block:(RASqliteFunctionBlock)block;
+
+/**
+ Initialize aggregate function.
+
+ @param name Name of the function.
+ @param arity Number of arguments, or -1 for any number of arguments.
+ @param deterministic Whether the function always returns the same result for the same arguments.
+ @param step Block called for every aggregated row.
+ @param final Block calculating the result for the group.
+
+ @return Initialized function.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (instancetype)initWithName:(NSString *)name arity:(int)arity deterministic:(BOOL)deterministic step:(RASqliteAggregateStepBlock)step final:(RASqliteAggregateFinalBlock)final;
+
+- (id)init __unavailable;
+
+#pragma mark - Registration
+
+/**
+ Key identifying the function, functions are overloaded by the number of arguments.
+
+ @return Key for the function.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (NSString *)key;
+
+/**
+ Register the function on the database connection.
+
+ @param database Database connection.
+
+ @return Result code from `sqlite3_create_function_v2`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ The function is retained by the connection until it is replaced or the
+ connection is closed.
+ */
+- (int)registerWithDatabase:(sqlite3 *)database;
+
+@end
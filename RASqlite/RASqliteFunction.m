@@ -0,0 +1,246 @@
+//
+//  RASqliteFunction.m
+//  RASqlite
+//
+//  Created by Tobias Raatiniemi on 2016-12-28.
+//  Copyright (c) 2016 Raatiniemi. All rights reserved.
+//
+
+#import "RASqliteFunction.h"
+
+@interface RASqliteFunction () {
+@private
+    RASqliteFunctionBlock _block;
+    RASqliteAggregateStepBlock _step;
+    RASqliteAggregateFinalBlock _final;
+}
+
+/**
+ Call the scalar function.
+
+ @param context Context for the function result.
+ @param count Number of arguments.
+ @param values Arguments passed to the function.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)callWithContext:(sqlite3_context *)context count:(int)count values:(sqlite3_value **)values;
+
+/**
+ Call the step block for the aggregated row.
+
+ @param context Context for the aggregated group.
+ @param count Number of arguments.
+ @param values Arguments passed to the function.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)stepWithContext:(sqlite3_context *)context count:(int)count values:(sqlite3_value **)values;
+
+/**
+ Call the final block for the aggregated group.
+
+ @param context Context for the aggregated group.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)finalWithContext:(sqlite3_context *)context;
+
+@end
+
+/**
+ Set the result for the function from an object.
+
+ @param context Context for the function result.
+ @param result Result from the function block.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static void RASqliteFunctionResult(sqlite3_context *context, id result) {
+    if (!result || [result isKindOfClass:[NSNull class]]) {
+        sqlite3_result_null(context);
+        return;
+    }
+
+    if ([result isKindOfClass:[NSString class]]) {
+        sqlite3_result_text(context, [result UTF8String], -1, SQLITE_TRANSIENT);
+        return;
+    }
+
+    if ([result isKindOfClass:[NSNumber class]]) {
+        const char *type = [result objCType];
+        if (strcmp(type, @encode(double)) == 0 || strcmp(type, @encode(float)) == 0) {
+            sqlite3_result_double(context, [result doubleValue]);
+            return;
+        }
+
+        sqlite3_result_int64(context, [result longLongValue]);
+        return;
+    }
+
+    if ([result isKindOfClass:[NSData class]]) {
+        sqlite3_result_blob(context, [result bytes], (int) [result length], SQLITE_TRANSIENT);
+        return;
+    }
+
+    if ([result isKindOfClass:[NSError class]]) {
+        sqlite3_result_error(context, [[result localizedDescription] UTF8String], -1);
+        return;
+    }
+
+    NSString *message = [NSString stringWithFormat:@"Unable to return type `%@` from function.", [result class]];
+    sqlite3_result_error(context, [message UTF8String], -1);
+}
+
+/**
+ Callback for the scalar function.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static void RASqliteFunctionCall(sqlite3_context *context, int count, sqlite3_value **values) {
+    RASqliteFunction *function = (__bridge RASqliteFunction *) sqlite3_user_data(context);
+    [function callWithContext:context count:count values:values];
+}
+
+/**
+ Callback for every row aggregated by the function.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static void RASqliteFunctionStep(sqlite3_context *context, int count, sqlite3_value **values) {
+    RASqliteFunction *function = (__bridge RASqliteFunction *) sqlite3_user_data(context);
+    [function stepWithContext:context count:count values:values];
+}
+
+/**
+ Callback for the result of the aggregated group.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static void RASqliteFunctionFinal(sqlite3_context *context) {
+    RASqliteFunction *function = (__bridge RASqliteFunction *) sqlite3_user_data(context);
+    [function finalWithContext:context];
+}
+
+/**
+ Callback for when the function is removed from the connection.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static void RASqliteFunctionDestroy(void *function) {
+    CFBridgingRelease(function);
+}
+
+@implementation RASqliteFunction
+
+#pragma mark - Initialization
+
+- (instancetype)initWithName:(NSString *)name arity:(int)arity deterministic:(BOOL)deterministic block:(RASqliteFunctionBlock)block {
+    if (self = [super init]) {
+        _name = [name copy];
+        _arity = arity;
+        _deterministic = deterministic;
+        _block = [block copy];
+    }
+
+    return self;
+}
+
+- (instancetype)initWithName:(NSString *)name arity:(int)arity deterministic:(BOOL)deterministic step:(RASqliteAggregateStepBlock)step final:(RASqliteAggregateFinalBlock)final {
+    if (self = [super init]) {
+        _name = [name copy];
+        _arity = arity;
+        _deterministic = deterministic;
+        _step = [step copy];
+        _final = [final copy];
+    }
+
+    return self;
+}
+
+#pragma mark - Registration
+
+- (NSString *)key {
+    return [NSString stringWithFormat:@"%@/%d", [[self name] lowercaseString], [self arity]];
+}
+
+- (int)registerWithDatabase:(sqlite3 *)database {
+    int flags = SQLITE_UTF8;
+    if (_deterministic) {
+        flags |= SQLITE_DETERMINISTIC;
+    }
+
+    // The function is released by the destroy callback, which is also called
+    // if the registration fails.
+    void *function = (void *) CFBridgingRetain(self);
+    if (_block) {
+        return sqlite3_create_function_v2(database, [[self name] UTF8String], [self arity], flags, function,
+                                          RASqliteFunctionCall, NULL, NULL, RASqliteFunctionDestroy);
+    }
+
+    return sqlite3_create_function_v2(database, [[self name] UTF8String], [self arity], flags, function,
+                                      NULL, RASqliteFunctionStep, RASqliteFunctionFinal, RASqliteFunctionDestroy);
+}
+
+#pragma mark - Call
+
+- (void)callWithContext:(sqlite3_context *)context count:(int)count values:(sqlite3_value **)values {
+    @autoreleasepool {
+        @try {
+            RASqliteFunctionArguments *arguments = [[RASqliteFunctionArguments alloc] initWithValues:values count:count];
+            RASqliteFunctionResult(context, _block(arguments));
+        } @catch (NSException *exception) {
+            sqlite3_result_error(context, [[exception reason] UTF8String], -1);
+        }
+    }
+}
+
+- (void)stepWithContext:(sqlite3_context *)context count:(int)count values:(sqlite3_value **)values {
+    // The aggregate context is zeroed by SQLite when allocated, i.e. the state
+    // is created with the first aggregated row.
+    void **state = sqlite3_aggregate_context(context, sizeof(void *));
+    if (!state) {
+        sqlite3_result_error_nomem(context);
+        return;
+    }
+
+    @autoreleasepool {
+        if (!*state) {
+            *state = (void *) CFBridgingRetain([[NSMutableDictionary alloc] init]);
+        }
+
+        @try {
+            RASqliteFunctionArguments *arguments = [[RASqliteFunctionArguments alloc] initWithValues:values count:count];
+            _step((__bridge NSMutableDictionary *) *state, arguments);
+        } @catch (NSException *exception) {
+            sqlite3_result_error(context, [[exception reason] UTF8String], -1);
+        }
+    }
+}
+
+- (void)finalWithContext:(sqlite3_context *)context {
+    // Without any aggregated rows the context have not been allocated.
+    void **state = sqlite3_aggregate_context(context, 0);
+
+    @autoreleasepool {
+        NSMutableDictionary *group;
+        if (state && *state) {
+            group = CFBridgingRelease(*state);
+            *state = NULL;
+        } else {
+            group = [[NSMutableDictionary alloc] init];
+        }
+
+        @try {
+            RASqliteFunctionResult(context, _final(group));
+        } @catch (NSException *exception) {
+            sqlite3_result_error(context, [[exception reason] UTF8String], -1);
+        }
+    }
+}
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"<%@: %@, arity: %d>", [self class], [self name], [self arity]];
+}
+
+@end
@@ -0,0 +1,151 @@
+//
+//  RASqliteFunctionArguments.h
+//  RASqlite
+//
+//  Created by Tobias Raatiniemi on 2016-12-28.
+//  Copyright (c) 2016 Raatiniemi. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import <sqlite3.h>
+
+@class RASqliteFunctionArguments;
+
+/**
+ Block implementing a scalar SQL function.
+
+ @param arguments Arguments passed to the function.
+
+ @return Result of the function, i.e. `NSNumber`, `NSString`, `NSData`, or `nil`
+ for `NULL`. Returning an `NSError` fails the query with its description.
+ */
+typedef id (^RASqliteFunctionBlock)(RASqliteFunctionArguments *arguments);
+
+/**
+ Block called for every row aggregated by an SQL function.
+
+ @param context Mutable state for the aggregated group, starts out empty.
+ @param arguments Arguments passed to the function for the row.
+ */
+typedef void (^RASqliteAggregateStepBlock)(NSMutableDictionary *context, RASqliteFunctionArguments *arguments);
+
+/**
+ Block calculating the result for an aggregated group.
+
+ @param context State for the aggregated group, empty if no rows were aggregated.
+
+ @return Result of the function, with the same types as `RASqliteFunctionBlock`.
+ */
+typedef id (^RASqliteAggregateFinalBlock)(NSMutableDictionary *context);
+
+/**
+ Accessor for the arguments passed to an SQL function.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ The values are read directly from SQLite when requested, i.e. numeric
+ arguments are not boxed unless retrieved with `objectAtIndex:`. The accessor
+ is only valid while the function block is executing.
+ */
+@interface RASqliteFunctionArguments : NSObject
+
+/// Stores the number of arguments.
+@property(nonatomic, readonly) NSUInteger count;
+
+#pragma mark - Initialization
+
+/**
+ Initialize with the values passed to the function.
+
+ @param values Values passed to the function.
+ @param count Number of values.
+
+ @return Initialized arguments.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (instancetype)initWithValues:(sqlite3_value **)values count:(int)count;
+
+- (id)init __unavailable;
+
+#pragma mark - Value
+
+/**
+ Retrieve the datatype of the argument.
+
+ @param index Index of the argument.
+
+ @return Datatype of the argument, e.g. `SQLITE_INTEGER` or `SQLITE_NULL`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (int)typeAtIndex:(NSUInteger)index;
+
+/**
+ Check whether the argument is `NULL`.
+
+ @param index Index of the argument.
+
+ @return `YES` if the argument is `NULL`, otherwise `NO`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (BOOL)isNullAtIndex:(NSUInteger)index;
+
+/**
+ Retrieve the argument as an integer.
+
+ @param index Index of the argument.
+
+ @return Integer value of the argument, converted by SQLite if necessary.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (sqlite3_int64)integerAtIndex:(NSUInteger)index;
+
+/**
+ Retrieve the argument as a double.
+
+ @param index Index of the argument.
+
+ @return Double value of the argument, converted by SQLite if necessary.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (double)doubleAtIndex:(NSUInteger)index;
+
+/**
+ Retrieve the argument as text.
+
+ @param index Index of the argument.
+
+ @return Text value of the argument, or `nil` if the argument is `NULL`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (NSString *)textAtIndex:(NSUInteger)index;
+
+/**
+ Retrieve the argument as data.
+
+ @param index Index of the argument.
+
+ @return Blob value of the argument, or `nil` if the argument is `NULL`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (NSData *)dataAtIndex:(NSUInteger)index;
+
+/**
+ Retrieve the argument as an object, depending on its datatype.
+
+ @param index Index of the argument.
+
+ @return `NSNumber`, `NSString`, `NSData`, or `NSNull`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (id)objectAtIndex:(NSUInteger)index;
+
+@end
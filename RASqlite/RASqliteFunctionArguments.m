@@ -0,0 +1,109 @@
+//
+//  RASqliteFunctionArguments.m
+//  RASqlite
+//
+//  Created by Tobias Raatiniemi on 2016-12-28.
+//  Copyright (c) 2016 Raatiniemi. All rights reserved.
+//
+
+#import "RASqliteFunctionArguments.h"
+
+@interface RASqliteFunctionArguments () {
+@private
+    sqlite3_value **_values;
+}
+
+/**
+ Retrieve the value for the argument.
+
+ @param index Index of the argument.
+
+ @return Value for the argument.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (sqlite3_value *)valueAtIndex:(NSUInteger)index;
+
+@end
+
+@implementation RASqliteFunctionArguments
+
+#pragma mark - Initialization
+
+- (instancetype)initWithValues:(sqlite3_value **)values count:(int)count {
+    if (self = [super init]) {
+        _values = values;
+        _count = (NSUInteger) count;
+    }
+
+    return self;
+}
+
+#pragma mark - Value
+
+- (sqlite3_value *)valueAtIndex:(NSUInteger)index {
+    if (index >= _count) {
+        [NSException raise:NSRangeException
+                    format:@"Index %lu is beyond the %lu arguments.", (unsigned long) index, (unsigned long) _count];
+    }
+
+    return _values[index];
+}
+
+- (int)typeAtIndex:(NSUInteger)index {
+    return sqlite3_value_type([self valueAtIndex:index]);
+}
+
+- (BOOL)isNullAtIndex:(NSUInteger)index {
+    return [self typeAtIndex:index] == SQLITE_NULL;
+}
+
+- (sqlite3_int64)integerAtIndex:(NSUInteger)index {
+    return sqlite3_value_int64([self valueAtIndex:index]);
+}
+
+- (double)doubleAtIndex:(NSUInteger)index {
+    return sqlite3_value_double([self valueAtIndex:index]);
+}
+
+- (NSString *)textAtIndex:(NSUInteger)index {
+    sqlite3_value *value = [self valueAtIndex:index];
+
+    const unsigned char *text = sqlite3_value_text(value);
+    if (!text) {
+        return nil;
+    }
+
+    return [[NSString alloc] initWithBytes:text
+                                    length:(NSUInteger) sqlite3_value_bytes(value)
+                                  encoding:NSUTF8StringEncoding];
+}
+
+- (NSData *)dataAtIndex:(NSUInteger)index {
+    sqlite3_value *value = [self valueAtIndex:index];
+    if (sqlite3_value_type(value) == SQLITE_NULL) {
+        return nil;
+    }
+
+    // The length have to be retrieved after the blob, since retrieving the
+    // blob might convert the value.
+    const void *bytes = sqlite3_value_blob(value);
+    return [NSData dataWithBytes:bytes length:(NSUInteger) sqlite3_value_bytes(value)];
+}
+
+- (id)objectAtIndex:(NSUInteger)index {
+    switch ([self typeAtIndex:index]) {
+        case SQLITE_INTEGER:
+            return @([self integerAtIndex:index]);
+        case SQLITE_FLOAT:
+            return @([self doubleAtIndex:index]);
+        case SQLITE_TEXT:
+            return [self textAtIndex:index];
+        case SQLITE_BLOB:
+            return [self dataAtIndex:index];
+        default:
+            return [NSNull null];
+    }
+}
+
+@end
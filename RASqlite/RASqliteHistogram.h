@@ -0,0 +1,95 @@
+//
+//  RASqliteHistogram.h
+//  RASqlite
+//
+//  Created by Tobias Raatiniemi on 2016-12-17.
+//  Copyright (c) 2016 Raatiniemi. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import <time.h>
+
+/**
+ Retrieve the current time from the monotonic clock.
+
+ @return Current time in nanoseconds, only useful for measuring durations.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+NS_INLINE uint64_t RASqliteTimestamp(void) {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return (uint64_t) time.tv_sec * 1000000000ull + (uint64_t) time.tv_nsec;
+}
+
+/**
+ Histogram for recording durations, or other non-negative values.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ Values are recorded with atomic counters into logarithmic buckets, each power
+ of two is divided into eight buckets. I.e. recording is lock-free and can be
+ done from any thread, and percentiles have a relative error of at most 12.5%.
+ */
+@interface RASqliteHistogram : NSObject
+
+/**
+ Record value within the histogram.
+
+ @param value Value to record, e.g. duration in nanoseconds.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)recordValue:(uint64_t)value;
+
+/**
+ Retrieve the number of recorded values.
+
+ @return Number of recorded values.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (uint64_t)count;
+
+/**
+ Retrieve the sum of the recorded values.
+
+ @return Sum of the recorded values.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (uint64_t)sum;
+
+/**
+ Retrieve the largest recorded value.
+
+ @return Largest recorded value, or zero if none have been recorded.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (uint64_t)maximum;
+
+/**
+ Retrieve the value at percentile.
+
+ @param percentile Percentile, between `0` and `100`, e.g. `99.9`.
+
+ @return Approximated value at the percentile, or zero if none have been recorded.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (uint64_t)valueAtPercentile:(double)percentile;
+
+/**
+ Remove the recorded values.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ Values recorded concurrently with the reset might be partially retained.
+ */
+- (void)reset;
+
+@end
@@ -0,0 +1,152 @@
+//
+//  RASqliteHistogram.m
+//  RASqlite
+//
+//  Created by Tobias Raatiniemi on 2016-12-17.
+//  Copyright (c) 2016 Raatiniemi. All rights reserved.
+//
+
+#import "RASqliteHistogram.h"
+
+#import <stdatomic.h>
+
+/// Number of sub-buckets for each power of two, have to be a power of two.
+static const unsigned int RASqliteHistogramSubBucketBits = 3;
+
+/// Number of buckets required to cover every 64-bit value.
+#define RASqliteHistogramBucketCount ((64 - 2) << 3)
+
+/// Storage for the atomic counters.
+typedef struct {
+    _Atomic(uint64_t) count;
+    _Atomic(uint64_t) sum;
+    _Atomic(uint64_t) maximum;
+    _Atomic(uint64_t) buckets[RASqliteHistogramBucketCount];
+} RASqliteHistogramData;
+
+/**
+ Retrieve the bucket index for the value.
+
+ @param value Value to retrieve the bucket index for.
+
+ @return Index of the bucket.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static inline unsigned int RASqliteHistogramBucket(uint64_t value) {
+    // Values smaller than the number of sub-buckets are stored exactly.
+    if (value < (1u << RASqliteHistogramSubBucketBits)) {
+        return (unsigned int) value;
+    }
+
+    unsigned int msb = 63 - (unsigned int) __builtin_clzll(value);
+    unsigned int shift = msb - RASqliteHistogramSubBucketBits;
+    unsigned int sub = (unsigned int) (value >> shift) & ((1u << RASqliteHistogramSubBucketBits) - 1);
+
+    return ((shift + 1) << RASqliteHistogramSubBucketBits) + sub;
+}
+
+/**
+ Retrieve the midpoint value for the bucket.
+
+ @param bucket Index of the bucket.
+
+ @return Value in the middle of the bucket range.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static inline uint64_t RASqliteHistogramBucketValue(unsigned int bucket) {
+    unsigned int count = 1u << RASqliteHistogramSubBucketBits;
+    if (bucket < count) {
+        return bucket;
+    }
+
+    unsigned int shift = (bucket >> RASqliteHistogramSubBucketBits) - 1;
+    uint64_t lower = (uint64_t) (count + (bucket & (count - 1))) << shift;
+
+    return lower + (((uint64_t) 1 << shift) >> 1);
+}
+
+@interface RASqliteHistogram () {
+@private
+    RASqliteHistogramData *_data;
+}
+
+@end
+
+@implementation RASqliteHistogram
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _data = calloc(1, sizeof(RASqliteHistogramData));
+    }
+
+    return self;
+}
+
+- (void)dealloc {
+    free(_data);
+}
+
+- (void)recordValue:(uint64_t)value {
+    atomic_fetch_add_explicit(&_data->buckets[RASqliteHistogramBucket(value)], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&_data->sum, value, memory_order_relaxed);
+
+    uint64_t maximum = atomic_load_explicit(&_data->maximum, memory_order_relaxed);
+    while (value > maximum) {
+        if (atomic_compare_exchange_weak_explicit(&_data->maximum, &maximum, value, memory_order_relaxed, memory_order_relaxed)) {
+            break;
+        }
+    }
+
+    // The count is incremented last, i.e. readers never see more values
+    // counted than what have been stored within the buckets.
+    atomic_fetch_add_explicit(&_data->count, 1, memory_order_release);
+}
+
+- (uint64_t)count {
+    return atomic_load_explicit(&_data->count, memory_order_acquire);
+}
+
+- (uint64_t)sum {
+    return atomic_load_explicit(&_data->sum, memory_order_relaxed);
+}
+
+- (uint64_t)maximum {
+    return atomic_load_explicit(&_data->maximum, memory_order_relaxed);
+}
+
+- (uint64_t)valueAtPercentile:(double)percentile {
+    uint64_t count = [self count];
+    if (count == 0) {
+        return 0;
+    }
+
+    percentile = MAX(0.0, MIN(100.0, percentile));
+    uint64_t target = (uint64_t) ceil(percentile / 100.0 * count);
+    if (target == 0) {
+        target = 1;
+    }
+
+    uint64_t seen = 0;
+    for (unsigned int bucket = 0; bucket < RASqliteHistogramBucketCount; bucket++) {
+        seen += atomic_load_explicit(&_data->buckets[bucket], memory_order_relaxed);
+        if (seen >= target) {
+            return MIN(RASqliteHistogramBucketValue(bucket), [self maximum]);
+        }
+    }
+
+    return [self maximum];
+}
+
+- (void)reset {
+    atomic_store_explicit(&_data->count, 0, memory_order_relaxed);
+    atomic_store_explicit(&_data->sum, 0, memory_order_relaxed);
+    atomic_store_explicit(&_data->maximum, 0, memory_order_relaxed);
+
+    for (unsigned int bucket = 0; bucket < RASqliteHistogramBucketCount; bucket++) {
+        atomic_store_explicit(&_data->buckets[bucket], 0, memory_order_relaxed);
+    }
+}
+
+@end
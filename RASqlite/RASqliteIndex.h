@@ -0,0 +1,81 @@
+//
+//  RASqliteIndex.h
+//  RASqlite
+//
+//  Created by Tobias Raatiniemi on 2016-12-04.
+//  Copyright (c) 2016 Raatiniemi. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ Defines the index for the table, used while creating and checking structure.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ Indexes are defined together with the columns within the table structure, i.e.
+ the array for the table can contain both `RASqliteColumn` and `RASqliteIndex`.
+ */
+@interface RASqliteIndex : NSObject
+
+/// Stores the name of the index.
+@property(strong, atomic, readonly) NSString *name;
+
+/// Stores the names of the indexed columns, in order.
+@property(copy, atomic, readonly) NSArray *columns;
+
+/// Stores the names of the columns appended to make the index covering.
+@property(copy, nonatomic) NSArray *coveringColumns;
+
+/// Stores the condition for partial indexes, i.e. the `WHERE` expression.
+@property(copy, nonatomic) NSString *condition;
+
+/// Stores whether or not the index is unique.
+@property(nonatomic, getter = isUnique) BOOL unique;
+
+#pragma mark - Initialization
+
+/**
+ Initialize with index name and columns.
+
+ @param name Name of the index.
+ @param columns Names of the indexed columns, in order.
+
+ @code
+ [[RASqliteIndex alloc] initWithName:@"user_name" columns:@[@"name"]];
+ @endcode
+
+ @throws NSInvalidArgumentException If name or columns have not been supplied.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (instancetype)initWithName:(NSString *)name columns:(NSArray *)columns;
+
+/**
+ Initialize index without name and columns, will raise an exception.
+
+ @throws NSInvalidArgumentException Since no name have been supplied.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (instancetype)init;
+
+#pragma mark - Definition
+
+/**
+ Build the create statement for the index.
+
+ @param table Name of the table the index belongs to.
+
+ @return Create statement for the index.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ The statement is built in the same form as SQLite stores the definition within
+ `sqlite_master`, i.e. it can be used to verify the existing index.
+ */
+- (NSString *)definitionForTable:(NSString *)table;
+
+@end
@@ -0,0 +1,92 @@
+//
+//  RASqliteIndex.m
+//  RASqlite
+//
+//  Created by Tobias Raatiniemi on 2016-12-04.
+//  Copyright (c) 2016 Raatiniemi. All rights reserved.
+//
+
+#import "RASqliteIndex.h"
+
+// -- -- Import
+
+#import "RASqlite.h"
+
+@interface RASqliteIndex () {
+@private
+    NSString *_name;
+    NSArray *_columns;
+    NSArray *_coveringColumns;
+    NSString *_condition;
+
+    BOOL _unique;
+}
+
+/// Stores the name of the index.
+@property(strong, atomic) NSString *name;
+
+/// Stores the names of the indexed columns, in order.
+@property(copy, atomic) NSArray *columns;
+
+@end
+
+@implementation RASqliteIndex
+
+@synthesize name = _name;
+
+@synthesize columns = _columns;
+
+@synthesize coveringColumns = _coveringColumns;
+
+@synthesize condition = _condition;
+
+@synthesize unique = _unique;
+
+#pragma mark - Initialization
+
+- (instancetype)initWithName:(NSString *)name columns:(NSArray *)columns {
+    if (self = [super init]) {
+        // Verify the supplied index name, can not be `nil`.
+        if (!name) {
+            [NSException raise:NSInvalidArgumentException
+                        format:@"The supplied index name can not be `nil`."];
+        }
+
+        // An index without any columns is not valid.
+        if ([columns count] == 0) {
+            [NSException raise:NSInvalidArgumentException
+                        format:@"The index `%@` have to contain at least one column.", name];
+        }
+
+        [self setName:name];
+        [self setColumns:columns];
+
+        _unique = NO;
+    }
+    return self;
+}
+
+- (instancetype)init {
+    return [self initWithName:nil columns:nil];
+}
+
+#pragma mark - Definition
+
+- (NSString *)definitionForTable:(NSString *)table {
+    NSMutableArray *columns = [[self columns] mutableCopy];
+    if ([self coveringColumns]) {
+        [columns addObjectsFromArray:[self coveringColumns]];
+    }
+
+    NSMutableString *definition = [[NSMutableString alloc] init];
+    [definition appendString:[self isUnique] ? @"CREATE UNIQUE INDEX" : @"CREATE INDEX"];
+    [definition appendFormat:@" %@ ON %@(%@)", [self name], table, [columns componentsJoinedByString:@", "]];
+
+    if ([self condition]) {
+        [definition appendFormat:@" WHERE %@", [self condition]];
+    }
+
+    return definition;
+}
+
+@end
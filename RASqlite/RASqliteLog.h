@@ -9,6 +9,8 @@
 #ifndef RASqliteLog_h
 #define RASqliteLog_h
 
+#import <Foundation/Foundation.h>
+
 /// Definition of available log levels.
 typedef NS_ENUM(short int, RASqliteLogLevel) {
             /// Debug-level messages.
@@ -24,13 +26,89 @@ typedef NS_ENUM(short int, RASqliteLogLevel) {
             RASqliteLogLevelError
 };
 
+/**
+ Lowest level of log messages compiled into the library.
+
+ Messages below the threshold are removed by the preprocessor, i.e. neither the
+ message nor its arguments are evaluated. The value corresponds to the
+ `RASqliteLogLevel`, and it can be overridden with a preprocessor definition,
+ e.g. `RASqliteLogThreshold=2` to only keep warnings and errors.
+ */
+#ifndef RASqliteLogThreshold
 #if kRASqliteDebug
-/// Stores the level of logging within the library.
-static const RASqliteLogLevel _RASqliteLogLevel = RASqliteLogLevelDebug;
+#define RASqliteLogThreshold 0
 #else
-/// Stores the level of logging within the library.
-static const RASqliteLogLevel _RASqliteLogLevel = RASqliteLogLevelInfo;
+#define RASqliteLogThreshold 1
 #endif
+#endif
+
+/**
+ Block receiving the log messages.
+
+ @param level Level of the log message.
+ @param file Name of the file the message was sent from.
+ @param line Line within the file the message was sent from.
+ @param message The log message.
+ */
+typedef void (^RASqliteLogSink)(RASqliteLogLevel level, NSString *file, int line, NSString *message);
+
+/**
+ Retrieve the current log level.
+
+ @return Lowest level of messages that are sent to the sink.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+FOUNDATION_EXPORT RASqliteLogLevel RASqliteLogGetLevel(void);
+
+/**
+ Change the log level during runtime.
+
+ @param level Lowest level of messages that should be sent to the sink.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ Messages below the `RASqliteLogThreshold` have been removed during compilation
+ and can not be enabled during runtime.
+ */
+FOUNDATION_EXPORT void RASqliteLogSetLevel(RASqliteLogLevel level);
+
+/**
+ Change the sink receiving the log messages.
+
+ @param sink Block receiving the log messages, `nil` restores the default sink.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ The sink is called from the background logging thread, never from the thread
+ sending the message. The default sink writes the messages with `NSLog`.
+ */
+FOUNDATION_EXPORT void RASqliteLogSetSink(RASqliteLogSink sink);
+
+/**
+ Enqueue the message for the background logging thread.
+
+ @param level Level of the log message.
+ @param file Path of the file the message was sent from, i.e. `__FILE__`.
+ @param line Line within the file the message was sent from.
+ @param message The log message.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ The message is stored within a lock-free ring buffer, if the buffer is full
+ the message is dropped and the number of dropped messages is reported.
+ */
+FOUNDATION_EXPORT void RASqliteLogWrite(RASqliteLogLevel level, const char *file, int line, NSString *message);
+
+/**
+ Wait until every enqueued message have been sent to the sink.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+FOUNDATION_EXPORT void RASqliteLogFlush(void);
 
 /**
  Macro for sending messages to the log, depending on the level.
@@ -52,10 +130,10 @@ static const RASqliteLogLevel _RASqliteLogLevel = RASqliteLogLevelInfo;
 #ifndef RASqliteLog
 #define RASqliteLog(level, format, ...)\
     do {\
-        if ( level > _RASqliteLogLevel ) {\
-            NSLog(\
-                @"<%@: (%d)> %@",\
-                [[NSString stringWithUTF8String:__FILE__] lastPathComponent],\
+        if ( (level) >= RASqliteLogGetLevel() ) {\
+            RASqliteLogWrite(\
+                (level),\
+                __FILE__,\
                 __LINE__,\
                 [NSString stringWithFormat:(format), ##__VA_ARGS__]\
             );\
@@ -64,19 +142,35 @@ static const RASqliteLogLevel _RASqliteLogLevel = RASqliteLogLevelInfo;
 #endif
 
 /// Shorthand logger for debug-messages.
+#if RASqliteLogThreshold <= 0
 #define RASqliteDebugLog(format, ...) \
     RASqliteLog( RASqliteLogLevelDebug, format, ##__VA_ARGS__ )
+#else
+#define RASqliteDebugLog(format, ...) do {} while(NO)
+#endif
 
 /// Shorthand logger for info-messages.
+#if RASqliteLogThreshold <= 1
 #define RASqliteInfoLog(format, ...) \
     RASqliteLog( RASqliteLogLevelInfo, format, ##__VA_ARGS__ )
+#else
+#define RASqliteInfoLog(format, ...) do {} while(NO)
+#endif
 
 /// Shorthand logger for warning-messages.
+#if RASqliteLogThreshold <= 2
 #define RASqliteWarningLog(format, ...) \
     RASqliteLog( RASqliteLogLevelWarning, format, ##__VA_ARGS__ )
+#else
+#define RASqliteWarningLog(format, ...) do {} while(NO)
+#endif
 
 /// Shorthand logger for error-messages.
+#if RASqliteLogThreshold <= 3
 #define RASqliteErrorLog(format, ...) \
     RASqliteLog( RASqliteLogLevelError, format, ##__VA_ARGS__ )
+#else
+#define RASqliteErrorLog(format, ...) do {} while(NO)
+#endif
 
 #endif /* RASqliteLog_h */
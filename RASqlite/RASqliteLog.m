@@ -0,0 +1,235 @@
+//
+//  RASqliteLog.m
+//  RASqlite
+//
+//  Created by Tobias Raatiniemi on 2016-12-18.
+//  Copyright (C) 2016 Raatiniemi. All rights reserved.
+//
+
+#import "RASqliteLog.h"
+
+#import <pthread.h>
+#import <stdatomic.h>
+
+/// Number of slots within the ring buffer, have to be a power of two.
+#define RASqliteLogCapacity 1024
+
+/// Slot within the ring buffer.
+typedef struct {
+    /// Sequence used to determine whether the slot is writable or readable.
+    _Atomic(size_t) sequence;
+
+    RASqliteLogLevel level;
+    const char *file;
+    int line;
+
+    /// Retained message, transferred to the logging thread.
+    void *message;
+} RASqliteLogSlot;
+
+/// Ring buffer with the enqueued messages.
+static RASqliteLogSlot RASqliteLogSlots[RASqliteLogCapacity];
+
+/// Position for the next message to be enqueued.
+static _Atomic(size_t) RASqliteLogEnqueuePosition;
+
+/// Position for the next message to be dequeued, only used by the logging thread.
+static _Atomic(size_t) RASqliteLogDequeuePosition;
+
+/// Number of messages that have been sent to the sink, used when flushing.
+static _Atomic(size_t) RASqliteLogDeliveredPosition;
+
+/// Number of messages dropped since the buffer was full.
+static _Atomic(uint64_t) RASqliteLogDropped;
+
+/// Current log level, adjustable during runtime.
+static _Atomic(int) RASqliteLogLevelCurrent = RASqliteLogThreshold;
+
+/// Signals the logging thread that messages have been enqueued.
+static dispatch_semaphore_t RASqliteLogSignal;
+
+/// Guards the sink, only held by the logging thread and while changing sink.
+static pthread_mutex_t RASqliteLogSinkLock = PTHREAD_MUTEX_INITIALIZER;
+
+/// Sink receiving the messages, `nil` for the default sink.
+static RASqliteLogSink RASqliteLogCurrentSink;
+
+/**
+ Default sink, writes the message with `NSLog`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static void RASqliteLogDefaultSink(RASqliteLogLevel level, NSString *file, int line, NSString *message) {
+    NSLog(@"<%@: (%d)> %@", file, line, message);
+}
+
+/**
+ Send the message to the current sink.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static void RASqliteLogSend(RASqliteLogLevel level, const char *path, int line, NSString *message) {
+    // Only the name of the file is relevant, the path is stripped on the
+    // logging thread instead of when the message is sent.
+    const char *name = strrchr(path, '/');
+    NSString *file = [NSString stringWithUTF8String:name ? name + 1 : path];
+
+    pthread_mutex_lock(&RASqliteLogSinkLock);
+    RASqliteLogSink sink = RASqliteLogCurrentSink;
+    pthread_mutex_unlock(&RASqliteLogSinkLock);
+
+    if (sink) {
+        sink(level, file, line, message);
+    } else {
+        RASqliteLogDefaultSink(level, file, line, message);
+    }
+}
+
+/**
+ Dequeue the messages and send them to the sink.
+
+ @return `YES` if any message was dequeued, otherwise `NO`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static BOOL RASqliteLogDrain(void) {
+    BOOL drained = NO;
+
+    for (;;) {
+        size_t position = atomic_load_explicit(&RASqliteLogDequeuePosition, memory_order_relaxed);
+        RASqliteLogSlot *slot = &RASqliteLogSlots[position & (RASqliteLogCapacity - 1)];
+
+        size_t sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+        if (sequence != position + 1) {
+            break;
+        }
+
+        RASqliteLogLevel level = slot->level;
+        const char *file = slot->file;
+        int line = slot->line;
+        NSString *message = (__bridge_transfer NSString *) slot->message;
+        slot->message = NULL;
+
+        // Release the slot for the producers before sending the message.
+        atomic_store_explicit(&slot->sequence, position + RASqliteLogCapacity, memory_order_release);
+        atomic_store_explicit(&RASqliteLogDequeuePosition, position + 1, memory_order_release);
+
+        @autoreleasepool {
+            RASqliteLogSend(level, file, line, message);
+        }
+
+        // The slot is released before the message is sent, i.e. flushing
+        // have to wait for the delivery rather than the dequeue.
+        atomic_store_explicit(&RASqliteLogDeliveredPosition, position + 1, memory_order_release);
+        drained = YES;
+    }
+
+    uint64_t dropped = atomic_exchange_explicit(&RASqliteLogDropped, 0, memory_order_relaxed);
+    if (dropped > 0) {
+        @autoreleasepool {
+            NSString *message = [NSString stringWithFormat:@"Log buffer is full, %llu messages have been dropped.", dropped];
+            RASqliteLogSend(RASqliteLogLevelWarning, __FILE__, __LINE__, message);
+        }
+    }
+
+    return drained;
+}
+
+/**
+ Main loop for the logging thread.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static void *RASqliteLogThread(void *argument) {
+#ifdef __APPLE__
+    pthread_setname_np("me.raatiniemi.rasqlite.log");
+#endif
+
+    for (;;) {
+        dispatch_semaphore_wait(RASqliteLogSignal, DISPATCH_TIME_FOREVER);
+        RASqliteLogDrain();
+    }
+
+    return NULL;
+}
+
+/**
+ Initialize the ring buffer and start the logging thread.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static void RASqliteLogInitialize(void) {
+    for (size_t index = 0; index < RASqliteLogCapacity; index++) {
+        atomic_init(&RASqliteLogSlots[index].sequence, index);
+    }
+    RASqliteLogSignal = dispatch_semaphore_create(0);
+
+    pthread_t thread;
+    pthread_attr_t attributes;
+    pthread_attr_init(&attributes);
+    pthread_attr_setdetachstate(&attributes, PTHREAD_CREATE_DETACHED);
+    pthread_create(&thread, &attributes, RASqliteLogThread, NULL);
+    pthread_attr_destroy(&attributes);
+}
+
+/// Ensures that the logging is only initialized once.
+static pthread_once_t RASqliteLogOnce = PTHREAD_ONCE_INIT;
+
+RASqliteLogLevel RASqliteLogGetLevel(void) {
+    return (RASqliteLogLevel) atomic_load_explicit(&RASqliteLogLevelCurrent, memory_order_relaxed);
+}
+
+void RASqliteLogSetLevel(RASqliteLogLevel level) {
+    atomic_store_explicit(&RASqliteLogLevelCurrent, level, memory_order_relaxed);
+}
+
+void RASqliteLogSetSink(RASqliteLogSink sink) {
+    pthread_mutex_lock(&RASqliteLogSinkLock);
+    RASqliteLogCurrentSink = [sink copy];
+    pthread_mutex_unlock(&RASqliteLogSinkLock);
+}
+
+void RASqliteLogWrite(RASqliteLogLevel level, const char *file, int line, NSString *message) {
+    pthread_once(&RASqliteLogOnce, RASqliteLogInitialize);
+
+    RASqliteLogSlot *slot;
+    size_t position = atomic_load_explicit(&RASqliteLogEnqueuePosition, memory_order_relaxed);
+    for (;;) {
+        slot = &RASqliteLogSlots[position & (RASqliteLogCapacity - 1)];
+        size_t sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+
+        intptr_t difference = (intptr_t) sequence - (intptr_t) position;
+        if (difference == 0) {
+            // The slot is available, attempt to claim it.
+            if (atomic_compare_exchange_weak_explicit(&RASqliteLogEnqueuePosition, &position, position + 1, memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if (difference < 0) {
+            // The buffer is full, rather drop the message than block the caller.
+            atomic_fetch_add_explicit(&RASqliteLogDropped, 1, memory_order_relaxed);
+            dispatch_semaphore_signal(RASqliteLogSignal);
+            return;
+        } else {
+            position = atomic_load_explicit(&RASqliteLogEnqueuePosition, memory_order_relaxed);
+        }
+    }
+
+    slot->level = level;
+    slot->file = file;
+    slot->line = line;
+    slot->message = (__bridge_retained void *) message;
+    atomic_store_explicit(&slot->sequence, position + 1, memory_order_release);
+
+    dispatch_semaphore_signal(RASqliteLogSignal);
+}
+
+void RASqliteLogFlush(void) {
+    pthread_once(&RASqliteLogOnce, RASqliteLogInitialize);
+
+    size_t target = atomic_load_explicit(&RASqliteLogEnqueuePosition, memory_order_acquire);
+    dispatch_semaphore_signal(RASqliteLogSignal);
+
+    while (atomic_load_explicit(&RASqliteLogDeliveredPosition, memory_order_acquire) < target) {
+        usleep(100);
+    }
+}
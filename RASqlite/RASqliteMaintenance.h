@@ -0,0 +1,96 @@
+//
+//  RASqliteMaintenance.h
+//  RASqlite
+//
+//  Created by Tobias Raatiniemi on 2016-12-29.
+//  Copyright (c) 2016 Raatiniemi. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import <sqlite3.h>
+
+#import "RASqliteQueue.h"
+
+/**
+ Schedules and performs the background maintenance for a database.
+
+ Each maintenance pass performs, in order:
+ - `PRAGMA optimize` once enough rows have changed since the last optimization,
+ - `PRAGMA incremental_vacuum` in bounded steps, if `auto_vacuum` is incremental,
+ - `PRAGMA integrity_check` for one table at a time, spread over the integrity interval.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ The pass have to be performed on the query queue, and it yields once the
+ deadline is reached or another caller is waiting for the queue. Remaining work
+ is resumed with the next pass.
+ */
+@interface RASqliteMaintenance : NSObject
+
+/// Stores the number of changed rows before the statistics are considered stale.
+@property(nonatomic) NSUInteger changeThreshold;
+
+/// Stores the number of pages released with each incremental vacuum step.
+@property(nonatomic) int vacuumPages;
+
+/// Stores the interval for checking the integrity of every table.
+@property(nonatomic) NSTimeInterval integrityInterval;
+
+#pragma mark - Initialization
+
+/**
+ Initialize maintenance for the database using the query queue.
+
+ @param queue Queue on which the queries for the database are executed.
+
+ @return Initialized maintenance.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (instancetype)initWithQueue:(RASqliteQueue *)queue;
+
+- (id)init __unavailable;
+
+#pragma mark - Schedule
+
+/**
+ Schedule the handler to be called while the query queue is idle.
+
+ @param interval Minimum interval between the calls to the handler.
+ @param handler Block performing the maintenance pass.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ The handler is called on a background queue with low priority, and calls
+ are skipped while the query queue is busy. Any previous schedule is cancelled.
+ */
+- (void)scheduleWithInterval:(NSTimeInterval)interval handler:(void (^)(void))handler;
+
+/**
+ Cancel the scheduled maintenance.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)cancel;
+
+#pragma mark - Maintenance
+
+/**
+ Perform a maintenance pass on the database connection.
+
+ @param database Database connection.
+ @param deadline Monotonic timestamp, in nanoseconds, when the pass should yield.
+
+ @return An error if one occurred or the integrity check failed, otherwise `nil`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ Statements interrupted by the deadline are not considered errors, and are
+ retried with the next pass.
+ */
+- (NSError *)performOnDatabase:(sqlite3 *)database deadline:(uint64_t)deadline;
+
+@end
@@ -0,0 +1,313 @@
+//
+//  RASqliteMaintenance.m
+//  RASqlite
+//
+//  Created by Tobias Raatiniemi on 2016-12-29.
+//  Copyright (c) 2016 Raatiniemi. All rights reserved.
+//
+
+#import "RASqliteMaintenance.h"
+
+#import "RASqlite.h"
+#import "NSError+RASqlite.h"
+#import "RASqliteHistogram.h"
+
+/// Default number of changed rows before the statistics are considered stale.
+static const NSUInteger RASqliteMaintenanceChangeThreshold = 1000;
+
+/// Default number of pages released with each incremental vacuum step.
+static const int RASqliteMaintenanceVacuumPages = 64;
+
+/// Default interval for checking the integrity of every table, i.e. weekly.
+static const NSTimeInterval RASqliteMaintenanceIntegrityInterval = 7 * 24 * 60 * 60;
+
+/// Value for `auto_vacuum` when the database is using incremental vacuum.
+static const int RASqliteMaintenanceIncrementalVacuum = 2;
+
+/**
+ Retrieve the integer value from the pragma.
+
+ @param database Database connection.
+ @param pragma Pragma returning a single integer, e.g. `PRAGMA freelist_count`.
+
+ @return Value from the pragma, or -1 if the pragma failed.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static sqlite3_int64 RASqliteMaintenanceInteger(sqlite3 *database, const char *pragma) {
+    sqlite3_stmt *statement;
+    if (sqlite3_prepare_v2(database, pragma, -1, &statement, NULL) != SQLITE_OK) {
+        return -1;
+    }
+
+    sqlite3_int64 value = -1;
+    if (sqlite3_step(statement) == SQLITE_ROW) {
+        value = sqlite3_column_int64(statement, 0);
+    }
+    sqlite3_finalize(statement);
+
+    return value;
+}
+
+@interface RASqliteMaintenance () {
+@private
+    RASqliteQueue *_queue;
+
+    dispatch_source_t _timer;
+
+    /// Total number of changes for the connection when last optimized.
+    int _changes;
+
+    /// Index of the next table to check the integrity for.
+    NSUInteger _table;
+
+    /// Monotonic timestamp for when the next table should be checked.
+    uint64_t _integrity;
+}
+
+/**
+ Check whether the pass should yield to other callers.
+
+ @param deadline Monotonic timestamp when the pass should yield.
+
+ @return `YES` if the pass should yield, otherwise `NO`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (BOOL)shouldYieldBefore:(uint64_t)deadline;
+
+/**
+ Optimize the database if enough rows have changed since the last optimization.
+
+ @param database Database connection.
+
+ @return An error if one occurred, otherwise `nil`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (NSError *)optimizeDatabase:(sqlite3 *)database;
+
+/**
+ Release free pages, if the database is using incremental vacuum.
+
+ @param database Database connection.
+ @param deadline Monotonic timestamp when the pass should yield.
+
+ @return An error if one occurred, otherwise `nil`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (NSError *)vacuumDatabase:(sqlite3 *)database deadline:(uint64_t)deadline;
+
+/**
+ Check the integrity of the next table, if the check is due.
+
+ @param database Database connection.
+
+ @return An error if one occurred or the table is corrupted, otherwise `nil`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (NSError *)checkIntegrityForDatabase:(sqlite3 *)database;
+
+@end
+
+@implementation RASqliteMaintenance
+
+#pragma mark - Initialization
+
+- (instancetype)initWithQueue:(RASqliteQueue *)queue {
+    if (self = [super init]) {
+        _queue = queue;
+
+        _changeThreshold = RASqliteMaintenanceChangeThreshold;
+        _vacuumPages = RASqliteMaintenanceVacuumPages;
+        _integrityInterval = RASqliteMaintenanceIntegrityInterval;
+    }
+
+    return self;
+}
+
+- (void)dealloc {
+    [self cancel];
+}
+
+#pragma mark - Schedule
+
+- (void)scheduleWithInterval:(NSTimeInterval)interval handler:(void (^)(void))handler {
+    [self cancel];
+
+    dispatch_queue_t queue = dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_BACKGROUND, 0);
+    _timer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, queue);
+
+    // The leeway allow the system to coalesce the maintenance with other work.
+    uint64_t nanoseconds = (uint64_t) (interval * NSEC_PER_SEC);
+    dispatch_source_set_timer(_timer, dispatch_time(DISPATCH_TIME_NOW, (int64_t) nanoseconds), nanoseconds, nanoseconds / 10);
+
+    RASqliteQueue *database = _queue;
+    dispatch_source_set_event_handler(_timer, ^{
+        // Skip the pass while the queue is busy, i.e. it is not an idle window.
+        if ([database isIdle]) {
+            handler();
+        }
+    });
+    dispatch_resume(_timer);
+}
+
+- (void)cancel {
+    if (_timer) {
+        dispatch_source_cancel(_timer);
+        _timer = nil;
+    }
+}
+
+#pragma mark - Maintenance
+
+- (NSError *)performOnDatabase:(sqlite3 *)database deadline:(uint64_t)deadline {
+    NSError *error = [self optimizeDatabase:database];
+    if (error || [self shouldYieldBefore:deadline]) {
+        return error;
+    }
+
+    error = [self vacuumDatabase:database deadline:deadline];
+    if (error || [self shouldYieldBefore:deadline]) {
+        return error;
+    }
+
+    return [self checkIntegrityForDatabase:database];
+}
+
+- (BOOL)shouldYieldBefore:(uint64_t)deadline {
+    return RASqliteTimestamp() >= deadline || [_queue hasWaitingBlocks];
+}
+
+- (NSError *)optimizeDatabase:(sqlite3 *)database {
+    // The number of changes is reset when the connection is reopened.
+    int changes = sqlite3_total_changes(database);
+    if (changes < _changes) {
+        _changes = 0;
+    }
+
+    if ((NSUInteger) (changes - _changes) < [self changeThreshold]) {
+        return nil;
+    }
+
+    // The analysis limit keeps the `ANALYZE` run by `optimize` bounded for
+    // large tables, i.e. the statistics are approximated. The limit is
+    // restored afterwards, since it also applies to `ANALYZE` executed by
+    // the application on the same connection.
+    sqlite3_int64 limit = RASqliteMaintenanceInteger(database, "PRAGMA analysis_limit");
+    int code = sqlite3_exec(database, "PRAGMA analysis_limit = 400; PRAGMA optimize", NULL, NULL, NULL);
+    if (limit >= 0) {
+        NSString *restore = RASqliteSF(@"PRAGMA analysis_limit = %lld", limit);
+        sqlite3_exec(database, [restore UTF8String], NULL, NULL, NULL);
+    }
+
+    if (code == SQLITE_INTERRUPT) {
+        RASqliteDebugLog(@"Optimization have been interrupted, retrying with the next pass.");
+        return nil;
+    }
+
+    if (code != SQLITE_OK) {
+        NSString *message = RASqliteSF(@"Unable to optimize database: %s", sqlite3_errmsg(database));
+        RASqliteErrorLog(@"%@", message);
+
+        return [NSError code:RASqliteErrorQuery message:message];
+    }
+
+    _changes = changes;
+    RASqliteDebugLog(@"Database have been optimized after %d changes.", changes);
+
+    return nil;
+}
+
+- (NSError *)vacuumDatabase:(sqlite3 *)database deadline:(uint64_t)deadline {
+    if (RASqliteMaintenanceInteger(database, "PRAGMA auto_vacuum") != RASqliteMaintenanceIncrementalVacuum) {
+        return nil;
+    }
+
+    // The pages are released in steps, each step is committed separately.
+    NSString *vacuum = RASqliteSF(@"PRAGMA incremental_vacuum(%d)", [self vacuumPages]);
+
+    while (RASqliteMaintenanceInteger(database, "PRAGMA freelist_count") > 0) {
+        int code = sqlite3_exec(database, [vacuum UTF8String], NULL, NULL, NULL);
+        if (code == SQLITE_INTERRUPT) {
+            return nil;
+        }
+
+        if (code != SQLITE_OK) {
+            NSString *message = RASqliteSF(@"Unable to vacuum database: %s", sqlite3_errmsg(database));
+            RASqliteErrorLog(@"%@", message);
+
+            return [NSError code:RASqliteErrorQuery message:message];
+        }
+
+        if ([self shouldYieldBefore:deadline]) {
+            break;
+        }
+    }
+
+    return nil;
+}
+
+- (NSError *)checkIntegrityForDatabase:(sqlite3 *)database {
+    uint64_t now = RASqliteTimestamp();
+    if (now < _integrity) {
+        return nil;
+    }
+
+    sqlite3_stmt *statement;
+    const char *sql = "SELECT name FROM sqlite_master WHERE type = 'table' AND name NOT LIKE 'sqlite_%' ORDER BY name";
+    if (sqlite3_prepare_v2(database, sql, -1, &statement, NULL) != SQLITE_OK) {
+        return nil;
+    }
+
+    NSMutableArray *tables = [[NSMutableArray alloc] init];
+    while (sqlite3_step(statement) == SQLITE_ROW) {
+        [tables addObject:[NSString stringWithUTF8String:(const char *) sqlite3_column_text(statement, 0)]];
+    }
+    sqlite3_finalize(statement);
+
+    if ([tables count] == 0) {
+        return nil;
+    }
+
+    // Only a single table is checked with each pass, spreading the checks
+    // for every table over the interval.
+    NSString *table = tables[_table % [tables count]];
+    NSString *pragma = RASqliteSF(@"PRAGMA integrity_check(\"%@\")", [table stringByReplacingOccurrencesOfString:@"\"" withString:@"\"\""]);
+    if (sqlite3_prepare_v2(database, [pragma UTF8String], -1, &statement, NULL) != SQLITE_OK) {
+        return nil;
+    }
+
+    NSMutableArray *problems = [[NSMutableArray alloc] init];
+    int code;
+    while ((code = sqlite3_step(statement)) == SQLITE_ROW) {
+        NSString *problem = [NSString stringWithUTF8String:(const char *) sqlite3_column_text(statement, 0)];
+        if (![problem isEqualToString:@"ok"]) {
+            [problems addObject:problem];
+        }
+    }
+    sqlite3_finalize(statement);
+
+    // Tables that can not be checked within the deadline are skipped, to
+    // prevent a single table from blocking the checks for other tables.
+    _table++;
+    _integrity = now + (uint64_t) ([self integrityInterval] / [tables count] * NSEC_PER_SEC);
+
+    if (code == SQLITE_INTERRUPT) {
+        RASqliteWarningLog(@"Integrity check for `%@` have been interrupted, the table is skipped.", table);
+        return nil;
+    }
+
+    if ([problems count] == 0) {
+        return nil;
+    }
+
+    NSString *message = RASqliteSF(@"Integrity check for `%@` failed: %@", table, [problems componentsJoinedByString:@"; "]);
+    RASqliteErrorLog(@"%@", message);
+
+    return [NSError code:RASqliteErrorIntegrity message:message];
+}
+
+@end
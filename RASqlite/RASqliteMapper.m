@@ -9,6 +9,7 @@
 #import "RASqliteMapper.h"
 
 #import "NSMutableDictionary+RASqlite.h"
+#import "RASqliteCompressor.h"
 
 @implementation RASqliteMapper
 
@@ -44,7 +45,11 @@
                 // Retrieve the value and the number of bytes for the blob column.
                 const void *value = (void *) sqlite3_column_blob(*statement, index);
                 NSUInteger bytes = (NSUInteger) sqlite3_column_bytes(*statement, index);
-                [row setColumn:column withObject:[NSData dataWithBytes:value length:bytes]];
+
+                // Compressed values are marked with a header, and are
+                // decompressed to their original type.
+                id object = [RASqliteCompressor decompressBytes:value length:bytes];
+                [row setColumn:column withObject:object ?: [NSData dataWithBytes:value length:bytes]];
                 break;
             }
             case SQLITE_NULL: {
@@ -0,0 +1,143 @@
+//
+//  RASqlitePager.h
+//  RASqlite
+//
+//  Created by Tobias Raatiniemi on 2016-12-31.
+//  Copyright (c) 2016 Raatiniemi. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+@class RASqlite;
+
+/**
+ Pages through the result of a query with keyset pagination.
+
+ Instead of skipping rows with `OFFSET`, each page continues from the key of
+ the last row within the previous page, i.e. `WHERE (k1, k2) > (?, ?)`. With
+ an index for the key columns every page is equally fast, regardless of how
+ deep the page is.
+
+ @code
+ RASqlitePager *pager = [[RASqlitePager alloc] initWithDatabase:rasqlite
+                                                          query:@"SELECT id, name FROM user"
+                                                           keys:@[@"name", @"id"]
+                                                       pageSize:50];
+ NSArray *rows;
+ while ([(rows = [pager nextPage]) count] > 0) {
+    // Display the rows, and save `[pager cursor]` to resume later.
+ }
+ @endcode
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ The key columns have to be selected by the query, be `NOT NULL`, and together
+ uniquely identify each row, e.g. by including the primary key as the last
+ key. The rows are ordered ascending by the keys.
+
+ @par
+ The pager is not thread safe, each pager should only be used by one thread
+ at a time.
+ */
+@interface RASqlitePager : NSObject
+
+/// Stores the names of the key columns, in order.
+@property(copy, nonatomic, readonly) NSArray *keys;
+
+/// Stores the maximum number of rows for each page.
+@property(nonatomic, readonly) NSUInteger pageSize;
+
+#pragma mark - Initialization
+
+/**
+ Initialize pager for the query with parameters.
+
+ @param database Database to execute the query against.
+ @param query Base query, without `ORDER BY` and `LIMIT` clauses.
+ @param params Parameters to bind to the base query.
+ @param keys Names of the key columns, in order.
+ @param pageSize Maximum number of rows for each page.
+
+ @return Initialized pager.
+
+ @throws NSInvalidArgumentException If query, keys, or page size is missing.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (instancetype)initWithDatabase:(RASqlite *)database query:(NSString *)query params:(NSArray *)params keys:(NSArray *)keys pageSize:(NSUInteger)pageSize;
+
+/**
+ Initialize pager for the query.
+
+ @param database Database to execute the query against.
+ @param query Base query, without `ORDER BY` and `LIMIT` clauses.
+ @param keys Names of the key columns, in order.
+ @param pageSize Maximum number of rows for each page.
+
+ @return Initialized pager.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (instancetype)initWithDatabase:(RASqlite *)database query:(NSString *)query keys:(NSArray *)keys pageSize:(NSUInteger)pageSize;
+
+- (id)init __unavailable;
+
+#pragma mark - Page
+
+/**
+ Fetch the page following the current page, or the first page.
+
+ @return Rows within the page, empty if there are no more rows, or `nil` if an error occurred.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ The current page is only changed if the page contain any rows, i.e. rows
+ appended after reaching the end are retrieved with the next call.
+ */
+- (NSArray *)nextPage;
+
+/**
+ Fetch the page preceding the current page.
+
+ @return Rows within the page, in ascending order, empty if there are no preceding rows, or `nil` if an error occurred.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (NSArray *)previousPage;
+
+/**
+ Reset the pager, the next page will be the first page.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)reset;
+
+#pragma mark - Cursor
+
+/**
+ Retrieve the cursor token for the current page.
+
+ @return Opaque token, or `nil` if no page have been fetched.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ The token only contain the keys for the first and last row of the current
+ page, i.e. it remains valid even if rows are inserted or removed.
+ */
+- (NSString *)cursor;
+
+/**
+ Resume from the cursor token, the next page will follow the page for the token.
+
+ @param cursor Token retrieved with `cursor`.
+
+ @return `YES` if the token is valid for the pager keys, otherwise `NO`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (BOOL)resumeFromCursor:(NSString *)cursor;
+
+@end
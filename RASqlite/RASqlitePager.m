@@ -0,0 +1,207 @@
+//
+//  RASqlitePager.m
+//  RASqlite
+//
+//  Created by Tobias Raatiniemi on 2016-12-31.
+//  Copyright (c) 2016 Raatiniemi. All rights reserved.
+//
+
+#import "RASqlitePager.h"
+
+#import "RASqlite.h"
+#import "RASqlite+RASqliteStatement.h"
+
+@interface RASqlitePager () {
+@private
+    RASqlite *_database;
+    NSArray *_params;
+
+    /// Query for the first page.
+    NSString *_firstQuery;
+
+    /// Query for the page following the last key.
+    NSString *_nextQuery;
+
+    /// Query for the page preceding the first key, in descending order.
+    NSString *_previousQuery;
+
+    /// Key values for the first row within the current page.
+    NSArray *_first;
+
+    /// Key values for the last row within the current page.
+    NSArray *_last;
+}
+
+/**
+ Fetch the page with the query, and move the current page if any rows were found.
+
+ @param query Query for the page.
+ @param values Key values to continue from, or `nil` for the first page.
+ @param descending Whether the query is in descending order.
+
+ @return Rows within the page, in ascending order, or `nil` if an error occurred.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (NSArray *)fetchPage:(NSString *)query after:(NSArray *)values descending:(BOOL)descending;
+
+/**
+ Retrieve the key values for the row.
+
+ @param row Row containing the key columns.
+
+ @return Key values for the row.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (NSArray *)keyValuesForRow:(NSDictionary *)row;
+
+@end
+
+@implementation RASqlitePager
+
+#pragma mark - Initialization
+
+- (instancetype)initWithDatabase:(RASqlite *)database query:(NSString *)query params:(NSArray *)params keys:(NSArray *)keys pageSize:(NSUInteger)pageSize {
+    if (self = [super init]) {
+        if (!database || !query || [keys count] == 0 || pageSize == 0) {
+            [NSException raise:NSInvalidArgumentException
+                        format:@"Unable to page without database, query, keys, and page size."];
+        }
+
+        _database = database;
+        _params = [params copy] ?: @[];
+        _keys = [keys copy];
+        _pageSize = pageSize;
+
+        // The base query is used as a subquery, i.e. it can contain its own
+        // conditions. SQLite flattens the subquery, so indexes for the keys
+        // are still used.
+        NSString *list = [keys componentsJoinedByString:@", "];
+        NSMutableArray *placeholders = [[NSMutableArray alloc] initWithCapacity:[keys count]];
+        NSMutableArray *descending = [[NSMutableArray alloc] initWithCapacity:[keys count]];
+        for (NSString *key in keys) {
+            [placeholders addObject:@"?"];
+            [descending addObject:RASqliteSF(@"%@ DESC", key)];
+        }
+        NSString *values = [placeholders componentsJoinedByString:@", "];
+
+        _firstQuery = RASqliteSF(@"SELECT * FROM (%@) ORDER BY %@ LIMIT %lu",
+                query, list, (unsigned long) pageSize);
+        _nextQuery = RASqliteSF(@"SELECT * FROM (%@) WHERE (%@) > (%@) ORDER BY %@ LIMIT %lu",
+                query, list, values, list, (unsigned long) pageSize);
+        _previousQuery = RASqliteSF(@"SELECT * FROM (%@) WHERE (%@) < (%@) ORDER BY %@ LIMIT %lu",
+                query, list, values, [descending componentsJoinedByString:@", "], (unsigned long) pageSize);
+    }
+
+    return self;
+}
+
+- (instancetype)initWithDatabase:(RASqlite *)database query:(NSString *)query keys:(NSArray *)keys pageSize:(NSUInteger)pageSize {
+    return [self initWithDatabase:database query:query params:nil keys:keys pageSize:pageSize];
+}
+
+#pragma mark - Page
+
+- (NSArray *)nextPage {
+    if (!_last) {
+        return [self fetchPage:_firstQuery after:nil descending:NO];
+    }
+
+    return [self fetchPage:_nextQuery after:_last descending:NO];
+}
+
+- (NSArray *)previousPage {
+    if (!_first) {
+        return @[];
+    }
+
+    return [self fetchPage:_previousQuery after:_first descending:YES];
+}
+
+- (void)reset {
+    _first = nil;
+    _last = nil;
+}
+
+- (NSArray *)fetchPage:(NSString *)query after:(NSArray *)values descending:(BOOL)descending {
+    NSArray *params = values ? [_params arrayByAddingObjectsFromArray:values] : _params;
+
+    // The statements are kept within the statement cache, i.e. they are only
+    // prepared for the first page.
+    NSArray *rows = [_database fetchCached:query withParams:params];
+    if (!rows || [rows count] == 0) {
+        return rows;
+    }
+
+    if (descending) {
+        rows = [[rows reverseObjectEnumerator] allObjects];
+    }
+
+    _first = [self keyValuesForRow:[rows firstObject]];
+    _last = [self keyValuesForRow:[rows lastObject]];
+
+    return rows;
+}
+
+- (NSArray *)keyValuesForRow:(NSDictionary *)row {
+    NSMutableArray *values = [[NSMutableArray alloc] initWithCapacity:[_keys count]];
+    for (NSString *key in _keys) {
+        id value = row[key];
+        if (!value) {
+            [NSException raise:NSInvalidArgumentException
+                        format:@"Key column `%@` is not selected by the query.", key];
+        }
+        [values addObject:value];
+    }
+
+    return values;
+}
+
+#pragma mark - Cursor
+
+- (NSString *)cursor {
+    if (!_first || !_last) {
+        return nil;
+    }
+
+    // Property lists support every key type except `NULL`, which can not be
+    // used for keyset pagination anyway.
+    NSDictionary *token = @{@"keys": _keys, @"first": _first, @"last": _last};
+    NSData *data = [NSPropertyListSerialization dataWithPropertyList:token
+                                                              format:NSPropertyListBinaryFormat_v1_0
+                                                             options:0
+                                                               error:nil];
+
+    return [data base64EncodedStringWithOptions:0];
+}
+
+- (BOOL)resumeFromCursor:(NSString *)cursor {
+    NSData *data = cursor ? [[NSData alloc] initWithBase64EncodedString:cursor options:0] : nil;
+    if (!data) {
+        return NO;
+    }
+
+    id token = [NSPropertyListSerialization propertyListWithData:data
+                                                         options:NSPropertyListImmutable
+                                                          format:NULL
+                                                           error:nil];
+    if (![token isKindOfClass:[NSDictionary class]] || ![token[@"keys"] isEqual:_keys]) {
+        RASqliteDebugLog(@"Cursor is not valid for the keys `%@`.", [_keys componentsJoinedByString:@", "]);
+        return NO;
+    }
+
+    NSArray *first = token[@"first"];
+    NSArray *last = token[@"last"];
+    if (![first isKindOfClass:[NSArray class]] || ![last isKindOfClass:[NSArray class]]
+            || [first count] != [_keys count] || [last count] != [_keys count]) {
+        return NO;
+    }
+
+    _first = first;
+    _last = last;
+
+    return YES;
+}
+
+@end
@@ -0,0 +1,91 @@
+//
+//  RASqliteProfiler.h
+//  RASqlite
+//
+//  Created by Tobias Raatiniemi on 2016-12-17.
+//  Copyright (c) 2016 Raatiniemi. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import <sqlite3.h>
+
+/**
+ Collects statistics for each of the executed queries.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ Queries are grouped by their normalized form, i.e. with the whitespace
+ collapsed and the literals replaced with `?`. At most 1000 queries are kept,
+ the least called query is evicted. The execution time is retrieved from SQLite with the profile
+ trace, which requires SQLite 3.14.0 or later.
+ */
+@interface RASqliteProfiler : NSObject
+
+/**
+ Register the profile trace on the database connection.
+
+ @param database Database connection to profile.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ The profiler have to be kept alive until it have been detached.
+ */
+- (void)attachToDatabase:(sqlite3 *)database;
+
+/**
+ Remove the profile trace from the database connection.
+
+ @param database Database connection to stop profiling.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)detachFromDatabase:(sqlite3 *)database;
+
+/**
+ Record the time it took to prepare the query.
+
+ @param duration Time in nanoseconds.
+ @param sql Query that have been prepared.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)recordPrepare:(uint64_t)duration forQuery:(NSString *)sql;
+
+/**
+ Record the time it took to execute the query within SQLite.
+
+ @param duration Time in nanoseconds.
+ @param sql Query that have been executed.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)recordExecution:(uint64_t)duration forQuery:(const char *)sql;
+
+/**
+ Record the call to the query, with its latency.
+
+ @param sql Query that have been called.
+ @param rows Number of rows returned by the query.
+ @param latency Time in nanoseconds, including the time waiting for the queue.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)recordQuery:(NSString *)sql rows:(NSUInteger)rows latency:(uint64_t)latency;
+
+/**
+ Retrieve the statistics for each of the queries.
+
+ @return Normalized queries with their statistics.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ The statistics for each query contains the `count`, `rows`, `prepareTime`,
+ `executionTime`, and latency percentiles `p50`, `p95`, `p99`, and `maximum`.
+ Every time is in seconds.
+ */
+- (NSDictionary *)snapshot;
+
+@end
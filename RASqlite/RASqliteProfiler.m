@@ -0,0 +1,296 @@
+//
+//  RASqliteProfiler.m
+//  RASqlite
+//
+//  Created by Tobias Raatiniemi on 2016-12-17.
+//  Copyright (c) 2016 Raatiniemi. All rights reserved.
+//
+
+#import "RASqliteProfiler.h"
+
+#import <pthread.h>
+
+#import "RASqliteHistogram.h"
+
+/// Maximum number of queries with statistics, the least called query is evicted.
+static const NSUInteger RASqliteProfilerCapacity = 1000;
+
+/**
+ Check whether the character can be part of an identifier.
+
+ @param c Character to check.
+
+ @return `YES` if the character can be part of an identifier, otherwise `NO`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static BOOL RASqliteProfilerIsIdentifier(char c) {
+    return isalnum((unsigned char) c) || c == '_' || c == '$' || (c & 0x80);
+}
+
+/**
+ Collapse the whitespace within the query, and replace the literals with `?`.
+
+ @param sql Query to normalize.
+
+ @return Normalized query.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ Queries with inlined values, e.g. `WHERE id = 1` and `WHERE id = 2`, are
+ grouped together as `WHERE id = ?`. Quoted identifiers are kept as is.
+ */
+static NSString *RASqliteProfilerNormalize(const char *sql) {
+    size_t length = strlen(sql);
+    char *buffer = malloc(length + 1);
+
+    size_t index = 0;
+    BOOL whitespace = NO;
+    for (const char *c = sql; *c; c++) {
+        if (isspace((unsigned char) *c)) {
+            whitespace = index > 0;
+            continue;
+        }
+
+        if (whitespace) {
+            buffer[index++] = ' ';
+            whitespace = NO;
+        }
+
+        // Literals and keywords are only separated from the preceding
+        // identifier by whitespace or punctuation.
+        BOOL separated = index == 0 || !RASqliteProfilerIsIdentifier(buffer[index - 1]);
+
+        // String and blob literals, quotes within the literal are escaped by
+        // doubling them.
+        BOOL blob = (*c == 'x' || *c == 'X') && c[1] == '\'' && separated;
+        if (*c == '\'' || blob) {
+            c += blob ? 2 : 1;
+            while (*c && !(*c == '\'' && c[1] != '\'')) {
+                c += *c == '\'' ? 2 : 1;
+            }
+
+            buffer[index++] = '?';
+            if (!*c) {
+                break;
+            }
+            continue;
+        }
+
+        // Numeric literals, including hexadecimal and exponents.
+        if (separated && (isdigit((unsigned char) *c) || (*c == '.' && isdigit((unsigned char) c[1])))) {
+            while (isalnum((unsigned char) c[1]) || c[1] == '.'
+                    || ((c[1] == '+' || c[1] == '-') && (*c == 'e' || *c == 'E'))) {
+                c++;
+            }
+
+            buffer[index++] = '?';
+            continue;
+        }
+
+        // Quoted identifiers are kept as is, e.g. `"id"` or `[id]`.
+        if (*c == '"' || *c == '`' || *c == '[') {
+            char quote = *c == '[' ? ']' : *c;
+
+            buffer[index++] = *c;
+            while (c[1] && c[1] != quote) {
+                buffer[index++] = *++c;
+            }
+            if (!c[1]) {
+                break;
+            }
+            buffer[index++] = *++c;
+            continue;
+        }
+
+        buffer[index++] = *c;
+    }
+
+    NSString *normalized = [[NSString alloc] initWithBytes:buffer length:index encoding:NSUTF8StringEncoding];
+    free(buffer);
+
+    return normalized ?: @"";
+}
+
+/**
+ Callback for the SQLite trace, records the execution time for the statements.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static int RASqliteProfilerTrace(unsigned int type, void *context, void *statement, void *duration) {
+    if (type == SQLITE_TRACE_PROFILE) {
+        RASqliteProfiler *profiler = (__bridge RASqliteProfiler *) context;
+
+        const char *sql = sqlite3_sql((sqlite3_stmt *) statement);
+        if (sql) {
+            [profiler recordExecution:(uint64_t) *(sqlite3_int64 *) duration forQuery:sql];
+        }
+    }
+
+    return 0;
+}
+
+/**
+ Statistics for a single normalized query.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+@interface RASqliteProfilerEntry : NSObject
+
+/// Number of calls to the query.
+@property(nonatomic) uint64_t count;
+
+/// Number of rows returned by the query.
+@property(nonatomic) uint64_t rows;
+
+/// Accumulated time preparing the query, in nanoseconds.
+@property(nonatomic) uint64_t prepareTime;
+
+/// Accumulated time executing the query within SQLite, in nanoseconds.
+@property(nonatomic) uint64_t executionTime;
+
+/// Latency for the calls to the query, in nanoseconds.
+@property(strong, nonatomic, readonly) RASqliteHistogram *latency;
+
+@end
+
+@implementation RASqliteProfilerEntry
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _latency = [[RASqliteHistogram alloc] init];
+    }
+
+    return self;
+}
+
+@end
+
+@interface RASqliteProfiler () {
+@private
+    pthread_mutex_t _lock;
+
+    NSMutableDictionary *_entries;
+}
+
+/**
+ Retrieve the entry for the normalized query, the entry is created if needed.
+
+ @param sql Normalized query.
+
+ @return Entry for the query.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ The lock have to be held by the caller.
+ */
+- (RASqliteProfilerEntry *)entryForQuery:(NSString *)sql;
+
+@end
+
+@implementation RASqliteProfiler
+
+- (instancetype)init {
+    if (self = [super init]) {
+        pthread_mutex_init(&_lock, NULL);
+        _entries = [[NSMutableDictionary alloc] init];
+    }
+
+    return self;
+}
+
+- (void)dealloc {
+    pthread_mutex_destroy(&_lock);
+}
+
+- (void)attachToDatabase:(sqlite3 *)database {
+    sqlite3_trace_v2(database, SQLITE_TRACE_PROFILE, RASqliteProfilerTrace, (__bridge void *) self);
+}
+
+- (void)detachFromDatabase:(sqlite3 *)database {
+    sqlite3_trace_v2(database, 0, NULL, NULL);
+}
+
+- (RASqliteProfilerEntry *)entryForQuery:(NSString *)sql {
+    RASqliteProfilerEntry *entry = _entries[sql];
+    if (!entry) {
+        // Queries built with an unbounded number of shapes, e.g. with the
+        // number of placeholders depending on the input, should not grow
+        // the statistics without limit.
+        if ([_entries count] >= RASqliteProfilerCapacity) {
+            NSString *least;
+            uint64_t count = UINT64_MAX;
+            for (NSString *query in _entries) {
+                if ([_entries[query] count] < count) {
+                    count = [_entries[query] count];
+                    least = query;
+                }
+            }
+            [_entries removeObjectForKey:least];
+        }
+
+        entry = [[RASqliteProfilerEntry alloc] init];
+        _entries[sql] = entry;
+    }
+
+    return entry;
+}
+
+- (void)recordPrepare:(uint64_t)duration forQuery:(NSString *)sql {
+    NSString *query = RASqliteProfilerNormalize([sql UTF8String]);
+
+    pthread_mutex_lock(&_lock);
+    RASqliteProfilerEntry *entry = [self entryForQuery:query];
+    entry.prepareTime += duration;
+    pthread_mutex_unlock(&_lock);
+}
+
+- (void)recordExecution:(uint64_t)duration forQuery:(const char *)sql {
+    NSString *query = RASqliteProfilerNormalize(sql);
+
+    pthread_mutex_lock(&_lock);
+    RASqliteProfilerEntry *entry = [self entryForQuery:query];
+    entry.executionTime += duration;
+    pthread_mutex_unlock(&_lock);
+}
+
+- (void)recordQuery:(NSString *)sql rows:(NSUInteger)rows latency:(uint64_t)latency {
+    NSString *query = RASqliteProfilerNormalize([sql UTF8String]);
+
+    pthread_mutex_lock(&_lock);
+    RASqliteProfilerEntry *entry = [self entryForQuery:query];
+    entry.count++;
+    entry.rows += rows;
+    pthread_mutex_unlock(&_lock);
+
+    [[entry latency] recordValue:latency];
+}
+
+- (NSDictionary *)snapshot {
+    NSMutableDictionary *snapshot = [[NSMutableDictionary alloc] init];
+    double second = 1000000000.0;
+
+    pthread_mutex_lock(&_lock);
+    for (NSString *query in _entries) {
+        RASqliteProfilerEntry *entry = _entries[query];
+        RASqliteHistogram *latency = [entry latency];
+
+        snapshot[query] = @{
+                @"count": @([entry count]),
+                @"rows": @([entry rows]),
+                @"prepareTime": @([entry prepareTime] / second),
+                @"executionTime": @([entry executionTime] / second),
+                @"p50": @([latency valueAtPercentile:50] / second),
+                @"p95": @([latency valueAtPercentile:95] / second),
+                @"p99": @([latency valueAtPercentile:99] / second),
+                @"maximum": @([latency maximum] / second)
+        };
+    }
+    pthread_mutex_unlock(&_lock);
+
+    return snapshot;
+}
+
+@end
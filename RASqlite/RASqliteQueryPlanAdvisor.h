@@ -0,0 +1,49 @@
+//
+//  RASqliteQueryPlanAdvisor.h
+//  RASqlite
+//
+//  Created by Tobias Raatiniemi on 2016-12-10.
+//  Copyright (c) 2016 Raatiniemi. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import <sqlite3.h>
+
+/**
+ Analyzes the query plan for prepared queries, and keeps track of the queries
+ that would perform a full table scan or build temporary B-trees.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ The advisor is not thread safe, it should only be used from the query queue.
+ */
+@interface RASqliteQueryPlanAdvisor : NSObject
+
+/**
+ Analyze the query plan for the query, unless it already have been analyzed.
+
+ @param sql Query that have been prepared.
+ @param database Database connection on which the query have been prepared.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ Offending queries are logged with the warning-level.
+ */
+- (void)analyzeQuery:(NSString *)sql forDatabase:(sqlite3 *)database;
+
+/**
+ Retrieve the offending queries.
+
+ @return Array with a dictionary for each of the offending queries.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ Each dictionary contains the `query`, the involved `tables`, and the
+ offending details from the query `plan`.
+ */
+- (NSArray *)report;
+
+@end
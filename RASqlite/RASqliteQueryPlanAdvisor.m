@@ -0,0 +1,150 @@
+//
+//  RASqliteQueryPlanAdvisor.m
+//  RASqlite
+//
+//  Created by Tobias Raatiniemi on 2016-12-10.
+//  Copyright (c) 2016 Raatiniemi. All rights reserved.
+//
+
+#import "RASqliteQueryPlanAdvisor.h"
+
+#import "RASqlite.h"
+
+/// Index of the `detail` column within the `EXPLAIN QUERY PLAN` result.
+static const int RASqliteQueryPlanDetailColumn = 3;
+
+/**
+ Retrieve the name of the table from the query plan detail.
+
+ @param detail Detail from the query plan, e.g. `SCAN foo` or `SEARCH foo USING INDEX bar (baz=?)`.
+
+ @return Name of the table, or `nil` if the detail do not involve a table.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static NSString *RASqliteQueryPlanTable(NSString *detail) {
+    NSString *table;
+    if ([detail hasPrefix:@"SCAN "]) {
+        table = [detail substringFromIndex:[@"SCAN " length]];
+    } else if ([detail hasPrefix:@"SEARCH "]) {
+        table = [detail substringFromIndex:[@"SEARCH " length]];
+    } else {
+        return nil;
+    }
+
+    // Older versions of SQLite prefix the table name with `TABLE`.
+    if ([table hasPrefix:@"TABLE "]) {
+        table = [table substringFromIndex:[@"TABLE " length]];
+    }
+
+    table = [table componentsSeparatedByString:@" "][0];
+
+    // Subqueries, e.g. `SCAN (subquery-1)`, and constant rows do not involve a table.
+    if ([table hasPrefix:@"("] || [table isEqualToString:@"CONSTANT"]) {
+        return nil;
+    }
+
+    return table;
+}
+
+/**
+ Check whether the query plan detail is considered to be offending.
+
+ @param detail Detail from the query plan.
+
+ @return `YES` if the detail is a full scan without index or a temporary B-tree, otherwise `NO`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static BOOL RASqliteQueryPlanIsOffending(NSString *detail) {
+    if ([detail hasPrefix:@"USE TEMP B-TREE"]) {
+        return YES;
+    }
+
+    if (![detail hasPrefix:@"SCAN "] || !RASqliteQueryPlanTable(detail)) {
+        return NO;
+    }
+
+    // Scans using an index, or virtual tables, are not considered full scans.
+    return [detail rangeOfString:@" USING "].location == NSNotFound
+            && [detail rangeOfString:@" VIRTUAL TABLE "].location == NSNotFound;
+}
+
+@interface RASqliteQueryPlanAdvisor () {
+@private
+    NSMutableSet *_queries;
+
+    NSMutableArray *_report;
+}
+
+@end
+
+@implementation RASqliteQueryPlanAdvisor
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _queries = [[NSMutableSet alloc] init];
+        _report = [[NSMutableArray alloc] init];
+    }
+
+    return self;
+}
+
+- (void)analyzeQuery:(NSString *)sql forDatabase:(sqlite3 *)database {
+    // The query plan only have to be analyzed the first time the query is prepared.
+    if ([_queries containsObject:sql]) {
+        return;
+    }
+    [_queries addObject:sql];
+
+    sqlite3_stmt *statement;
+    NSString *explain = RASqliteSF(@"EXPLAIN QUERY PLAN %@", sql);
+    int code = sqlite3_prepare_v2(database, [explain UTF8String], -1, &statement, NULL);
+    if (code != SQLITE_OK) {
+        // Not every statement can be explained, e.g. statements that already
+        // are explained, the query itself have already been prepared.
+        RASqliteDebugLog(@"Unable to explain query plan for `%@`: %s", sql, sqlite3_errmsg(database));
+        sqlite3_finalize(statement);
+        return;
+    }
+
+    NSMutableOrderedSet *tables = [[NSMutableOrderedSet alloc] init];
+    NSMutableArray *plan = [[NSMutableArray alloc] init];
+
+    while (sqlite3_step(statement) == SQLITE_ROW) {
+        const unsigned char *text = sqlite3_column_text(statement, RASqliteQueryPlanDetailColumn);
+        if (!text) {
+            continue;
+        }
+
+        NSString *detail = [NSString stringWithUTF8String:(const char *) text];
+        NSString *table = RASqliteQueryPlanTable(detail);
+        if (table) {
+            [tables addObject:table];
+        }
+
+        if (RASqliteQueryPlanIsOffending(detail)) {
+            [plan addObject:detail];
+        }
+    }
+    sqlite3_finalize(statement);
+
+    if ([plan count] == 0) {
+        return;
+    }
+
+    RASqliteWarningLog(@"Query `%@` against `%@` is using an inefficient query plan: %@",
+            sql, [[tables array] componentsJoinedByString:@", "], [plan componentsJoinedByString:@"; "]);
+
+    [_report addObject:@{
+            @"query": sql,
+            @"tables": [tables array],
+            @"plan": plan
+    }];
+}
+
+- (NSArray *)report {
+    return [_report copy];
+}
+
+@end
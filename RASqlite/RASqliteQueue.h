@@ -19,6 +19,16 @@
  */
 + (RASqliteQueue *)sharedQueue;
 
+/**
+ Build queue executing blocks directly on the calling thread.
+
+ Used for connections that are confined to a single thread, where the
+ serialization is not needed. Each call returns a new queue.
+
+ @return Direct queue.
+ */
++ (RASqliteQueue *)directQueue;
+
 - (instancetype)init __unavailable;
 
 /**
@@ -28,4 +38,40 @@
  */
 - (void)dispatchBlock:(void (^)(void))block;
 
+/**
+ Check whether the queue is idle, i.e. no caller is waiting for or executing on the queue.
+
+ @return `YES` if the queue is idle, otherwise `NO`.
+ */
+- (BOOL)isIdle;
+
+/**
+ Check whether callers are waiting for the block executing on the queue.
+
+ @return `YES` if any caller is waiting, otherwise `NO`.
+
+ @note
+ Used by long running work on the queue to yield to other callers.
+ */
+- (BOOL)hasWaitingBlocks;
+
+/**
+ Retrieve the statistics for the queue.
+
+ @return Statistics for the queue.
+
+ @note
+ The statistics contains the number of `dispatched` blocks, `reentrant`
+ dispatches from within the queue, current `depth` and `maximumDepth` of
+ callers either waiting for or executing on the queue, and percentiles for the
+ `waitTime` and `executionTime`. Each of the percentiles are dictionaries with
+ `p50`, `p95`, `p99`, and `maximum` in seconds.
+ */
+- (NSDictionary *)statistics;
+
+/**
+ Reset the statistics for the queue.
+ */
+- (void)resetStatistics;
+
 @end
@@ -8,11 +8,40 @@
 
 #import "RASqliteQueue.h"
 
+#import <stdatomic.h>
+
+#import "RASqliteHistogram.h"
+
 static RASqliteQueue *_sharedQueue = nil;
 
 static char *const RASqliteQueueNameKey = "me.raatiniemi.rasqlite.queue.name";
 static NSString *const RASqliteThreadFormat = @"me.raatiniemi.rasqlite.%@";
 
+/// Storage for the atomic counters.
+typedef struct {
+    _Atomic(uint64_t) reentrant;
+    _Atomic(int64_t) depth;
+    _Atomic(int64_t) maximumDepth;
+} RASqliteQueueCounters;
+
+/**
+ Build the percentiles for the histogram.
+
+ @param histogram Histogram with durations in nanoseconds.
+
+ @return Percentiles in seconds.
+ */
+static NSDictionary *RASqliteQueuePercentiles(RASqliteHistogram *histogram) {
+    double second = 1000000000.0;
+
+    return @{
+            @"p50": @([histogram valueAtPercentile:50] / second),
+            @"p95": @([histogram valueAtPercentile:95] / second),
+            @"p99": @([histogram valueAtPercentile:99] / second),
+            @"maximum": @([histogram maximum] / second)
+    };
+}
+
 @interface RASqliteQueue ()
 
 /**
@@ -22,11 +51,23 @@ static NSString *const RASqliteThreadFormat = @"me.raatiniemi.rasqlite.%@";
  */
 - (instancetype)initWithName:(NSString *)name;
 
+/**
+ Instantiate queue executing blocks on the calling thread.
+ */
+- (instancetype)initDirect;
+
 @end
 
 @implementation RASqliteQueue {
 @private
     dispatch_queue_t _queue;
+
+    /// Whether blocks are executed directly on the calling thread.
+    BOOL _direct;
+
+    RASqliteQueueCounters *_counters;
+    RASqliteHistogram *_waitTime;
+    RASqliteHistogram *_executionTime;
 }
 
 + (RASqliteQueue *)sharedQueue {
@@ -38,14 +79,38 @@ static NSString *const RASqliteThreadFormat = @"me.raatiniemi.rasqlite.%@";
     return _sharedQueue;
 }
 
++ (RASqliteQueue *)directQueue {
+    return [[RASqliteQueue alloc] initDirect];
+}
+
 - (instancetype)initWithName:(NSString *)name {
     if (self = [super init]) {
         _queue = [self buildQueueWithName:name];
+
+        _counters = calloc(1, sizeof(RASqliteQueueCounters));
+        _waitTime = [[RASqliteHistogram alloc] init];
+        _executionTime = [[RASqliteHistogram alloc] init];
     }
 
     return self;
 }
 
+- (instancetype)initDirect {
+    if (self = [super init]) {
+        _direct = YES;
+
+        _counters = calloc(1, sizeof(RASqliteQueueCounters));
+        _waitTime = [[RASqliteHistogram alloc] init];
+        _executionTime = [[RASqliteHistogram alloc] init];
+    }
+
+    return self;
+}
+
+- (void)dealloc {
+    free(_counters);
+}
+
 - (dispatch_queue_t)buildQueueWithName:(NSString *)name {
     const char *threadName = [[NSString stringWithFormat:RASqliteThreadFormat, name] UTF8String];
     dispatch_queue_t queue = dispatch_queue_create(threadName, NULL);
@@ -56,14 +121,52 @@ static NSString *const RASqliteThreadFormat = @"me.raatiniemi.rasqlite.%@";
 }
 
 - (void)dispatchBlock:(void (^)(void))block {
+    // The depth is still tracked, i.e. the queue is not considered idle
+    // while a block is executing.
+    if (_direct) {
+        atomic_fetch_add_explicit(&_counters->depth, 1, memory_order_relaxed);
+        @try {
+            block();
+        } @finally {
+            atomic_fetch_sub_explicit(&_counters->depth, 1, memory_order_relaxed);
+        }
+        return;
+    }
+
     if (self.isInternalQueue) {
+        atomic_fetch_add_explicit(&_counters->reentrant, 1, memory_order_relaxed);
         block();
         return;
     }
 
-    dispatch_sync(_queue, ^{
-        block();
-    });
+    // The depth includes both the callers waiting for the queue and the
+    // caller that is currently executing on the queue.
+    int64_t depth = atomic_fetch_add_explicit(&_counters->depth, 1, memory_order_relaxed) + 1;
+    int64_t maximum = atomic_load_explicit(&_counters->maximumDepth, memory_order_relaxed);
+    while (depth > maximum) {
+        if (atomic_compare_exchange_weak_explicit(&_counters->maximumDepth, &maximum, depth, memory_order_relaxed, memory_order_relaxed)) {
+            break;
+        }
+    }
+
+    // Exceptions raised within the block, e.g. for nested transactions, are
+    // propagated to the caller. The depth have to be restored, otherwise the
+    // queue would never be considered idle again.
+    uint64_t enqueued = RASqliteTimestamp();
+    @try {
+        dispatch_sync(_queue, ^{
+            uint64_t started = RASqliteTimestamp();
+            [_waitTime recordValue:started - enqueued];
+
+            @try {
+                block();
+            } @finally {
+                [_executionTime recordValue:RASqliteTimestamp() - started];
+            }
+        });
+    } @finally {
+        atomic_fetch_sub_explicit(&_counters->depth, 1, memory_order_relaxed);
+    }
 }
 
 - (BOOL)isInternalQueue {
@@ -72,4 +175,34 @@ static NSString *const RASqliteThreadFormat = @"me.raatiniemi.rasqlite.%@";
     return label == dispatch_queue_get_specific(_queue, RASqliteQueueNameKey);
 }
 
+- (BOOL)isIdle {
+    return atomic_load_explicit(&_counters->depth, memory_order_relaxed) == 0;
+}
+
+- (BOOL)hasWaitingBlocks {
+    // The depth includes the caller that is executing on the queue.
+    return atomic_load_explicit(&_counters->depth, memory_order_relaxed) > 1;
+}
+
+#pragma mark - Statistics
+
+- (NSDictionary *)statistics {
+    return @{
+            @"dispatched": @([_waitTime count]),
+            @"reentrant": @(atomic_load_explicit(&_counters->reentrant, memory_order_relaxed)),
+            @"depth": @(atomic_load_explicit(&_counters->depth, memory_order_relaxed)),
+            @"maximumDepth": @(atomic_load_explicit(&_counters->maximumDepth, memory_order_relaxed)),
+            @"waitTime": RASqliteQueuePercentiles(_waitTime),
+            @"executionTime": RASqliteQueuePercentiles(_executionTime)
+    };
+}
+
+- (void)resetStatistics {
+    atomic_store_explicit(&_counters->reentrant, 0, memory_order_relaxed);
+    atomic_store_explicit(&_counters->maximumDepth, 0, memory_order_relaxed);
+
+    [_waitTime reset];
+    [_executionTime reset];
+}
+
 @end
@@ -0,0 +1,178 @@
+//
+//  RASqliteResultCache.h
+//  RASqlite
+//
+//  Created by Tobias Raatiniemi on 2016-12-27.
+//  Copyright (c) 2016 Raatiniemi. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import <sqlite3.h>
+
+/**
+ Least recently used cache for query results, invalidated by table.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ The tables read by a query are collected with the authorizer while the query
+ is prepared, and the result is invalidated once any of the tables is changed.
+ Changes through the connection are reported by the update hook and by the
+ authorizer when write statements are prepared, while changes from other
+ connections are detected with `PRAGMA data_version` before each lookup.
+
+ @par
+ Reused statements are not prepared again, i.e. the tables written by cached
+ statements have to be collected and invalidated each time they are executed.
+
+ @par
+ The cache is not thread safe, it have to be used from the database queue.
+ */
+@interface RASqliteResultCache : NSObject
+
+/// Stores the memory limit for the cached results, in bytes.
+@property(nonatomic) NSUInteger limit;
+
+/// Stores the estimated memory used by the cached results, in bytes.
+@property(nonatomic, readonly) NSUInteger size;
+
+#pragma mark - Initialization
+
+/**
+ Initialize the cache with memory limit.
+
+ @param limit Memory limit for the cached results, in bytes.
+
+ @return Initialized cache.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (instancetype)initWithLimit:(NSUInteger)limit;
+
+- (id)init __unavailable;
+
+#pragma mark - Connection
+
+/**
+ Register the authorizer on the database connection.
+
+ @param database Database connection to cache results for.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)attachToDatabase:(sqlite3 *)database;
+
+/**
+ Remove the authorizer from the database connection, and the cached results.
+
+ @param database Database connection to stop caching results for.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ Have to be called before the connection is closed.
+ */
+- (void)detachFromDatabase:(sqlite3 *)database;
+
+#pragma mark - Result
+
+/**
+ Retrieve the cached result.
+
+ @param key Key for the query, i.e. the query and its parameters.
+
+ @return Cached result, or `nil` if the result is not cached.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (id)resultForKey:(id)key;
+
+/**
+ Start collecting the tables read by the prepared statement.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)beginCollecting;
+
+/**
+ Stop collecting the tables read by the prepared statement.
+
+ @param tables Names of the tables read by the statement.
+
+ @return `YES` if the result for the statement can be cached, otherwise `NO`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ Statements modifying the database, executing pragmas, or calling functions
+ with a result that is not deterministic, e.g. `random()` or `datetime()`, can
+ not be cached.
+ */
+- (BOOL)endCollecting:(NSSet **)tables;
+
+/**
+ Register the function as returning a different result for the same arguments.
+
+ @param name Name of the function.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ Results for statements calling the function are not cached, the same way as
+ for the built-in functions such as `random()`.
+ */
+- (void)addVolatileFunction:(NSString *)name;
+
+/**
+ Store the result, evicting the least recently used results if needed.
+
+ @param result Immutable result for the query.
+ @param key Key for the query, i.e. the query and its parameters.
+ @param tables Names of the tables read by the query.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)storeResult:(id)result forKey:(id)key tables:(NSSet *)tables;
+
+/**
+ Remove the cached results depending on the table.
+
+ @param table Name of the changed table.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)invalidateTable:(const char *)table;
+
+/**
+ Remove the cached results depending on any of the tables.
+
+ @param tables Names of the changed tables.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)invalidateTables:(NSSet *)tables;
+
+/**
+ Start collecting the tables written by the prepared statement.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)beginCollectingWrites;
+
+/**
+ Stop collecting the tables written by the prepared statement.
+
+ @return Names of the tables written by the statement, including triggers.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (NSSet *)endCollectingWrites;
+
+/**
+ Remove every cached result.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)removeAllResults;
+
+@end
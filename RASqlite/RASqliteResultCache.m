@@ -0,0 +1,433 @@
+//
+//  RASqliteResultCache.m
+//  RASqlite
+//
+//  Created by Tobias Raatiniemi on 2016-12-27.
+//  Copyright (c) 2016 Raatiniemi. All rights reserved.
+//
+
+#import "RASqliteResultCache.h"
+
+/// Estimated overhead for each row and value, in bytes.
+static const NSUInteger RASqliteResultCacheOverhead = 32;
+
+/**
+ Estimate the memory used by the result.
+
+ @param result Array with rows, or a single row.
+
+ @return Estimated size, in bytes.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static NSUInteger RASqliteResultCost(id result) {
+    NSArray *rows = [result isKindOfClass:[NSArray class]] ? result : @[result];
+
+    NSUInteger cost = RASqliteResultCacheOverhead;
+    for (id row in rows) {
+        cost += RASqliteResultCacheOverhead;
+        if (![row isKindOfClass:[NSDictionary class]]) {
+            continue;
+        }
+
+        for (NSString *column in row) {
+            id value = row[column];
+
+            cost += RASqliteResultCacheOverhead + [column length];
+            if ([value isKindOfClass:[NSString class]]) {
+                cost += [value length] * sizeof(unichar);
+            } else if ([value isKindOfClass:[NSData class]]) {
+                cost += [value length];
+            }
+        }
+    }
+
+    return cost;
+}
+
+/**
+ Cached result with its dependencies.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+@interface RASqliteResultCacheEntry : NSObject
+
+/// Stores the immutable result.
+@property(strong, nonatomic) id result;
+
+/// Stores the names of the tables read by the query.
+@property(copy, nonatomic) NSSet *tables;
+
+/// Stores the estimated size of the result, in bytes.
+@property(nonatomic) NSUInteger cost;
+
+/// Stores the tick for when the result was last used.
+@property(nonatomic) uint64_t use;
+
+@end
+
+@implementation RASqliteResultCacheEntry
+
+@end
+
+@interface RASqliteResultCache () {
+@private
+    sqlite3 *_database;
+    sqlite3_stmt *_dataVersion;
+    sqlite3_int64 _version;
+
+    NSMutableDictionary *_entries;
+
+    /// Keys for the cached results, keyed by the table they depend on.
+    NSMutableDictionary *_dependents;
+
+    /// Incremented each time a result is used, orders the results by use.
+    uint64_t _tick;
+
+    /// Incremented each time a result is stored.
+    uint64_t _generation;
+
+    /// Name of the last invalidated table without dependent results.
+    char *_clean;
+    uint64_t _cleanGeneration;
+
+    /// Tables read by the statement being prepared, `nil` unless collecting.
+    NSMutableSet *_collected;
+    BOOL _cacheable;
+
+    /// Tables written by the statement being prepared, `nil` unless collecting.
+    NSMutableSet *_written;
+
+    /// Functions returning a different result for the same arguments.
+    NSMutableSet *_volatileFunctions;
+}
+
+/**
+ Handle the action being authorized while preparing a statement.
+
+ @param action Authorizer action code, e.g. `SQLITE_READ`.
+ @param first First argument for the action, e.g. the table name.
+ @param second Second argument for the action, e.g. the column or function name.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)authorizeAction:(int)action first:(const char *)first second:(const char *)second;
+
+/**
+ Check whether the database have been changed by another connection.
+
+ @return `YES` if the database have been changed, otherwise `NO`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (BOOL)isChangedByOtherConnection;
+
+/**
+ Remove the cached result.
+
+ @param key Key for the query.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)removeResultForKey:(id)key;
+
+/**
+ Evict the least recently used results until the size is within the limit.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)evict;
+
+@end
+
+/**
+ Callback for the SQLite authorizer, collects the dependencies for the statement.
+
+ @return `SQLITE_OK`, i.e. every action is allowed.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+static int RASqliteResultCacheAuthorizer(void *context, int action, const char *first, const char *second, const char *database, const char *trigger) {
+    RASqliteResultCache *cache = (__bridge RASqliteResultCache *) context;
+    [cache authorizeAction:action first:first second:second];
+
+    return SQLITE_OK;
+}
+
+@implementation RASqliteResultCache
+
+#pragma mark - Initialization
+
+- (instancetype)initWithLimit:(NSUInteger)limit {
+    if (self = [super init]) {
+        _limit = limit;
+        _entries = [[NSMutableDictionary alloc] init];
+        _dependents = [[NSMutableDictionary alloc] init];
+
+        _volatileFunctions = [NSMutableSet setWithObjects:@"random", @"randomblob", @"changes", @"total_changes",
+                                                   @"last_insert_rowid", @"date", @"time", @"datetime", @"julianday",
+                                                   @"strftime", @"unixepoch", @"current_date", @"current_time",
+                                                   @"current_timestamp", nil];
+    }
+
+    return self;
+}
+
+- (void)dealloc {
+    free(_clean);
+
+    if (_dataVersion) {
+        sqlite3_finalize(_dataVersion);
+    }
+}
+
+- (void)setLimit:(NSUInteger)limit {
+    _limit = limit;
+    [self evict];
+}
+
+#pragma mark - Connection
+
+- (void)attachToDatabase:(sqlite3 *)database {
+    _database = database;
+    _version = -1;
+
+    sqlite3_set_authorizer(database, RASqliteResultCacheAuthorizer, (__bridge void *) self);
+}
+
+- (void)detachFromDatabase:(sqlite3 *)database {
+    sqlite3_set_authorizer(database, NULL, NULL);
+
+    if (_dataVersion) {
+        sqlite3_finalize(_dataVersion);
+        _dataVersion = NULL;
+    }
+    _database = NULL;
+
+    [self removeAllResults];
+}
+
+- (BOOL)isChangedByOtherConnection {
+    if (!_database) {
+        return YES;
+    }
+
+    if (!_dataVersion && sqlite3_prepare_v2(_database, "PRAGMA data_version", -1, &_dataVersion, NULL) != SQLITE_OK) {
+        return YES;
+    }
+
+    // The data version is only changed by commits from other connections.
+    sqlite3_int64 version = -1;
+    if (sqlite3_step(_dataVersion) == SQLITE_ROW) {
+        version = sqlite3_column_int64(_dataVersion, 0);
+    }
+    sqlite3_reset(_dataVersion);
+
+    BOOL changed = version < 0 || version != _version;
+    _version = version;
+
+    return changed;
+}
+
+#pragma mark - Result
+
+- (id)resultForKey:(id)key {
+    if ([_entries count] == 0) {
+        return nil;
+    }
+
+    if ([self isChangedByOtherConnection]) {
+        [self removeAllResults];
+        return nil;
+    }
+
+    RASqliteResultCacheEntry *entry = _entries[key];
+    [entry setUse:++_tick];
+
+    return [entry result];
+}
+
+- (void)addVolatileFunction:(NSString *)name {
+    [_volatileFunctions addObject:[name lowercaseString]];
+}
+
+- (void)beginCollecting {
+    _collected = [[NSMutableSet alloc] init];
+    _cacheable = YES;
+}
+
+- (BOOL)endCollecting:(NSSet **)tables {
+    *tables = _collected;
+    _collected = nil;
+
+    return _cacheable;
+}
+
+- (void)storeResult:(id)result forKey:(id)key tables:(NSSet *)tables {
+    NSUInteger cost = RASqliteResultCost(result);
+    if (cost > _limit) {
+        return;
+    }
+
+    // The version have to be stored before the first result, otherwise the
+    // result would be removed by the first lookup.
+    if ([_entries count] == 0) {
+        [self isChangedByOtherConnection];
+    }
+
+    [self removeResultForKey:key];
+
+    RASqliteResultCacheEntry *entry = [[RASqliteResultCacheEntry alloc] init];
+    [entry setResult:result];
+    [entry setTables:tables];
+    [entry setCost:cost];
+    [entry setUse:++_tick];
+
+    _entries[key] = entry;
+    _size += cost;
+    _generation++;
+
+    for (NSString *table in tables) {
+        NSMutableSet *keys = _dependents[table];
+        if (!keys) {
+            keys = [[NSMutableSet alloc] init];
+            _dependents[table] = keys;
+        }
+        [keys addObject:key];
+    }
+
+    [self evict];
+}
+
+- (void)invalidateTable:(const char *)table {
+    if ([_dependents count] == 0) {
+        return;
+    }
+
+    // Changes usually target the same table in sequence, e.g. bulk inserts,
+    // i.e. a table without dependent results is skipped until the next
+    // result is stored.
+    if (_clean && _cleanGeneration == _generation && strcmp(_clean, table) == 0) {
+        return;
+    }
+
+    NSString *name = @(table);
+    NSSet *keys = _dependents[name];
+    if (!keys) {
+        free(_clean);
+        _clean = strdup(table);
+        _cleanGeneration = _generation;
+        return;
+    }
+
+    for (id key in [keys allObjects]) {
+        [self removeResultForKey:key];
+    }
+}
+
+- (void)invalidateTables:(NSSet *)tables {
+    for (NSString *table in tables) {
+        [self invalidateTable:[table UTF8String]];
+    }
+}
+
+- (void)beginCollectingWrites {
+    _written = [[NSMutableSet alloc] init];
+}
+
+- (NSSet *)endCollectingWrites {
+    NSSet *tables = [_written copy];
+    _written = nil;
+
+    return tables;
+}
+
+- (void)removeResultForKey:(id)key {
+    RASqliteResultCacheEntry *entry = _entries[key];
+    if (!entry) {
+        return;
+    }
+
+    for (NSString *table in [entry tables]) {
+        NSMutableSet *keys = _dependents[table];
+        [keys removeObject:key];
+
+        if ([keys count] == 0) {
+            [_dependents removeObjectForKey:table];
+        }
+    }
+
+    _size -= [entry cost];
+    [_entries removeObjectForKey:key];
+}
+
+- (void)removeAllResults {
+    [_entries removeAllObjects];
+    [_dependents removeAllObjects];
+    _size = 0;
+}
+
+- (void)evict {
+    // The least recently used result is searched for when evicting, i.e. a
+    // lookup only have to update the tick for the result.
+    while (_size > _limit && [_entries count] > 0) {
+        id oldest;
+        uint64_t use = UINT64_MAX;
+
+        for (id key in _entries) {
+            RASqliteResultCacheEntry *entry = _entries[key];
+            if ([entry use] < use) {
+                use = [entry use];
+                oldest = key;
+            }
+        }
+
+        [self removeResultForKey:oldest];
+    }
+}
+
+#pragma mark - Authorizer
+
+- (void)authorizeAction:(int)action first:(const char *)first second:(const char *)second {
+    switch (action) {
+        case SQLITE_READ:
+            if (_collected && first) {
+                [_collected addObject:@(first)];
+            }
+            break;
+        case SQLITE_SELECT:
+        case SQLITE_RECURSIVE:
+            break;
+        case SQLITE_FUNCTION:
+            if (_collected && second && [_volatileFunctions containsObject:[@(second) lowercaseString]]) {
+                _cacheable = NO;
+            }
+            break;
+        case SQLITE_INSERT:
+        case SQLITE_UPDATE:
+        case SQLITE_DELETE:
+            // The update hook is not called for tables without rowid or rows
+            // removed by the truncate optimization, i.e. the results have to
+            // be invalidated when the statement is prepared.
+            _cacheable = NO;
+            if (first) {
+                [_written addObject:@(first)];
+                [self invalidateTable:first];
+            }
+            break;
+        case SQLITE_DROP_TABLE:
+        case SQLITE_DROP_TEMP_TABLE:
+        case SQLITE_DROP_VIEW:
+        case SQLITE_DROP_TEMP_VIEW:
+        case SQLITE_ALTER_TABLE:
+            _cacheable = NO;
+            [self removeAllResults];
+            break;
+        default:
+            // Pragmas, transactions, attached databases, etc. can not be cached.
+            _cacheable = NO;
+            break;
+    }
+}
+
+@end
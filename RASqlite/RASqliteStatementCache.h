@@ -0,0 +1,74 @@
+//
+//  RASqliteStatementCache.h
+//  RASqlite
+//
+//  Created by Tobias Raatiniemi on 2016-12-22.
+//  Copyright (c) 2016 Raatiniemi. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import <sqlite3.h>
+
+/**
+ Cache for prepared statements, keyed by the query.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ Statements are checked out while in use and checked in when done, i.e. the
+ same statement is never used by nested queries. When the capacity is reached
+ the least recently used statement is finalized. The cache is not thread-safe,
+ and should only be used from the query queue.
+ */
+@interface RASqliteStatementCache : NSObject
+
+#pragma mark - Initialization
+
+/**
+ Initialize the cache with capacity.
+
+ @param capacity Maximum number of cached statements.
+
+ @return Initialized cache.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (instancetype)initWithCapacity:(NSUInteger)capacity;
+
+#pragma mark - Statement
+
+/**
+ Check out the cached statement for the query.
+
+ @param sql Query for the statement.
+
+ @return Cached statement, or `NULL` if none is available.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (sqlite3_stmt *)checkOutStatementForQuery:(NSString *)sql;
+
+/**
+ Check in the statement for the query.
+
+ @param statement Statement to check in, the cache takes ownership of the statement.
+ @param sql Query for the statement.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ The statement is reset and its bindings cleared before it is cached.
+ */
+- (void)checkInStatement:(sqlite3_stmt *)statement forQuery:(NSString *)sql;
+
+/**
+ Finalize every cached statement.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ Have to be called before the database connection is closed.
+ */
+- (void)removeAllStatements;
+
+@end
@@ -0,0 +1,88 @@
+//
+//  RASqliteStatementCache.m
+//  RASqlite
+//
+//  Created by Tobias Raatiniemi on 2016-12-22.
+//  Copyright (c) 2016 Raatiniemi. All rights reserved.
+//
+
+#import "RASqliteStatementCache.h"
+
+@interface RASqliteStatementCache () {
+@private
+    NSUInteger _capacity;
+
+    /// Cached statements, as pointer values keyed by the query.
+    NSMutableDictionary *_statements;
+
+    /// Queries in order of use, least recently used first.
+    NSMutableArray *_queries;
+}
+
+@end
+
+@implementation RASqliteStatementCache
+
+#pragma mark - Initialization
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity {
+    if (self = [super init]) {
+        _capacity = MAX(capacity, 1);
+        _statements = [[NSMutableDictionary alloc] initWithCapacity:_capacity];
+        _queries = [[NSMutableArray alloc] initWithCapacity:_capacity];
+    }
+
+    return self;
+}
+
+- (void)dealloc {
+    [self removeAllStatements];
+}
+
+#pragma mark - Statement
+
+- (sqlite3_stmt *)checkOutStatementForQuery:(NSString *)sql {
+    NSValue *value = _statements[sql];
+    if (!value) {
+        return NULL;
+    }
+
+    [_statements removeObjectForKey:sql];
+    [_queries removeObject:sql];
+
+    return [value pointerValue];
+}
+
+- (void)checkInStatement:(sqlite3_stmt *)statement forQuery:(NSString *)sql {
+    sqlite3_reset(statement);
+    sqlite3_clear_bindings(statement);
+
+    // If a nested query have checked in a statement for the same query, the
+    // one already cached is kept.
+    if (_statements[sql]) {
+        sqlite3_finalize(statement);
+        return;
+    }
+
+    if ([_queries count] >= _capacity) {
+        NSString *query = _queries[0];
+        sqlite3_finalize([_statements[query] pointerValue]);
+
+        [_statements removeObjectForKey:query];
+        [_queries removeObjectAtIndex:0];
+    }
+
+    _statements[sql] = [NSValue valueWithPointer:statement];
+    [_queries addObject:sql];
+}
+
+- (void)removeAllStatements {
+    for (NSValue *value in [_statements allValues]) {
+        sqlite3_finalize([value pointerValue]);
+    }
+
+    [_statements removeAllObjects];
+    [_queries removeAllObjects];
+}
+
+@end
@@ -0,0 +1,67 @@
+//
+//  RASqliteStreamReader.h
+//  RASqlite
+//
+//  Created by Tobias Raatiniemi on 2016-12-23.
+//  Copyright (c) 2016 Raatiniemi. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ Buffered reader for input streams, reading lines or CSV records.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ The stream is read in fixed size chunks, i.e. the memory usage only depends on
+ the size of the current line or record.
+ */
+@interface RASqliteStreamReader : NSObject
+
+/// Stores whether reading from the stream have failed.
+@property(nonatomic, readonly, getter = hasFailed) BOOL failed;
+
+#pragma mark - Initialization
+
+/**
+ Initialize the reader with input stream.
+
+ @param stream Stream to read from, opened if not already open.
+
+ @return Initialized reader.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (instancetype)initWithStream:(NSInputStream *)stream;
+
+- (id)init __unavailable;
+
+#pragma mark - Read
+
+/**
+ Read the next line, without the line break.
+
+ @return The next line, or `nil` at the end of the stream or if reading failed.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (NSData *)nextLine;
+
+/**
+ Read the next CSV record.
+
+ @return The fields of the next record, or `nil` at the end of the stream or if reading failed.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ Fields are returned as strings, quoted fields can span multiple lines and
+ contain escaped quotes. Empty fields are returned as `NSNull`, unless they
+ are quoted, i.e. `""` is returned as an empty string. Empty lines are
+ returned as a record with a single `NSNull` field, e.g. a single column row
+ with `NULL`, except for the trailing line break at the end of the stream.
+ */
+- (NSArray *)nextRecord;
+
+@end
@@ -0,0 +1,209 @@
+//
+//  RASqliteStreamReader.m
+//  RASqlite
+//
+//  Created by Tobias Raatiniemi on 2016-12-23.
+//  Copyright (c) 2016 Raatiniemi. All rights reserved.
+//
+
+#import "RASqliteStreamReader.h"
+
+/// Size of the buffer, in bytes.
+static const NSUInteger RASqliteStreamReaderBufferSize = 64 * 1024;
+
+@interface RASqliteStreamReader () {
+@private
+    NSInputStream *_stream;
+
+    uint8_t *_buffer;
+    NSUInteger _length;
+    NSUInteger _position;
+
+    BOOL _finished;
+}
+
+/**
+ Fill the buffer from the stream, if every byte within the buffer have been read.
+
+ @return `YES` if bytes are available, `NO` at the end of the stream or if reading failed.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (BOOL)fillBuffer;
+
+@end
+
+@implementation RASqliteStreamReader
+
+#pragma mark - Initialization
+
+- (instancetype)initWithStream:(NSInputStream *)stream {
+    if (self = [super init]) {
+        _stream = stream;
+        _buffer = malloc(RASqliteStreamReaderBufferSize);
+
+        if ([_stream streamStatus] == NSStreamStatusNotOpen) {
+            [_stream open];
+        }
+    }
+
+    return self;
+}
+
+- (void)dealloc {
+    free(_buffer);
+}
+
+#pragma mark - Read
+
+- (BOOL)fillBuffer {
+    if (_position < _length) {
+        return YES;
+    }
+
+    if (_finished) {
+        return NO;
+    }
+
+    NSInteger length = [_stream read:_buffer maxLength:RASqliteStreamReaderBufferSize];
+    if (length <= 0) {
+        _failed = length < 0;
+        _finished = YES;
+        return NO;
+    }
+
+    _length = (NSUInteger) length;
+    _position = 0;
+
+    return YES;
+}
+
+- (NSData *)nextLine {
+    NSMutableData *line = [[NSMutableData alloc] init];
+
+    BOOL read = NO;
+    while ([self fillBuffer]) {
+        read = YES;
+
+        const uint8_t *start = _buffer + _position;
+        const uint8_t *newline = memchr(start, '\n', _length - _position);
+        if (!newline) {
+            [line appendBytes:start length:_length - _position];
+            _position = _length;
+            continue;
+        }
+
+        [line appendBytes:start length:(NSUInteger) (newline - start)];
+        _position += (NSUInteger) (newline - start) + 1;
+        break;
+    }
+
+    // Strip the carriage return from lines ending with CRLF.
+    if ([line length] > 0 && ((const uint8_t *) [line bytes])[[line length] - 1] == '\r') {
+        [line setLength:[line length] - 1];
+    }
+
+    return read && !_failed ? line : nil;
+}
+
+- (NSArray *)nextRecord {
+    NSMutableArray *record = [[NSMutableArray alloc] init];
+    NSMutableData *field = [[NSMutableData alloc] init];
+
+    BOOL quoted = NO;
+    BOOL inQuotes = NO;
+    BOOL afterQuote = NO;
+
+    void (^endField)(void) = ^{
+        if ([field length] == 0 && !quoted) {
+            [record addObject:[NSNull null]];
+        } else {
+            NSString *value = [[NSString alloc] initWithData:field encoding:NSUTF8StringEncoding];
+            [record addObject:value ?: [NSNull null]];
+        }
+    };
+
+    // The line break is located once for each buffer, instead of checking
+    // each byte individually.
+    const uint8_t *newline = NULL;
+    while ([self fillBuffer]) {
+        const uint8_t *start = _buffer + _position;
+        const uint8_t *end = _buffer + _length;
+
+        // The buffer have been filled since the line break was located.
+        if (_position == 0) {
+            newline = NULL;
+        }
+
+        if (inQuotes) {
+            const uint8_t *quote = memchr(start, '"', (size_t) (end - start));
+            if (!quote) {
+                [field appendBytes:start length:(NSUInteger) (end - start)];
+                _position = _length;
+                continue;
+            }
+
+            [field appendBytes:start length:(NSUInteger) (quote - start)];
+            _position += (NSUInteger) (quote - start) + 1;
+            inQuotes = NO;
+            afterQuote = YES;
+            continue;
+        }
+
+        // Two quotes within a quoted field is an escaped quote.
+        if (afterQuote && *start == '"') {
+            [field appendBytes:start length:1];
+            _position++;
+            inQuotes = YES;
+            afterQuote = NO;
+            continue;
+        }
+        afterQuote = NO;
+
+        if (*start == '"' && [field length] == 0 && !quoted) {
+            _position++;
+            quoted = YES;
+            inQuotes = YES;
+            continue;
+        }
+
+        if (!newline || newline < start) {
+            newline = memchr(start, '\n', (size_t) (end - start)) ?: end;
+        }
+
+        // Unquoted content continues until the delimiter or the line break,
+        // carriage returns outside of quotes are ignored.
+        const uint8_t *stop = memchr(start, ',', (size_t) (newline - start)) ?: newline;
+        for (const uint8_t *c = start; c < stop;) {
+            const uint8_t *carriage = memchr(c, '\r', (size_t) (stop - c)) ?: stop;
+            [field appendBytes:c length:(NSUInteger) (carriage - c)];
+            c = carriage + 1;
+        }
+
+        _position = (NSUInteger) (stop - _buffer);
+        if (stop == end) {
+            continue;
+        }
+        _position++;
+
+        endField();
+        if (*stop == '\n') {
+            return record;
+        }
+
+        [field setLength:0];
+        quoted = NO;
+    }
+
+    // A single empty field at the end of the stream is the trailing line
+    // break, empty lines within the stream are records with a single field.
+    if (_failed || ([record count] == 0 && [field length] == 0 && !quoted)) {
+        return nil;
+    }
+
+    // The last record is not required to end with a line break.
+    endField();
+    return record;
+}
+
+@end
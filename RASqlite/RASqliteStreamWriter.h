@@ -0,0 +1,71 @@
+//
+//  RASqliteStreamWriter.h
+//  RASqlite
+//
+//  Created by Tobias Raatiniemi on 2016-12-23.
+//  Copyright (c) 2016 Raatiniemi. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ Buffered writer for output streams.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ Bytes are appended to a fixed size buffer, which is written to the stream when
+ full, i.e. the memory usage is constant regardless of the amount written.
+ */
+@interface RASqliteStreamWriter : NSObject
+
+#pragma mark - Initialization
+
+/**
+ Initialize the writer with output stream.
+
+ @param stream Stream to write to, opened if not already open.
+
+ @return Initialized writer.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (instancetype)initWithStream:(NSOutputStream *)stream;
+
+- (id)init __unavailable;
+
+#pragma mark - Write
+
+/**
+ Append bytes to the buffer.
+
+ @param bytes Bytes to append.
+ @param length Number of bytes to append.
+
+ @return `YES` if the bytes have been appended, `NO` if writing to the stream failed.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (BOOL)appendBytes:(const void *)bytes length:(NSUInteger)length;
+
+/**
+ Append null-terminated string to the buffer.
+
+ @param string String to append.
+
+ @return `YES` if the string have been appended, `NO` if writing to the stream failed.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (BOOL)appendString:(const char *)string;
+
+/**
+ Write the buffered bytes to the stream.
+
+ @return `YES` if the bytes have been written, otherwise `NO`.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (BOOL)flush;
+
+@end
@@ -0,0 +1,87 @@
+//
+//  RASqliteStreamWriter.m
+//  RASqlite
+//
+//  Created by Tobias Raatiniemi on 2016-12-23.
+//  Copyright (c) 2016 Raatiniemi. All rights reserved.
+//
+
+#import "RASqliteStreamWriter.h"
+
+/// Size of the buffer, in bytes.
+static const NSUInteger RASqliteStreamWriterBufferSize = 64 * 1024;
+
+@interface RASqliteStreamWriter () {
+@private
+    NSOutputStream *_stream;
+
+    uint8_t *_buffer;
+    NSUInteger _length;
+}
+
+@end
+
+@implementation RASqliteStreamWriter
+
+#pragma mark - Initialization
+
+- (instancetype)initWithStream:(NSOutputStream *)stream {
+    if (self = [super init]) {
+        _stream = stream;
+        _buffer = malloc(RASqliteStreamWriterBufferSize);
+
+        if ([_stream streamStatus] == NSStreamStatusNotOpen) {
+            [_stream open];
+        }
+    }
+
+    return self;
+}
+
+- (void)dealloc {
+    free(_buffer);
+}
+
+#pragma mark - Write
+
+- (BOOL)appendBytes:(const void *)bytes length:(NSUInteger)length {
+    const uint8_t *source = bytes;
+
+    while (length > 0) {
+        if (_length == RASqliteStreamWriterBufferSize && ![self flush]) {
+            return NO;
+        }
+
+        NSUInteger available = MIN(length, RASqliteStreamWriterBufferSize - _length);
+        memcpy(_buffer + _length, source, available);
+
+        _length += available;
+        source += available;
+        length -= available;
+    }
+
+    return YES;
+}
+
+- (BOOL)appendString:(const char *)string {
+    return [self appendBytes:string length:strlen(string)];
+}
+
+- (BOOL)flush {
+    NSUInteger offset = 0;
+
+    // The stream might not accept every byte at once.
+    while (offset < _length) {
+        NSInteger written = [_stream write:_buffer + offset maxLength:_length - offset];
+        if (written <= 0) {
+            return NO;
+        }
+
+        offset += (NSUInteger) written;
+    }
+    _length = 0;
+
+    return YES;
+}
+
+@end
@@ -0,0 +1,61 @@
+//
+//  RASqliteTableChange.h
+//  RASqlite
+//
+//  Created by Tobias Raatiniemi on 2016-12-26.
+//  Copyright (c) 2016 Raatiniemi. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+@class RASqliteTableChange;
+
+/**
+ Block receiving the changes to an observed table.
+
+ @param change Rows that have been changed within the committed transaction.
+ */
+typedef void (^RASqliteChangeHandler)(RASqliteTableChange *change);
+
+/**
+ Rows changed within a table by a committed transaction.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ The changes are coalesced for the whole transaction, i.e. a row that have been
+ both inserted and updated is available within both sets.
+ */
+@interface RASqliteTableChange : NSObject
+
+/// Stores the name of the changed table.
+@property(copy, nonatomic, readonly) NSString *table;
+
+/// Stores the rowids for the inserted rows.
+@property(copy, nonatomic, readonly) NSSet *insertedRowids;
+
+/// Stores the rowids for the updated rows.
+@property(copy, nonatomic, readonly) NSSet *updatedRowids;
+
+/// Stores the rowids for the deleted rows.
+@property(copy, nonatomic, readonly) NSSet *deletedRowids;
+
+#pragma mark - Initialization
+
+/**
+ Initialize with the table and the changed rowids.
+
+ @param table Name of the changed table.
+ @param inserted Rowids for the inserted rows.
+ @param updated Rowids for the updated rows.
+ @param deleted Rowids for the deleted rows.
+
+ @return Initialized change.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (instancetype)initWithTable:(NSString *)table inserted:(NSSet *)inserted updated:(NSSet *)updated deleted:(NSSet *)deleted;
+
+- (id)init __unavailable;
+
+@end
@@ -0,0 +1,35 @@
+//
+//  RASqliteTableChange.m
+//  RASqlite
+//
+//  Created by Tobias Raatiniemi on 2016-12-26.
+//  Copyright (c) 2016 Raatiniemi. All rights reserved.
+//
+
+#import "RASqliteTableChange.h"
+
+@implementation RASqliteTableChange
+
+#pragma mark - Initialization
+
+- (instancetype)initWithTable:(NSString *)table inserted:(NSSet *)inserted updated:(NSSet *)updated deleted:(NSSet *)deleted {
+    if (self = [super init]) {
+        _table = [table copy];
+        _insertedRowids = [inserted copy] ?: [NSSet set];
+        _updatedRowids = [updated copy] ?: [NSSet set];
+        _deletedRowids = [deleted copy] ?: [NSSet set];
+    }
+
+    return self;
+}
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"<%@: %@, inserted: %lu, updated: %lu, deleted: %lu>",
+                                      [self class],
+                                      [self table],
+                                      (unsigned long) [[self insertedRowids] count],
+                                      (unsigned long) [[self updatedRowids] count],
+                                      (unsigned long) [[self deletedRowids] count]];
+}
+
+@end
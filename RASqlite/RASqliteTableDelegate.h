@@ -52,4 +52,17 @@ typedef NS_ENUM(short int, RASqliteTableCheckStatus) {
  */
 - (void)afterTableCheck:(NSString *)table withStatus:(RASqliteTableCheckStatus *)status;
 
+#pragma mark - Migrate
+
+/**
+ Executes while the table data is being copied during a migration.
+
+ @param table Name of the table that is migrated.
+ @param copied Number of rows that have been copied.
+ @param total Total number of rows within the table.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)migrationOfTable:(NSString *)table didCopyRows:(NSUInteger)copied ofTotal:(NSUInteger)total;
+
 @end
\ No newline at end of file
@@ -0,0 +1,47 @@
+//
+//  RASqliteTableOptions.h
+//  RASqlite
+//
+//  Created by Tobias Raatiniemi on 2016-12-11.
+//  Copyright (c) 2016 Raatiniemi. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ Defines the table-level options, used while creating and checking structure.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ The options are defined together with the columns within the table structure,
+ i.e. the array for the table can contain a single `RASqliteTableOptions`.
+
+ @par
+ Composite primary keys are defined by setting `setPrimaryKey:` on each of the
+ columns, the key is built with the columns in the order they are defined.
+ */
+@interface RASqliteTableOptions : NSObject
+
+/// Stores whether the table should be created `WITHOUT ROWID`.
+@property(nonatomic, getter = isWithoutRowid) BOOL withoutRowid;
+
+/// Stores whether the table should be created with `STRICT` typing.
+@property(nonatomic, getter = isStrict) BOOL strict;
+
+#pragma mark - Definition
+
+/**
+ Build the table options clause.
+
+ @return Table options, e.g. `WITHOUT ROWID, STRICT`, or an empty string.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ The clause is appended after the closing parenthesis of the column list.
+ `STRICT` tables require SQLite 3.37.0 or later.
+ */
+- (NSString *)definition;
+
+@end
@@ -0,0 +1,50 @@
+//
+//  RASqliteTableOptions.m
+//  RASqlite
+//
+//  Created by Tobias Raatiniemi on 2016-12-11.
+//  Copyright (c) 2016 Raatiniemi. All rights reserved.
+//
+
+#import "RASqliteTableOptions.h"
+
+@interface RASqliteTableOptions () {
+@private
+    BOOL _withoutRowid;
+    BOOL _strict;
+}
+
+@end
+
+@implementation RASqliteTableOptions
+
+@synthesize withoutRowid = _withoutRowid;
+
+@synthesize strict = _strict;
+
+#pragma mark - Initialization
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _withoutRowid = NO;
+        _strict = NO;
+    }
+    return self;
+}
+
+#pragma mark - Definition
+
+- (NSString *)definition {
+    NSMutableArray *options = [[NSMutableArray alloc] init];
+    if ([self isWithoutRowid]) {
+        [options addObject:@"WITHOUT ROWID"];
+    }
+
+    if ([self isStrict]) {
+        [options addObject:@"STRICT"];
+    }
+
+    return [options componentsJoinedByString:@", "];
+}
+
+@end
@@ -8,10 +8,41 @@
 
 #import <XCTest/XCTest.h>
 #import "RASqlite+RASqliteTable.h"
+#import "RASqlite+RASqliteStream.h"
+#import "NSError+RASqlite.h"
 
 /// Base directory for the unit test databases.
 static NSString *_directory = @"/tmp/rasqlite";
 
+/**
+ Database model with a configurable structure.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+@interface RASqliteTableTestModel : RASqlite {
+@private
+    NSDictionary *_tables;
+}
+
+- (instancetype)initWithPath:(NSString *)path structure:(NSDictionary *)tables;
+
+@end
+
+@implementation RASqliteTableTestModel
+
+- (instancetype)initWithPath:(NSString *)path structure:(NSDictionary *)tables {
+    if (self = [super initWithPath:path]) {
+        _tables = tables;
+    }
+    return self;
+}
+
+- (NSDictionary *)structure {
+    return _tables;
+}
+
+@end
+
 /**
  Unit test for the RASqlite+RATable category.
 
@@ -28,7 +59,33 @@ static NSString *_directory = @"/tmp/rasqlite";
  */
 - (void)testCheck_withoutStructure;
 
-// TODO: Test with structure with mock.
+/**
+ Check structure, the fingerprint should be stored.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testCheck_withStoredFingerprint;
+
+/**
+ Check structure with modified table, the fingerprint should not be stored.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testCheck_withModifiedTable;
+
+/**
+ Check structure with stale fingerprint, modified table should be detected.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testCheck_withStaleFingerprint;
+
+/**
+ Fingerprint should change with the column definitions.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testStructureFingerprint_withModifiedColumn;
 
 /**
  Attempt to check table without table name.
@@ -88,6 +145,71 @@ static NSString *_directory = @"/tmp/rasqlite";
  */
 - (void)testCheckTableWithColumns_withUniqueKeyMismatch;
 
+/**
+ Attempt to check table structure with default value mismatch.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testCheckTableWithColumns_withDefaultValueMismatch;
+
+/**
+ Attempt to check table structure with auto increment mismatch.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testCheckTableWithColumns_withAutoIncrementMismatch;
+
+/**
+ Attempt to check table structure with missing index.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testCheckTableWithColumns_withMissingIndex;
+
+/**
+ Attempt to check table structure with table options mismatch.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testCheckTableWithColumns_withTableOptionsMismatch;
+
+#pragma mark - Migrate
+
+/**
+ Migrate non-existing table, the table should be created.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testMigrateTableWithColumns_withoutExistingTable;
+
+/**
+ Migrate table with appended column, the data should be preserved.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testMigrateTableWithColumns_withAppendedColumn;
+
+/**
+ Migrate table with removed column, the table should be rebuilt.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testMigrateTableWithColumnsProgress_withRemovedColumn;
+
+/**
+ Migrate table with modified index, the index should be recreated.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testMigrateTableWithColumns_withModifiedIndex;
+
+/**
+ Migrate table to `WITHOUT ROWID`, the table should be rebuilt.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testMigrateTableWithColumns_withoutRowid;
+
 #pragma mark - Create
 
 /**
@@ -127,6 +249,13 @@ static NSString *_directory = @"/tmp/rasqlite";
  */
 - (void)testCreateTableWithColumns_withNullType;
 
+/**
+ Create table with composite primary key, without rowid.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testCreateTableWithColumns_withCompositePrimaryKey;
+
 #pragma mark - Delete
 
 /**
@@ -150,6 +279,121 @@ static NSString *_directory = @"/tmp/rasqlite";
  */
 - (void)testDeleteTable_withSuccess;
 
+#pragma mark - Upsert
+
+/**
+ Upsert rows, both inserting and updating rows.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testUpsertRowsIntoTable_withInsertAndUpdate;
+
+/**
+ Upsert rows into table without rowid.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testUpsertRowsIntoTable_withoutRowid;
+
+/**
+ Upsert rows into table without rowid, the reused statement should invalidate the cached result.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testUpsertRowsIntoTable_withoutRowidAndResultCache;
+
+/**
+ Attempt to upsert rows into table without primary key.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testUpsertRowsIntoTable_withoutPrimaryKey;
+
+#pragma mark - Search
+
+/**
+ Search full-text table synced with external content table.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testSearchInTable_withExternalContent;
+
+/**
+ Check structure with full-text table, both before and after creation.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testCheck_withFullTextTable;
+
+/**
+ Attempt to search table that is not a full-text table.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testSearchInTable_withoutFullTextTable;
+
+#pragma mark - Stream
+
+/**
+ Export rows as CSV and import them into another table.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testExportAndImportStream_withCSV;
+
+/**
+ Export rows as NDJSON and import them into another table.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testExportAndImportStream_withNDJSON;
+
+/**
+ Export rows with a single column as CSV, including `NULL` which is exported
+ as an empty line, and import them into another table.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testExportAndImportStream_withSingleColumnNull;
+
+/**
+ Attempt to import stream with column not defined for the table.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testImportStream_withUndefinedColumn;
+
+/**
+ Observe table while importing a chunk that is rolled back, the changes from
+ the chunk should not be delivered.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testImportStream_withObserverAndRolledBackChunk;
+
+#pragma mark - Compression
+
+/**
+ Upsert rows into table with compressed column, mixed with an uncompressed row.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testUpsertRowsIntoTable_withCompressedColumn;
+
+/**
+ Attempt to create table with index for compressed column.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testCreateTableWithColumns_withIndexedCompressedColumn;
+
+/**
+ Attempt to create strict table with compressed text column.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testCreateTableWithColumns_withStrictCompressedTextColumn;
+
 @end
 
 @implementation RASqlite_RASqliteTableTests
@@ -184,6 +428,63 @@ static NSString *_directory = @"/tmp/rasqlite";
     }];
 }
 
+- (void)testCheck_withStoredFingerprint {
+    NSString *path = [_directory stringByAppendingString:@"/check"];
+    NSDictionary *tables = @{@"foo": @[RAColumn(@"id", RASqliteInteger)]};
+    RASqlite *rasqlite = [[RASqliteTableTestModel alloc] initWithPath:path structure:tables];
+
+    XCTAssertTrue([rasqlite create], @"Unable to create structure: %@",
+            [[rasqlite error] localizedDescription]);
+    XCTAssertTrue([rasqlite check], @"Check with created structure failed.");
+
+    NSDictionary *row = [rasqlite fetchRow:@"PRAGMA user_version"];
+    XCTAssertEqual([rasqlite structureFingerprint], [row[@"user_version"] intValue],
+            @"Structure fingerprint have not been stored.");
+
+    // Check with stored fingerprint should skip the table introspection.
+    XCTAssertTrue([rasqlite check], @"Check with stored fingerprint failed.");
+}
+
+- (void)testCheck_withModifiedTable {
+    NSString *path = [_directory stringByAppendingString:@"/check"];
+    NSDictionary *tables = @{@"foo": @[RAColumn(@"id", RASqliteInteger)]};
+    RASqlite *rasqlite = [[RASqliteTableTestModel alloc] initWithPath:path structure:tables];
+
+    XCTAssertTrue([rasqlite createTable:@"foo" withColumns:@[RAColumn(@"bar", RASqliteText)]],
+            @"Unable to create table for modified check.");
+    XCTAssertFalse([rasqlite check], @"Check with modified table was successful.");
+
+    NSDictionary *row = [rasqlite fetchRow:@"PRAGMA user_version"];
+    XCTAssertEqual(0, [row[@"user_version"] intValue],
+            @"Structure fingerprint have been stored for modified table.");
+}
+
+- (void)testCheck_withStaleFingerprint {
+    NSString *path = [_directory stringByAppendingString:@"/check"];
+    NSDictionary *tables = @{@"foo": @[RAColumn(@"id", RASqliteInteger)]};
+    RASqlite *rasqlite = [[RASqliteTableTestModel alloc] initWithPath:path structure:tables];
+
+    XCTAssertTrue([rasqlite create], @"Unable to create structure.");
+    XCTAssertTrue([rasqlite check], @"Check with created structure failed.");
+
+    tables = @{@"foo": @[RAColumn(@"id", RASqliteInteger), RAColumn(@"bar", RASqliteText)]};
+    rasqlite = [[RASqliteTableTestModel alloc] initWithPath:path structure:tables];
+    XCTAssertFalse([rasqlite check], @"Check with stale fingerprint was successful.");
+}
+
+- (void)testStructureFingerprint_withModifiedColumn {
+    NSString *path = [_directory stringByAppendingString:@"/check"];
+
+    RASqliteColumn *column = RAColumn(@"id", RASqliteInteger);
+    RASqlite *rasqlite = [[RASqliteTableTestModel alloc] initWithPath:path structure:@{@"foo": @[column]}];
+    int32_t fingerprint = [rasqlite structureFingerprint];
+    XCTAssertTrue(fingerprint > 0, @"Fingerprint is not a positive value.");
+
+    [column setNullable:YES];
+    XCTAssertNotEqual(fingerprint, [rasqlite structureFingerprint],
+            @"Fingerprint did not change with modified column.");
+}
+
 - (void)testCheckTableWithColumns_withoutTable {
     NSString *path = [_directory stringByAppendingString:@"/check"];
     RASqlite *rasqlite = [[RASqlite alloc] initWithPath:path];
@@ -297,7 +598,198 @@ static NSString *_directory = @"/tmp/rasqlite";
 }
 
 - (void)testCheckTableWithColumns_withUniqueKeyMismatch {
-#warning Implement test for unique key missmatch.
+    NSString *path = [_directory stringByAppendingString:@"/check"];
+    RASqlite *rasqlite = [[RASqlite alloc] initWithPath:path];
+
+    NSArray *columns = @[RAColumn(@"id", RASqliteInteger), RAColumn(@"bar", RASqliteText)];
+    XCTAssertTrue([rasqlite createTable:@"foo" withColumns:columns],
+            @"Unable to create table for unique check.");
+
+    RASqliteColumn *column = RAColumn(@"bar", RASqliteText);
+    [column setUnique:YES];
+    XCTAssertFalse([rasqlite checkTable:@"foo" withColumns:@[RAColumn(@"id", RASqliteInteger), column]],
+            @"Check table with unique key mismatch was successful.");
+    XCTAssertTrue([rasqlite checkTable:@"foo" withColumns:columns],
+            @"Check table with matching unique keys failed.");
+}
+
+- (void)testCheckTableWithColumns_withDefaultValueMismatch {
+    NSString *path = [_directory stringByAppendingString:@"/check"];
+    RASqlite *rasqlite = [[RASqlite alloc] initWithPath:path];
+
+    RASqliteColumn *column = RAColumn(@"bar", RASqliteText);
+    [column setDefaultValue:@"baz"];
+    NSArray *columns = @[RAColumn(@"id", RASqliteInteger), column];
+    XCTAssertTrue([rasqlite createTable:@"foo" withColumns:columns],
+            @"Unable to create table for default value check.");
+    XCTAssertTrue([rasqlite checkTable:@"foo" withColumns:columns],
+            @"Check table with matching default value failed.");
+
+    column = RAColumn(@"bar", RASqliteText);
+    [column setDefaultValue:@"qux"];
+    XCTAssertFalse([rasqlite checkTable:@"foo" withColumns:@[RAColumn(@"id", RASqliteInteger), column]],
+            @"Check table with default value mismatch was successful.");
+}
+
+- (void)testCheckTableWithColumns_withAutoIncrementMismatch {
+    NSString *path = [_directory stringByAppendingString:@"/check"];
+    RASqlite *rasqlite = [[RASqlite alloc] initWithPath:path];
+
+    RASqliteColumn *column = RAColumn(@"id", RASqliteInteger);
+    [column setPrimaryKey:YES];
+    XCTAssertTrue([rasqlite createTable:@"foo" withColumns:@[column]],
+            @"Unable to create table for auto increment check.");
+
+    column = RAColumn(@"id", RASqliteInteger);
+    [column setPrimaryKey:YES];
+    [column setAutoIncrement:YES];
+    XCTAssertFalse([rasqlite checkTable:@"foo" withColumns:@[column]],
+            @"Check table with auto increment mismatch was successful.");
+}
+
+- (void)testCheckTableWithColumns_withMissingIndex {
+    NSString *path = [_directory stringByAppendingString:@"/check"];
+    RASqlite *rasqlite = [[RASqlite alloc] initWithPath:path];
+
+    NSArray *columns = @[RAColumn(@"id", RASqliteInteger), RAColumn(@"bar", RASqliteText)];
+    XCTAssertTrue([rasqlite createTable:@"foo" withColumns:columns],
+            @"Unable to create table for index check.");
+
+    columns = [columns arrayByAddingObject:RAIndex(@"foo_bar", @[@"bar"])];
+    XCTAssertFalse([rasqlite checkTable:@"foo" withColumns:columns],
+            @"Check table with missing index was successful.");
+
+    XCTAssertTrue([rasqlite createTable:@"foo" withColumns:columns],
+            @"Unable to create index for existing table.");
+    XCTAssertTrue([rasqlite checkTable:@"foo" withColumns:columns],
+            @"Check table with created index failed.");
+}
+
+- (void)testCheckTableWithColumns_withTableOptionsMismatch {
+    NSString *path = [_directory stringByAppendingString:@"/check"];
+    RASqlite *rasqlite = [[RASqlite alloc] initWithPath:path];
+
+    RASqliteColumn *column = RAColumn(@"id", RASqliteInteger);
+    [column setPrimaryKey:YES];
+    XCTAssertTrue([rasqlite createTable:@"foo" withColumns:@[column]],
+            @"Unable to create table for table options check.");
+
+    RASqliteTableOptions *options = [[RASqliteTableOptions alloc] init];
+    [options setWithoutRowid:YES];
+    XCTAssertFalse([rasqlite checkTable:@"foo" withColumns:@[column, options]],
+            @"Check table with table options mismatch was successful.");
+}
+
+#pragma mark - Migrate
+
+- (void)testMigrateTableWithColumns_withoutExistingTable {
+    NSString *path = [_directory stringByAppendingString:@"/migrate"];
+    RASqlite *rasqlite = [[RASqlite alloc] initWithPath:path];
+
+    NSArray *columns = @[RAColumn(@"id", RASqliteInteger)];
+    XCTAssertTrue([rasqlite migrateTable:@"foo" withColumns:columns],
+            @"Migrate non-existing table failed: %@", [[rasqlite error] localizedDescription]);
+    XCTAssertTrue([rasqlite checkTable:@"foo" withColumns:columns],
+            @"Migrated table do not match the structure.");
+}
+
+- (void)testMigrateTableWithColumns_withAppendedColumn {
+    NSString *path = [_directory stringByAppendingString:@"/migrate"];
+    RASqlite *rasqlite = [[RASqlite alloc] initWithPath:path];
+
+    NSMutableArray *columns = [[NSMutableArray alloc] init];
+    [columns addObject:RAColumn(@"id", RASqliteInteger)];
+    XCTAssertTrue([rasqlite createTable:@"foo" withColumns:columns],
+            @"Unable to create table for migration.");
+    XCTAssertTrue([rasqlite execute:@"INSERT INTO foo(id) VALUES(1)"],
+            @"Unable to insert row for migration.");
+
+    RASqliteColumn *column = RAColumn(@"bar", RASqliteInteger);
+    [column setDefaultValue:@2];
+    [columns addObject:column];
+
+    XCTAssertTrue([rasqlite migrateTable:@"foo" withColumns:columns],
+            @"Migrate with appended column failed: %@", [[rasqlite error] localizedDescription]);
+    XCTAssertTrue([rasqlite checkTable:@"foo" withColumns:columns],
+            @"Migrated table do not match the structure.");
+
+    NSDictionary *row = [rasqlite fetchRow:@"SELECT id, bar FROM foo"];
+    XCTAssertEqualObjects(@1, row[@"id"], @"Migrate with appended column did not preserve data.");
+    XCTAssertEqualObjects(@2, row[@"bar"], @"Migrate with appended column did not use default value.");
+}
+
+- (void)testMigrateTableWithColumnsProgress_withRemovedColumn {
+    NSString *path = [_directory stringByAppendingString:@"/migrate"];
+    RASqlite *rasqlite = [[RASqlite alloc] initWithPath:path];
+
+    NSArray *columns = @[RAColumn(@"id", RASqliteInteger), RAColumn(@"bar", RASqliteText)];
+    XCTAssertTrue([rasqlite createTable:@"foo" withColumns:columns],
+            @"Unable to create table for migration.");
+    XCTAssertTrue([rasqlite execute:@"INSERT INTO foo(id, bar) VALUES(1, 'baz')"],
+            @"Unable to insert row for migration.");
+    XCTAssertTrue([rasqlite execute:@"CREATE INDEX foo_id ON foo(id)"],
+            @"Unable to create index for migration.");
+
+    NSUInteger __block copied = 0;
+    columns = @[RAColumn(@"id", RASqliteInteger)];
+    BOOL migrated = [rasqlite migrateTable:@"foo" withColumns:columns progress:^(NSUInteger rows, NSUInteger total) {
+        copied = rows;
+    }];
+    XCTAssertTrue(migrated, @"Migrate with removed column failed: %@", [[rasqlite error] localizedDescription]);
+    XCTAssertTrue([rasqlite checkTable:@"foo" withColumns:columns],
+            @"Migrated table do not match the structure.");
+    XCTAssertEqual(1, copied, @"Migrate with removed column did not report progress.");
+
+    NSDictionary *row = [rasqlite fetchRow:@"SELECT id FROM foo"];
+    XCTAssertEqualObjects(@1, row[@"id"], @"Migrate with removed column did not preserve data.");
+    XCTAssertNotNil([rasqlite fetchRow:@"SELECT name FROM sqlite_master WHERE name = 'foo_id'"],
+            @"Migrate with removed column did not recreate index.");
+}
+
+- (void)testMigrateTableWithColumns_withModifiedIndex {
+    NSString *path = [_directory stringByAppendingString:@"/migrate"];
+    RASqlite *rasqlite = [[RASqlite alloc] initWithPath:path];
+
+    NSArray *columns = @[RAColumn(@"id", RASqliteInteger), RAColumn(@"bar", RASqliteText)];
+    NSArray *structure = [columns arrayByAddingObject:RAIndex(@"foo_bar", @[@"bar"])];
+    XCTAssertTrue([rasqlite createTable:@"foo" withColumns:structure],
+            @"Unable to create table for migration.");
+
+    RASqliteIndex *index = [[RASqliteIndex alloc] initWithName:@"foo_bar" columns:@[@"bar", @"id"]];
+    [index setUnique:YES];
+    structure = [columns arrayByAddingObject:index];
+    XCTAssertFalse([rasqlite checkTable:@"foo" withColumns:structure],
+            @"Check table with modified index was successful.");
+
+    XCTAssertTrue([rasqlite migrateTable:@"foo" withColumns:structure],
+            @"Migrate with modified index failed: %@", [[rasqlite error] localizedDescription]);
+    XCTAssertTrue([rasqlite checkTable:@"foo" withColumns:structure],
+            @"Migrated index do not match the structure.");
+}
+
+- (void)testMigrateTableWithColumns_withoutRowid {
+    NSString *path = [_directory stringByAppendingString:@"/migrate"];
+    RASqlite *rasqlite = [[RASqlite alloc] initWithPath:path];
+
+    RASqliteColumn *column = RAColumn(@"id", RASqliteInteger);
+    [column setPrimaryKey:YES];
+    NSArray *columns = @[column, RAColumn(@"bar", RASqliteText)];
+    XCTAssertTrue([rasqlite createTable:@"foo" withColumns:columns],
+            @"Unable to create table for migration.");
+    XCTAssertTrue([rasqlite execute:@"INSERT INTO foo(id, bar) VALUES(1, 'baz')"],
+            @"Unable to insert row for migration.");
+
+    RASqliteTableOptions *options = [[RASqliteTableOptions alloc] init];
+    [options setWithoutRowid:YES];
+    columns = [columns arrayByAddingObject:options];
+
+    XCTAssertTrue([rasqlite migrateTable:@"foo" withColumns:columns],
+            @"Migrate to without rowid failed: %@", [[rasqlite error] localizedDescription]);
+    XCTAssertTrue([rasqlite checkTable:@"foo" withColumns:columns],
+            @"Migrated table do not match the structure.");
+
+    NSDictionary *row = [rasqlite fetchRow:@"SELECT bar FROM foo WHERE id = 1"];
+    XCTAssertEqualObjects(@"baz", row[@"bar"], @"Migrate to without rowid did not preserve data.");
 }
 
 #pragma mark - Create
@@ -356,6 +848,31 @@ static NSString *_directory = @"/tmp/rasqlite";
     }];
 }
 
+- (void)testCreateTableWithColumns_withCompositePrimaryKey {
+    NSString *path = [_directory stringByAppendingString:@"/create"];
+    RASqlite *rasqlite = [[RASqlite alloc] initWithPath:path];
+
+    RASqliteColumn *key = RAColumn(@"key", RASqliteText);
+    [key setPrimaryKey:YES];
+    RASqliteColumn *position = RAColumn(@"position", RASqliteInteger);
+    [position setPrimaryKey:YES];
+
+    RASqliteTableOptions *options = [[RASqliteTableOptions alloc] init];
+    [options setWithoutRowid:YES];
+
+    NSArray *columns = @[key, position, RAColumn(@"value", RASqliteText), options];
+    XCTAssertTrue([rasqlite createTable:@"foo" withColumns:columns],
+            @"Unable to create table with composite primary key: %@",
+            [[rasqlite error] localizedDescription]);
+    XCTAssertTrue([rasqlite checkTable:@"foo" withColumns:columns],
+            @"Created table with composite primary key do not match the structure.");
+
+    XCTAssertTrue([rasqlite execute:@"INSERT INTO foo(key, position, value) VALUES('bar', 1, 'baz')"],
+            @"Unable to insert row with composite primary key.");
+    XCTAssertFalse([rasqlite execute:@"INSERT INTO foo(key, position, value) VALUES('bar', 1, 'qux')"],
+            @"Insert row with duplicated composite primary key was successful.");
+}
+
 #pragma mark - Delete
 
 - (void)testDeleteTable_withoutTable {
@@ -382,4 +899,405 @@ static NSString *_directory = @"/tmp/rasqlite";
             @"Delete table failed.");
 }
 
+#pragma mark - Upsert
+
+- (void)testUpsertRowsIntoTable_withInsertAndUpdate {
+    NSString *path = [_directory stringByAppendingString:@"/upsert"];
+
+    RASqliteColumn *column = RAColumn(@"id", RASqliteInteger);
+    [column setPrimaryKey:YES];
+    RASqliteColumn *level = RAColumn(@"level", RASqliteInteger);
+    [level setDefaultValue:@1];
+    NSDictionary *tables = @{@"foo": @[column, RAColumn(@"bar", RASqliteText), level]};
+
+    RASqlite *rasqlite = [[RASqliteTableTestModel alloc] initWithPath:path structure:tables];
+    XCTAssertTrue([rasqlite create], @"Unable to create structure for upsert.");
+
+    NSUInteger inserted;
+    NSUInteger updated;
+    NSArray *rows = @[@{@"id": @1, @"bar": @"baz"}, @{@"id": @2, @"bar": @"qux", @"level": @2}];
+    XCTAssertTrue([rasqlite upsertRows:rows intoTable:@"foo" inserted:&inserted updated:&updated],
+            @"Upsert failed: %@", [[rasqlite error] localizedDescription]);
+    XCTAssertEqual(2, inserted, @"Rows were not inserted.");
+    XCTAssertEqual(0, updated, @"Rows were updated.");
+
+    // Only the columns within the row should be updated.
+    rows = @[@{@"id": @2, @"bar": @"quux"}, @{@"id": @3, @"bar": @"corge"}];
+    XCTAssertTrue([rasqlite upsertRows:rows intoTable:@"foo" inserted:&inserted updated:&updated],
+            @"Upsert failed: %@", [[rasqlite error] localizedDescription]);
+    XCTAssertEqual(1, inserted, @"Row was not inserted.");
+    XCTAssertEqual(1, updated, @"Row was not updated.");
+
+    NSDictionary *row = [rasqlite fetchRow:@"SELECT bar, level FROM foo WHERE id = 2"];
+    XCTAssertEqualObjects(@"quux", row[@"bar"], @"Column within the row was not updated.");
+    XCTAssertEqualObjects(@2, row[@"level"], @"Column outside of the row was updated.");
+}
+
+- (void)testUpsertRowsIntoTable_withoutRowid {
+    NSString *path = [_directory stringByAppendingString:@"/upsert"];
+
+    RASqliteColumn *column = RAColumn(@"name", RASqliteText);
+    [column setPrimaryKey:YES];
+    RASqliteTableOptions *options = [[RASqliteTableOptions alloc] init];
+    [options setWithoutRowid:YES];
+    NSDictionary *tables = @{@"foo": @[column, RAColumn(@"bar", RASqliteText), options]};
+
+    RASqlite *rasqlite = [[RASqliteTableTestModel alloc] initWithPath:path structure:tables];
+    XCTAssertTrue([rasqlite create], @"Unable to create structure for upsert.");
+    XCTAssertTrue([rasqlite execute:@"INSERT INTO foo(name, bar) VALUES('a', 'baz')"],
+            @"Unable to insert row for upsert.");
+
+    NSUInteger inserted;
+    NSUInteger updated;
+    NSArray *rows = @[@{@"name": @"a", @"bar": @"qux"}, @{@"name": @"b", @"bar": @"qux"}];
+    XCTAssertTrue([rasqlite upsertRows:rows intoTable:@"foo" inserted:&inserted updated:&updated],
+            @"Upsert failed: %@", [[rasqlite error] localizedDescription]);
+    XCTAssertEqual(1, inserted, @"Row was not inserted.");
+    XCTAssertEqual(1, updated, @"Row was not updated.");
+}
+
+- (void)testUpsertRowsIntoTable_withoutRowidAndResultCache {
+    NSString *path = [_directory stringByAppendingString:@"/upsert"];
+
+    RASqliteColumn *column = RAColumn(@"name", RASqliteText);
+    [column setPrimaryKey:YES];
+    RASqliteTableOptions *options = [[RASqliteTableOptions alloc] init];
+    [options setWithoutRowid:YES];
+    NSDictionary *tables = @{@"foo": @[column, RAColumn(@"bar", RASqliteText), options]};
+
+    RASqlite *rasqlite = [[RASqliteTableTestModel alloc] initWithPath:path structure:tables];
+    [rasqlite setResultCacheLimit:1024 * 1024];
+    XCTAssertTrue([rasqlite create], @"Unable to create structure for upsert.");
+
+    // The first upsert prepares the statement, i.e. the second one reuses it.
+    XCTAssertTrue([rasqlite upsertRows:@[@{@"name": @"a", @"bar": @"baz"}] intoTable:@"foo"],
+            @"Upsert failed: %@", [[rasqlite error] localizedDescription]);
+
+    NSDictionary *row = [rasqlite fetchRow:@"SELECT bar FROM foo WHERE name = ?" withParam:@"a"];
+    XCTAssertEqualObjects(@"baz", row[@"bar"], @"Row do not match the upserted value.");
+    XCTAssertEqual(row, [rasqlite fetchRow:@"SELECT bar FROM foo WHERE name = ?" withParam:@"a"],
+            @"Row was not cached.");
+
+    XCTAssertTrue([rasqlite upsertRows:@[@{@"name": @"a", @"bar": @"qux"}] intoTable:@"foo"],
+            @"Upsert failed: %@", [[rasqlite error] localizedDescription]);
+
+    row = [rasqlite fetchRow:@"SELECT bar FROM foo WHERE name = ?" withParam:@"a"];
+    XCTAssertEqualObjects(@"qux", row[@"bar"], @"Cached row was not invalidated by the upsert.");
+}
+
+- (void)testUpsertRowsIntoTable_withoutPrimaryKey {
+    NSString *path = [_directory stringByAppendingString:@"/upsert"];
+    NSDictionary *tables = @{@"foo": @[RAColumn(@"bar", RASqliteText)]};
+    RASqlite *rasqlite = [[RASqliteTableTestModel alloc] initWithPath:path structure:tables];
+
+    // Have to execute within the execute queue, otherwise `XCTAssertThrows`
+    // won't be able to catch the exception.
+    [rasqlite queueWithBlock:^(RASqlite *db) {
+        XCTAssertThrows([db upsertRows:@[@{@"bar": @"baz"}] intoTable:@"foo"],
+                @"Upsert without primary key, no exception thrown.");
+    }];
+}
+
+#pragma mark - Search
+
+- (void)testSearchInTable_withExternalContent {
+    NSString *path = [_directory stringByAppendingString:@"/search"];
+
+    RASqliteColumn *column = RAColumn(@"id", RASqliteInteger);
+    [column setPrimaryKey:YES];
+
+    RASqliteFullTextOptions *options = [[RASqliteFullTextOptions alloc] init];
+    [options setContentTable:@"user"];
+    [options setContentRowid:@"id"];
+    [options setPrefixes:@[@2, @3]];
+
+    NSDictionary *tables = @{
+            @"user": @[column, RAColumn(@"name", RASqliteText), RAColumn(@"email", RASqliteText)],
+            @"user_search": @[RAColumn(@"name", RASqliteText), RAColumn(@"email", RASqliteText), options]
+    };
+
+    RASqlite *rasqlite = [[RASqliteTableTestModel alloc] initWithPath:path structure:tables];
+    XCTAssertTrue([rasqlite create], @"Unable to create structure for search: %@", [[rasqlite error] localizedDescription]);
+
+    XCTAssertTrue([rasqlite execute:@"INSERT INTO user(name, email) VALUES('Tobias Raatiniemi', 'raatiniemi@gmail.com'), ('Foo Bar', 'foo@bar.com')"],
+            @"Unable to insert rows for search.");
+
+    NSArray *hits = [rasqlite search:@"raa" inTable:@"user_search" limit:10];
+    XCTAssertEqual(1, [hits count], @"Search did not find the inserted row.");
+    XCTAssertEqualObjects(@1, hits[0][@"rowid"], @"Hit do not reference the content row.");
+    XCTAssertEqualObjects(@"Tobias <b>Raatiniemi</b>", hits[0][@"snippet"], @"Snippet do not highlight the match.");
+    XCTAssertNotNil(hits[0][@"rank"], @"Hit do not contain the rank.");
+
+    // Text with characters that have special meaning within the query
+    // syntax should be searched as is.
+    XCTAssertEqual(1, [[rasqlite search:@"raatiniemi@gmail.com" inTable:@"user_search" limit:10] count], @"Email was not found.");
+    XCTAssertEqualObjects(@[], [rasqlite search:@"o'neil-smith \"" inTable:@"user_search" limit:10], @"Search with special characters failed.");
+    XCTAssertEqual(2, [[rasqlite searchWithExpression:@"name:tob* OR email:foo*" inTable:@"user_search" limit:10] count],
+            @"Search with expression did not find both rows.");
+
+    // The index should follow updates and deletes on the content table.
+    XCTAssertTrue([rasqlite execute:@"UPDATE user SET name = 'Baz Qux', email = 'baz@qux.com' WHERE id = 2"], @"Unable to update row for search.");
+    XCTAssertTrue([rasqlite execute:@"DELETE FROM user WHERE id = 1"], @"Unable to delete row for search.");
+
+    XCTAssertEqual(0, [[rasqlite search:@"raa" inTable:@"user_search" limit:10] count], @"Deleted row was found.");
+    XCTAssertEqual(0, [[rasqlite search:@"foo" inTable:@"user_search" limit:10] count], @"Updated row was found with old name.");
+    XCTAssertEqual(1, [[rasqlite search:@"baz" inTable:@"user_search" limit:10] count], @"Updated row was not found.");
+}
+
+- (void)testCheck_withFullTextTable {
+    NSString *path = [_directory stringByAppendingString:@"/search"];
+
+    RASqliteFullTextOptions *options = [[RASqliteFullTextOptions alloc] init];
+    [options setContentTable:@"user"];
+
+    NSDictionary *tables = @{
+            @"user": @[RAColumn(@"name", RASqliteText)],
+            @"user_search": @[RAColumn(@"name", RASqliteText), options]
+    };
+
+    RASqlite *rasqlite = [[RASqliteTableTestModel alloc] initWithPath:path structure:tables];
+    XCTAssertFalse([rasqlite check], @"Check of structure without tables was successful.");
+    XCTAssertTrue([rasqlite create], @"Unable to create structure for search: %@", [[rasqlite error] localizedDescription]);
+
+    XCTAssertTrue([rasqlite execute:@"PRAGMA user_version = 0"], @"Unable to reset stored fingerprint.");
+    XCTAssertTrue([rasqlite check], @"Check of structure with full-text table failed.");
+}
+
+- (void)testSearchInTable_withoutFullTextTable {
+    NSString *path = [_directory stringByAppendingString:@"/search"];
+    NSDictionary *tables = @{@"user": @[RAColumn(@"name", RASqliteText)]};
+    RASqlite *rasqlite = [[RASqliteTableTestModel alloc] initWithPath:path structure:tables];
+
+    // Have to execute within the execute queue, otherwise `XCTAssertThrows`
+    // won't be able to catch the exception.
+    [rasqlite queueWithBlock:^(RASqlite *db) {
+        XCTAssertThrows([db search:@"foo" inTable:@"user" limit:10],
+                @"Search without full-text table, no exception thrown.");
+    }];
+}
+
+#pragma mark - Stream
+
+- (void)testExportAndImportStream_withCSV {
+    NSString *path = [_directory stringByAppendingString:@"/stream"];
+
+    NSArray *columns = @[RAColumn(@"id", RASqliteInteger), RAColumn(@"bar", RASqliteText), RAColumn(@"baz", RASqliteReal), RAColumn(@"qux", RASqliteBlob)];
+    NSDictionary *tables = @{@"foo": columns, @"quux": columns};
+
+    RASqlite *rasqlite = [[RASqliteTableTestModel alloc] initWithPath:path structure:tables];
+    XCTAssertTrue([rasqlite create], @"Unable to create structure for stream.");
+    XCTAssertTrue([rasqlite execute:@"INSERT INTO foo(id, bar, baz, qux) VALUES(1, 'a,\"b\"\nc', 1.5, x'00ff'), (2, '', NULL, NULL)"],
+            @"Unable to insert rows for stream.");
+
+    NSOutputStream *output = [NSOutputStream outputStreamToMemory];
+    XCTAssertTrue([rasqlite exportQuery:@"SELECT id, bar, baz, qux FROM foo ORDER BY id" toStream:output format:RASqliteStreamFormatCSV],
+            @"Export failed: %@", [[rasqlite error] localizedDescription]);
+
+    NSData *data = [output propertyForKey:NSStreamDataWrittenToMemoryStreamKey];
+    NSString *csv = [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding];
+    XCTAssertEqualObjects(@"id,bar,baz,qux\n1,\"a,\"\"b\"\"\nc\",1.5,AP8=\n2,\"\",,\n", csv,
+            @"Exported CSV do not match.");
+
+    NSInputStream *input = [NSInputStream inputStreamWithData:data];
+    XCTAssertTrue([rasqlite importStream:input intoTable:@"quux" format:RASqliteStreamFormatCSV],
+            @"Import failed: %@", [[rasqlite error] localizedDescription]);
+
+    NSArray *rows = [rasqlite fetch:@"SELECT id, bar, baz, qux FROM quux ORDER BY id"];
+    XCTAssertEqual(2, [rows count], @"Rows were not imported.");
+    XCTAssertEqualObjects(@"a,\"b\"\nc", rows[0][@"bar"], @"Quoted field was not imported.");
+    XCTAssertEqualObjects(@1.5, rows[0][@"baz"], @"Real was not imported.");
+    XCTAssertEqual(2, [rows[0][@"qux"] length], @"Blob was not decoded.");
+    XCTAssertEqualObjects(@"", rows[1][@"bar"], @"Empty string was not imported.");
+    XCTAssertEqualObjects([NSNull null], rows[1][@"baz"], @"Null was not imported.");
+}
+
+- (void)testExportAndImportStream_withNDJSON {
+    NSString *path = [_directory stringByAppendingString:@"/stream"];
+
+    NSArray *columns = @[RAColumn(@"id", RASqliteInteger), RAColumn(@"bar", RASqliteText)];
+    NSDictionary *tables = @{@"foo": columns, @"quux": columns};
+
+    RASqlite *rasqlite = [[RASqliteTableTestModel alloc] initWithPath:path structure:tables];
+    XCTAssertTrue([rasqlite create], @"Unable to create structure for stream.");
+    XCTAssertTrue([rasqlite execute:@"INSERT INTO foo(id, bar) VALUES(1, 'a\"b'), (2, NULL)"],
+            @"Unable to insert rows for stream.");
+
+    NSOutputStream *output = [NSOutputStream outputStreamToMemory];
+    XCTAssertTrue([rasqlite exportQuery:@"SELECT id, bar FROM foo ORDER BY id" toStream:output format:RASqliteStreamFormatNDJSON],
+            @"Export failed: %@", [[rasqlite error] localizedDescription]);
+
+    NSData *data = [output propertyForKey:NSStreamDataWrittenToMemoryStreamKey];
+    NSString *json = [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding];
+    XCTAssertEqualObjects(@"{\"id\":1,\"bar\":\"a\\\"b\"}\n{\"id\":2,\"bar\":null}\n", json,
+            @"Exported NDJSON do not match.");
+
+    NSInputStream *input = [NSInputStream inputStreamWithData:data];
+    XCTAssertTrue([rasqlite importStream:input intoTable:@"quux" format:RASqliteStreamFormatNDJSON],
+            @"Import failed: %@", [[rasqlite error] localizedDescription]);
+
+    NSArray *rows = [rasqlite fetch:@"SELECT id, bar FROM quux ORDER BY id"];
+    XCTAssertEqual(2, [rows count], @"Rows were not imported.");
+    XCTAssertEqualObjects(@"a\"b", rows[0][@"bar"], @"Escaped string was not imported.");
+    XCTAssertEqualObjects([NSNull null], rows[1][@"bar"], @"Null was not imported.");
+}
+
+- (void)testExportAndImportStream_withSingleColumnNull {
+    NSString *path = [_directory stringByAppendingString:@"/stream"];
+
+    NSArray *columns = @[RAColumn(@"bar", RASqliteText)];
+    NSDictionary *tables = @{@"foo": columns, @"quux": columns};
+
+    RASqlite *rasqlite = [[RASqliteTableTestModel alloc] initWithPath:path structure:tables];
+    XCTAssertTrue([rasqlite create], @"Unable to create structure for stream.");
+    XCTAssertTrue([rasqlite execute:@"INSERT INTO foo(rowid, bar) VALUES(1, 'a'), (2, NULL), (3, ''), (4, NULL)"],
+            @"Unable to insert rows for stream.");
+
+    NSOutputStream *output = [NSOutputStream outputStreamToMemory];
+    XCTAssertTrue([rasqlite exportQuery:@"SELECT bar FROM foo ORDER BY rowid" toStream:output format:RASqliteStreamFormatCSV],
+            @"Export failed: %@", [[rasqlite error] localizedDescription]);
+
+    NSData *data = [output propertyForKey:NSStreamDataWrittenToMemoryStreamKey];
+    NSString *csv = [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding];
+    XCTAssertEqualObjects(@"bar\na\n\n\"\"\n\n", csv, @"Exported CSV do not match.");
+
+    NSInputStream *input = [NSInputStream inputStreamWithData:data];
+    XCTAssertTrue([rasqlite importStream:input intoTable:@"quux" format:RASqliteStreamFormatCSV],
+            @"Import failed: %@", [[rasqlite error] localizedDescription]);
+
+    NSArray *rows = [rasqlite fetch:@"SELECT bar FROM quux ORDER BY rowid"];
+    XCTAssertEqualObjects((@[@"a", [NSNull null], @"", [NSNull null]]), [rows valueForKey:@"bar"],
+            @"Empty lines were not imported as null.");
+}
+
+- (void)testImportStream_withUndefinedColumn {
+    NSString *path = [_directory stringByAppendingString:@"/stream"];
+    NSDictionary *tables = @{@"foo": @[RAColumn(@"bar", RASqliteText)]};
+
+    RASqlite *rasqlite = [[RASqliteTableTestModel alloc] initWithPath:path structure:tables];
+    XCTAssertTrue([rasqlite create], @"Unable to create structure for stream.");
+
+    NSData *data = [@"bar,baz\nqux,quux\n" dataUsingEncoding:NSUTF8StringEncoding];
+    NSInputStream *input = [NSInputStream inputStreamWithData:data];
+    XCTAssertFalse([rasqlite importStream:input intoTable:@"foo" format:RASqliteStreamFormatCSV],
+            @"Import with undefined column was successful.");
+    XCTAssertEqual(RASqliteErrorStream, [[rasqlite error] code], @"Error code do not match.");
+}
+
+- (void)testImportStream_withObserverAndRolledBackChunk {
+    NSString *path = [_directory stringByAppendingString:@"/stream"];
+
+    RASqliteColumn *key = RAColumn(@"id", RASqliteInteger);
+    [key setPrimaryKey:YES];
+
+    RASqliteColumn *bar = RAColumn(@"bar", RASqliteText);
+    [bar setNullable:NO];
+    NSDictionary *tables = @{@"foo": @[key, bar]};
+
+    RASqlite *rasqlite = [[RASqliteTableTestModel alloc] initWithPath:path structure:tables];
+    XCTAssertTrue([rasqlite create], @"Unable to create structure for stream.");
+
+    dispatch_queue_t queue = dispatch_queue_create("me.raatiniemi.rasqlite.tests.stream", DISPATCH_QUEUE_SERIAL);
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Change have been delivered."];
+
+    NSMutableArray *changes = [[NSMutableArray alloc] init];
+    id observer = [rasqlite observeTable:@"foo" queue:queue handler:^(RASqliteTableChange *change) {
+        [changes addObject:change];
+        [expectation fulfill];
+    }];
+
+    // The second row violates the constraint, i.e. the first row is rolled
+    // back to the savepoint for the chunk.
+    NSData *data = [@"id,bar\n1,baz\n2,\n" dataUsingEncoding:NSUTF8StringEncoding];
+    XCTAssertFalse([rasqlite importStream:[NSInputStream inputStreamWithData:data] intoTable:@"foo" format:RASqliteStreamFormatCSV],
+            @"Import with failing row was successful.");
+
+    // Within a transaction the chunk is rolled back to the savepoint, while
+    // the other changes within the transaction are delivered.
+    [rasqlite queueTransactionWithBlock:^(RASqlite *db, BOOL *commit) {
+        [db execute:@"INSERT INTO foo(id, bar) VALUES(3, 'qux')"];
+        [db importStream:[NSInputStream inputStreamWithData:data] intoTable:@"foo" format:RASqliteStreamFormatCSV];
+        *commit = YES;
+    }];
+
+    [self waitForExpectationsWithTimeout:1.0 handler:nil];
+    dispatch_sync(queue, ^{
+    });
+    [rasqlite removeObserver:observer];
+
+    XCTAssertEqual(1, [changes count], @"Rolled back chunk was delivered.");
+    XCTAssertEqualObjects([NSSet setWithObject:@3], [[changes firstObject] insertedRowids], @"Inserted rows do not match.");
+}
+
+#pragma mark - Compression
+
+- (void)testUpsertRowsIntoTable_withCompressedColumn {
+    NSString *path = [_directory stringByAppendingString:@"/compression"];
+
+    RASqliteColumn *column = RAColumn(@"id", RASqliteInteger);
+    [column setPrimaryKey:YES];
+    RASqliteColumn *payload = RAColumn(@"payload", RASqliteText);
+    [payload setCompression:RASqliteCompressionZlib];
+    NSDictionary *tables = @{@"foo": @[column, payload]};
+
+    RASqlite *rasqlite = [[RASqliteTableTestModel alloc] initWithPath:path structure:tables];
+    XCTAssertTrue([rasqlite create], @"Unable to create structure for compression.");
+
+    NSMutableString *text = [[NSMutableString alloc] init];
+    for (NSUInteger index = 0; index < 100; index++) {
+        [text appendFormat:@"{\"id\": %lu, \"name\": \"foo\"},", (unsigned long) index];
+    }
+
+    // Rows written before the compression was enabled are stored as is.
+    XCTAssertTrue([rasqlite execute:@"INSERT INTO foo(id, payload) VALUES(1, ?)" withParam:text], @"Unable to insert row.");
+    XCTAssertTrue([rasqlite upsertRows:@[@{@"id": @2, @"payload": text}, @{@"id": @3, @"payload": @"bar"}] intoTable:@"foo"],
+            @"Upsert failed: %@", [[rasqlite error] localizedDescription]);
+
+    NSArray *results = [rasqlite fetch:@"SELECT typeof(payload) AS type, length(payload) AS length FROM foo ORDER BY id"];
+    XCTAssertEqualObjects(@"text", results[0][@"type"], @"Uncompressed row was modified.");
+    XCTAssertEqualObjects(@"blob", results[1][@"type"], @"Value above the threshold was not compressed.");
+    XCTAssertLessThan([results[1][@"length"] unsignedIntegerValue], [text length], @"Compressed value did not shrink.");
+    XCTAssertEqualObjects(@"text", results[2][@"type"], @"Value below the threshold was compressed.");
+
+    results = [rasqlite fetch:@"SELECT payload FROM foo ORDER BY id"];
+    XCTAssertEqualObjects(text, results[0][@"payload"], @"Uncompressed value do not match.");
+    XCTAssertEqualObjects(text, results[1][@"payload"], @"Compressed value was not decompressed.");
+    XCTAssertEqualObjects(@"bar", results[2][@"payload"], @"Value below the threshold do not match.");
+}
+
+- (void)testCreateTableWithColumns_withIndexedCompressedColumn {
+    NSString *path = [_directory stringByAppendingString:@"/compression"];
+
+    RASqliteColumn *payload = RAColumn(@"payload", RASqliteBlob);
+    [payload setCompression:RASqliteCompressionLZ4];
+    NSDictionary *tables = @{@"foo": @[payload, RAIndex(@"foo_payload", @[@"payload"])]};
+
+    RASqlite *rasqlite = [[RASqliteTableTestModel alloc] initWithPath:path structure:tables];
+    [rasqlite queueWithBlock:^(RASqlite *db) {
+        XCTAssertThrows([db createTable:@"foo" withColumns:tables[@"foo"]],
+                @"Table with indexed compressed column was created.");
+    }];
+}
+
+- (void)testCreateTableWithColumns_withStrictCompressedTextColumn {
+    NSString *path = [_directory stringByAppendingString:@"/compression"];
+
+    RASqliteColumn *payload = RAColumn(@"payload", RASqliteText);
+    [payload setCompression:RASqliteCompressionZlib];
+    RASqliteTableOptions *options = [[RASqliteTableOptions alloc] init];
+    [options setStrict:YES];
+    NSDictionary *tables = @{@"foo": @[payload, options]};
+
+    RASqlite *rasqlite = [[RASqliteTableTestModel alloc] initWithPath:path structure:tables];
+    [rasqlite queueWithBlock:^(RASqlite *db) {
+        XCTAssertThrows([db createTable:@"foo" withColumns:tables[@"foo"]],
+                @"Strict table with compressed text column was created.");
+    }];
+
+    // Compressed blob columns are accepted by strict tables.
+    payload = RAColumn(@"payload", RASqliteBlob);
+    [payload setCompression:RASqliteCompressionZlib];
+    XCTAssertTrue([rasqlite createTable:@"foo" withColumns:@[payload, options]],
+            @"Unable to create strict table: %@", [[rasqlite error] localizedDescription]);
+}
+
 @end
@@ -144,4 +144,44 @@ static NSString *const _databasePath = @"/tmp/rasqlite/binder";
     XCTAssertEqualObjects(value, [NSKeyedUnarchiver unarchiveObjectWithData:row[@"blob"]]);
 }
 
+#pragma mark - Array
+
+- (void)testBindArray_withIntegers {
+    for (int i = 1; i <= 5; i++) {
+        [_rasqlite execute:@"INSERT INTO table_name (integer) VALUES (?)" withParam:@(i)];
+    }
+
+    RASqliteArray *value = [[RASqliteArray alloc] initWithValues:@[@2, @4, @6]];
+    NSArray *rows = [_rasqlite fetch:@"SELECT integer FROM table_name WHERE integer IN rasqlite_array(?) ORDER BY integer"
+                           withParam:value];
+
+    XCTAssertEqualObjects((@[@2, @4]), [rows valueForKey:@"integer"]);
+}
+
+- (void)testBindArray_withBuffer {
+    for (int i = 1; i <= 5; i++) {
+        [_rasqlite execute:@"INSERT INTO table_name (integer) VALUES (?)" withParam:@(i)];
+    }
+
+    // The statement is cached, i.e. it is reused with a different number of values.
+    NSString *sql = @"SELECT COUNT(*) AS count FROM table_name WHERE integer IN rasqlite_array(?)";
+    int64_t buffer[] = {1, 3, 5};
+
+    RASqliteArray *value = [[RASqliteArray alloc] initWithIntegers:buffer count:3];
+    XCTAssertEqualObjects(@3, [_rasqlite fetchRow:sql withParam:value][@"count"]);
+
+    value = [[RASqliteArray alloc] initWithIntegers:buffer count:1];
+    XCTAssertEqualObjects(@1, [_rasqlite fetchRow:sql withParam:value][@"count"]);
+}
+
+- (void)testBindArray_withText {
+    [_rasqlite execute:@"INSERT INTO table_name (text) VALUES (?)" withParam:@"foo"];
+    [_rasqlite execute:@"INSERT INTO table_name (text) VALUES (?)" withParam:@"bar"];
+
+    RASqliteArray *value = [[RASqliteArray alloc] initWithValues:@[@"bar", @"baz"]];
+    NSArray *rows = [_rasqlite fetch:@"SELECT text FROM table_name WHERE text IN rasqlite_array(?)" withParam:value];
+
+    XCTAssertEqualObjects((@[@"bar"]), [rows valueForKey:@"text"]);
+}
+
 @end
@@ -0,0 +1,76 @@
+//
+//  RASqliteHistogramTests.m
+//  RASqlite
+//
+//  Created by Tobias Raatiniemi on 2016-12-17.
+//  Copyright (c) 2016 Raatiniemi. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "RASqliteHistogram.h"
+
+@interface RASqliteHistogramTests : XCTestCase {
+@private
+    RASqliteHistogram *_histogram;
+}
+
+@end
+
+@implementation RASqliteHistogramTests
+
+#pragma mark - Setup/tear down
+
+- (void)setUp {
+    _histogram = [[RASqliteHistogram alloc] init];
+}
+
+#pragma mark - Test
+
+- (void)testValueAtPercentile_withoutValues {
+    XCTAssertEqual(0, [_histogram count]);
+    XCTAssertEqual(0, [_histogram valueAtPercentile:99]);
+}
+
+- (void)testValueAtPercentile_withValues {
+    for (uint64_t value = 1; value <= 1000; value++) {
+        [_histogram recordValue:value * 1000];
+    }
+
+    XCTAssertEqual(1000, [_histogram count]);
+    XCTAssertEqual(1000000, [_histogram maximum]);
+    XCTAssertEqual(500500000, [_histogram sum]);
+
+    // Percentiles are approximated, the relative error is at most 12.5%.
+    uint64_t median = [_histogram valueAtPercentile:50];
+    XCTAssertTrue(median >= 437500 && median <= 562500, @"Median `%llu` is out of range.", median);
+
+    uint64_t tail = [_histogram valueAtPercentile:99.9];
+    XCTAssertTrue(tail >= 874125 && tail <= 1000000, @"Percentile `%llu` is out of range.", tail);
+}
+
+- (void)testRecordValue_fromMultipleThreads {
+    NSOperationQueue *queue = [[NSOperationQueue alloc] init];
+    [queue setMaxConcurrentOperationCount:8];
+
+    for (int i = 0; i < 8; i++) {
+        [queue addOperationWithBlock:^{
+            for (uint64_t value = 0; value < 10000; value++) {
+                [_histogram recordValue:value];
+            }
+        }];
+    }
+    [queue waitUntilAllOperationsAreFinished];
+
+    XCTAssertEqual(80000, [_histogram count]);
+    XCTAssertEqual(9999, [_histogram maximum]);
+}
+
+- (void)testReset_withValues {
+    [_histogram recordValue:42];
+    [_histogram reset];
+
+    XCTAssertEqual(0, [_histogram count]);
+    XCTAssertEqual(0, [_histogram maximum]);
+}
+
+@end
@@ -0,0 +1,109 @@
+//
+//  RASqliteLogTests.m
+//  RASqlite
+//
+//  Created by Tobias Raatiniemi on 2016-12-18.
+//  Copyright (c) 2016 Raatiniemi. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+// Only keep warnings and errors, used for verifying that the debug and info
+// messages are removed by the preprocessor.
+#define RASqliteLogThreshold 2
+#import "RASqliteLog.h"
+
+@interface RASqliteLogTests : XCTestCase {
+@private
+    NSMutableArray *_messages;
+
+    RASqliteLogLevel _level;
+}
+
+/**
+ Retrieve the messages received by the sink.
+
+ @return Copy of the received messages, with file name and message.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+
+ @note
+ The sink is called from the logging thread, i.e. the messages have to be
+ copied while holding the same lock as the sink.
+ */
+- (NSArray *)messages;
+
+@end
+
+@implementation RASqliteLogTests
+
+#pragma mark - Setup/tear down
+
+- (void)setUp {
+    _messages = [[NSMutableArray alloc] init];
+    _level = RASqliteLogGetLevel();
+
+    NSMutableArray *messages = _messages;
+    RASqliteLogSetSink(^(RASqliteLogLevel level, NSString *file, int line, NSString *message) {
+        @synchronized (messages) {
+            [messages addObject:@[file, message]];
+        }
+    });
+}
+
+- (void)tearDown {
+    RASqliteLogFlush();
+    RASqliteLogSetSink(nil);
+    RASqliteLogSetLevel(_level);
+}
+
+- (NSArray *)messages {
+    @synchronized (_messages) {
+        return [_messages copy];
+    }
+}
+
+#pragma mark - Test
+
+- (void)testWrite_withSink {
+    RASqliteLogWrite(RASqliteLogLevelError, "/path/to/RASqlite.m", 1, @"message");
+    RASqliteLogFlush();
+
+    NSArray *messages = [self messages];
+    XCTAssertEqual(1, [messages count]);
+    XCTAssertEqualObjects(@"RASqlite.m", messages[0][0]);
+    XCTAssertEqualObjects(@"message", messages[0][1]);
+}
+
+- (void)testWrite_fromMultipleThreads {
+    dispatch_apply(100, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t index) {
+        RASqliteLogWrite(RASqliteLogLevelError, __FILE__, __LINE__, @"message");
+    });
+    RASqliteLogFlush();
+
+    XCTAssertEqual(100, [[self messages] count]);
+}
+
+- (void)testDebugLog_withLevelBelowThreshold {
+    RASqliteLogSetLevel(RASqliteLogLevelDebug);
+
+    // The arguments for messages below the threshold should not be evaluated.
+    NSUInteger evaluated = 0;
+    RASqliteDebugLog(@"%lu", (unsigned long) ++evaluated);
+    RASqliteInfoLog(@"%lu", (unsigned long) ++evaluated);
+    XCTAssertEqual(0, evaluated, @"Arguments for message below the threshold were evaluated.");
+
+    RASqliteWarningLog(@"%lu", (unsigned long) ++evaluated);
+    RASqliteLogFlush();
+
+    XCTAssertEqual(1, evaluated, @"Arguments for message above the threshold were not evaluated.");
+    XCTAssertEqual(1, [[self messages] count]);
+}
+
+- (void)testSetLevel {
+    RASqliteLogSetLevel(RASqliteLogLevelError);
+
+    XCTAssertEqual(RASqliteLogLevelError, RASqliteLogGetLevel());
+}
+
+@end
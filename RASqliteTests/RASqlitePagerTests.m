@@ -0,0 +1,136 @@
+//
+//  RASqlitePagerTests.m
+//  RASqlite
+//
+//  Created by Tobias Raatiniemi on 2016-12-31.
+//  Copyright (c) 2016 Raatiniemi. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "RASqlite.h"
+
+/// Base directory for the unit test databases.
+static NSString *_directory = @"/tmp/rasqlite";
+
+@interface RASqlitePagerTests : XCTestCase {
+@private
+    RASqlite *_rasqlite;
+}
+
+/**
+ Page forward and backward, with rows sharing the first key.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testNextPageAndPreviousPage_withCompositeKey;
+
+/**
+ Resume paging from a saved cursor with a new pager.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testResumeFromCursor_withNewPager;
+
+/**
+ Attempt to resume from a cursor for other keys.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testResumeFromCursor_withOtherKeys;
+
+@end
+
+@implementation RASqlitePagerTests
+
+#pragma mark - Setup/tear down
+
+- (void)setUp {
+    [super setUp];
+
+    NSFileManager *manager = [NSFileManager defaultManager];
+    [manager createDirectoryAtPath:_directory withIntermediateDirectories:YES attributes:nil error:nil];
+
+    _rasqlite = [[RASqlite alloc] initWithPath:[_directory stringByAppendingString:@"/pager"]];
+    [_rasqlite execute:@"CREATE TABLE foo(id INTEGER PRIMARY KEY, bar TEXT NOT NULL)"];
+
+    // Every third row share the same value, i.e. the id is needed for
+    // the key to be unique.
+    [_rasqlite execute:@"WITH RECURSIVE n(i) AS (SELECT 1 UNION ALL SELECT i + 1 FROM n WHERE i < 10) "
+                       "INSERT INTO foo(id, bar) SELECT i, 'bar' || (i % 3) FROM n"];
+}
+
+- (void)tearDown {
+    _rasqlite = nil;
+
+    NSFileManager *manager = [NSFileManager defaultManager];
+    [manager removeItemAtPath:_directory error:nil];
+
+    [super tearDown];
+}
+
+#pragma mark - Page
+
+- (void)testNextPageAndPreviousPage_withCompositeKey {
+    RASqlitePager *pager = [[RASqlitePager alloc] initWithDatabase:_rasqlite
+                                                             query:@"SELECT id, bar FROM foo WHERE id <> ?"
+                                                            params:@[@5]
+                                                              keys:@[@"bar", @"id"]
+                                                          pageSize:4];
+
+    NSArray *ids = [[pager nextPage] valueForKey:@"id"];
+    XCTAssertEqualObjects((@[@3, @6, @9, @1]), ids, @"First page do not match.");
+
+    ids = [[pager nextPage] valueForKey:@"id"];
+    XCTAssertEqualObjects((@[@4, @7, @10, @2]), ids, @"Second page do not match.");
+
+    ids = [[pager nextPage] valueForKey:@"id"];
+    XCTAssertEqualObjects((@[@8]), ids, @"Last page do not match.");
+
+    XCTAssertEqual(0, [[pager nextPage] count], @"Page after the last page is not empty.");
+
+    ids = [[pager previousPage] valueForKey:@"id"];
+    XCTAssertEqualObjects((@[@4, @7, @10, @2]), ids, @"Previous page do not match.");
+
+    ids = [[pager previousPage] valueForKey:@"id"];
+    XCTAssertEqualObjects((@[@3, @6, @9, @1]), ids, @"First page do not match when paging backward.");
+
+    XCTAssertEqual(0, [[pager previousPage] count], @"Page before the first page is not empty.");
+}
+
+#pragma mark - Cursor
+
+- (void)testResumeFromCursor_withNewPager {
+    RASqlitePager *pager = [[RASqlitePager alloc] initWithDatabase:_rasqlite
+                                                             query:@"SELECT id, bar FROM foo"
+                                                              keys:@[@"id"]
+                                                          pageSize:3];
+    [pager nextPage];
+    NSString *cursor = [pager cursor];
+    XCTAssertNotNil(cursor, @"Cursor is missing after fetching page.");
+
+    pager = [[RASqlitePager alloc] initWithDatabase:_rasqlite
+                                              query:@"SELECT id, bar FROM foo"
+                                               keys:@[@"id"]
+                                           pageSize:3];
+    XCTAssertTrue([pager resumeFromCursor:cursor], @"Unable to resume from cursor.");
+
+    NSArray *ids = [[pager nextPage] valueForKey:@"id"];
+    XCTAssertEqualObjects((@[@4, @5, @6]), ids, @"Page after the cursor do not match.");
+}
+
+- (void)testResumeFromCursor_withOtherKeys {
+    RASqlitePager *pager = [[RASqlitePager alloc] initWithDatabase:_rasqlite
+                                                             query:@"SELECT id, bar FROM foo"
+                                                              keys:@[@"id"]
+                                                          pageSize:3];
+    [pager nextPage];
+
+    RASqlitePager *other = [[RASqlitePager alloc] initWithDatabase:_rasqlite
+                                                             query:@"SELECT id, bar FROM foo"
+                                                              keys:@[@"bar", @"id"]
+                                                          pageSize:3];
+    XCTAssertFalse([other resumeFromCursor:[pager cursor]], @"Resumed from cursor for other keys.");
+    XCTAssertFalse([other resumeFromCursor:@"foo"], @"Resumed from invalid cursor.");
+}
+
+@end
@@ -47,4 +47,66 @@
     XCTAssertTrue(10000 == _number);
 }
 
+- (void)testStatistics_withReentrantDispatch {
+    RASqliteQueue *queue = [RASqliteQueue sharedQueue];
+    [queue resetStatistics];
+
+    NSDictionary *before = [queue statistics];
+    [queue dispatchBlock:^{
+        [queue dispatchBlock:^{
+            _number++;
+        }];
+    }];
+    NSDictionary *after = [queue statistics];
+
+    XCTAssertEqual(1, [after[@"dispatched"] integerValue] - [before[@"dispatched"] integerValue]);
+    XCTAssertEqualObjects(@1, after[@"reentrant"]);
+    XCTAssertEqualObjects(@0, after[@"depth"]);
+    XCTAssertEqualObjects(@1, after[@"maximumDepth"]);
+    XCTAssertTrue([after[@"executionTime"][@"maximum"] doubleValue] > 0);
+}
+
+- (void)testStatistics_fromMultipleThreads {
+    RASqliteQueue *queue = [RASqliteQueue sharedQueue];
+    [queue resetStatistics];
+
+    NSOperationQueue *operations = [[NSOperationQueue alloc] init];
+    [operations setMaxConcurrentOperationCount:8];
+    for (int i = 0; i < 100; i++) {
+        [operations addOperationWithBlock:^{
+            [queue dispatchBlock:^{
+                usleep(100);
+            }];
+        }];
+    }
+    [operations waitUntilAllOperationsAreFinished];
+
+    NSDictionary *statistics = [queue statistics];
+    XCTAssertEqualObjects(@100, statistics[@"dispatched"]);
+    XCTAssertEqualObjects(@0, statistics[@"depth"]);
+    XCTAssertTrue([statistics[@"maximumDepth"] integerValue] > 1, @"Contention was not recorded.");
+    XCTAssertTrue([statistics[@"waitTime"][@"maximum"] doubleValue] > 0, @"Wait time was not recorded.");
+}
+
+- (void)testIsIdle_withRaisedException {
+    RASqliteQueue *queue = [RASqliteQueue sharedQueue];
+
+    XCTAssertThrows([queue dispatchBlock:^{
+        [NSException raise:NSInternalInconsistencyException format:@"Raised within queue."];
+    }]);
+
+    XCTAssertTrue([queue isIdle], @"Depth was not restored after exception.");
+    XCTAssertFalse([queue hasWaitingBlocks], @"Depth was not restored after exception.");
+}
+
+- (void)testIsIdle_withRaisedExceptionOnDirectQueue {
+    RASqliteQueue *queue = [RASqliteQueue directQueue];
+
+    XCTAssertThrows([queue dispatchBlock:^{
+        [NSException raise:NSInternalInconsistencyException format:@"Raised within queue."];
+    }]);
+
+    XCTAssertTrue([queue isIdle], @"Depth was not restored after exception.");
+}
+
 @end
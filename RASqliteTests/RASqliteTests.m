@@ -8,6 +8,7 @@
 
 #import <XCTest/XCTest.h>
 #import "RASqlite+RASqliteTable.h"
+#import "NSError+RASqlite.h"
 
 /// Base directory for the unit test databases.
 static NSString *_directory = @"/tmp/rasqlite";
@@ -103,6 +104,190 @@ static NSString *_directory = @"/tmp/rasqlite";
  */
 - (void)testClose_withoutInitializedDatabase;
 
+#pragma mark - Diagnostics
+
+/**
+ Fetch with full table scan, while query plan advisor is enabled.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testQueryPlanReport_withFullTableScan;
+
+/**
+ Fetch using index, while query plan advisor is enabled.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testQueryPlanReport_withIndex;
+
+/**
+ Fetch and execute queries, while profiling is enabled.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testProfileSnapshot_withQueries;
+
+/**
+ Fetch queries with inlined literals, the queries should be grouped together.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testProfileSnapshot_withInlinedLiterals;
+
+/**
+ Execute script, while profiling is enabled.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testProfileSnapshot_withScript;
+
+#pragma mark - Cancellation
+
+/**
+ Attempt to fetch result with an already cancelled token.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testFetchWithCancellationToken_withCancelledToken;
+
+/**
+ Attempt to fetch result exceeding the time budget of the token.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testFetchWithCancellationToken_withExpiredTimeout;
+
+/**
+ Attempt to fetch result exceeding the query timeout.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testFetch_withQueryTimeout;
+
+/**
+ Execute script with query timeout, the statement exceeding the budget should be interrupted.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testExecuteScript_withQueryTimeout;
+
+/**
+ Execute script with a token exceeding its time budget, the script should be interrupted.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testExecuteScriptWithCancellationToken_withExpiredTimeout;
+
+/**
+ Interrupt the connection from other threads while it is closed, nothing should crash.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testInterrupt_whileClosing;
+
+#pragma mark - Observation
+
+/**
+ Observe table, changes within the transaction should be coalesced.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testObserveTable_withCommittedTransaction;
+
+/**
+ Observe table, changes within rolled back transaction should not be delivered.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testObserveTable_withRolledBackTransaction;
+
+#pragma mark - Cache
+
+/**
+ Fetch cached row, the result should be invalidated by an update.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testFetchRow_withResultCache;
+
+/**
+ Fetch result with non-deterministic function, each fetch should return a new value.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testFetch_withResultCacheAndRandom;
+
+/**
+ Fetch cached row with equal numbers of different types, each type should be
+ cached separately.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testFetchRow_withResultCacheAndNumberTypes;
+
+#pragma mark - Function
+
+/**
+ Register scalar function, the function should be available after reopening the connection.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testRegisterFunction_withReopenedConnection;
+
+/**
+ Register aggregate function, the result should be calculated for each group.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testRegisterAggregate_withGroups;
+
+/**
+ Register function that is not deterministic, the result should not be cached.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testRegisterFunction_withResultCacheAndNotDeterministic;
+
+#pragma mark - Maintenance
+
+/**
+ Perform maintenance, the free pages should be released with incremental vacuum.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testPerformMaintenance_withIncrementalVacuum;
+
+/**
+ Perform maintenance with optimization, the analysis limit configured for the
+ connection should be restored.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testPerformMaintenance_withAnalysisLimit;
+
+#pragma mark - Immutable
+
+/**
+ Read from immutable database, writes should fail.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testImmutableDatabaseWithPath_withRead;
+
+/**
+ Retrieve immutable database from different threads, each thread should get its own connection.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testImmutableDatabaseWithPath_withThreads;
+
+/**
+ Close immutable database, the next retrieval on the thread should open a new connection.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testCloseImmutableDatabaseWithPath;
+
 #pragma mark - Query
 
 // TODO: Add tests for binding and fetching columns.
@@ -190,6 +375,36 @@ static NSString *_directory = @"/tmp/rasqlite";
  */
 - (void)testExecute_withDelete;
 
+#pragma mark -- Script
+
+/**
+ Execute script with multiple statements.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testExecuteScript_withMultipleStatements;
+
+/**
+ Execute script with failing statement within transaction.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testExecuteScript_withInvalidStatement;
+
+/**
+ Execute script with failing statement within active transaction, only the script should be rolled back.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testExecuteScript_withinTransaction;
+
+/**
+ Execute script from file, with statement spanning multiple lines.
+
+ @author Tobias Raatiniemi <raatiniemi@gmail.com>
+ */
+- (void)testExecuteScriptAtPath_withMultipleLines;
+
 #pragma mark - Transaction
 
 /**
@@ -347,6 +562,520 @@ static NSString *_directory = @"/tmp/rasqlite";
             @"Close non initialized database failed: %@", [[rasqlite error] localizedDescription]);
 }
 
+#pragma mark - Diagnostics
+
+- (void)testQueryPlanReport_withFullTableScan {
+    NSString *path = [_directory stringByAppendingString:@"/diagnostics"];
+    RASqlite *rasqlite = [[RASqlite alloc] initWithPath:path];
+    XCTAssertNil([rasqlite queryPlanReport], @"Query plan report is available without advisor.");
+
+    NSArray *columns = @[RAColumn(@"id", RASqliteInteger), RAColumn(@"bar", RASqliteText)];
+    XCTAssertTrue([rasqlite createTable:@"foo" withColumns:columns],
+            @"Unable to create table for `%s`: %@",
+            __PRETTY_FUNCTION__,
+            [[rasqlite error] localizedDescription]);
+
+    [rasqlite setQueryPlanAdvisorEnabled:YES];
+    XCTAssertTrue([rasqlite isQueryPlanAdvisorEnabled], @"Query plan advisor is not enabled.");
+
+    // The query plan should only be analyzed the first time the query is prepared.
+    [rasqlite fetch:@"SELECT id FROM foo WHERE bar = ? ORDER BY id" withParam:@"baz"];
+    [rasqlite fetch:@"SELECT id FROM foo WHERE bar = ? ORDER BY id" withParam:@"qux"];
+
+    NSArray *report = [rasqlite queryPlanReport];
+    XCTAssertEqual(1, [report count], @"Full table scan is not included in the query plan report.");
+
+    NSDictionary *entry = [report firstObject];
+    XCTAssertEqualObjects(@"SELECT id FROM foo WHERE bar = ? ORDER BY id", entry[@"query"],
+            @"Query plan report do not contain the query.");
+    XCTAssertEqualObjects(@[@"foo"], entry[@"tables"],
+            @"Query plan report do not contain the involved tables.");
+    XCTAssertEqual(2, [entry[@"plan"] count],
+            @"Query plan report do not contain both the scan and temporary B-tree.");
+}
+
+- (void)testQueryPlanReport_withIndex {
+    NSString *path = [_directory stringByAppendingString:@"/diagnostics"];
+    RASqlite *rasqlite = [[RASqlite alloc] initWithPath:path];
+
+    NSArray *columns = @[
+            RAColumn(@"id", RASqliteInteger),
+            RAColumn(@"bar", RASqliteText),
+            RAIndex(@"foo_bar", @[@"bar"])
+    ];
+    XCTAssertTrue([rasqlite createTable:@"foo" withColumns:columns],
+            @"Unable to create table for `%s`: %@",
+            __PRETTY_FUNCTION__,
+            [[rasqlite error] localizedDescription]);
+
+    [rasqlite setQueryPlanAdvisorEnabled:YES];
+    [rasqlite fetch:@"SELECT id FROM foo WHERE bar = ?" withParam:@"baz"];
+
+    XCTAssertEqual(0, [[rasqlite queryPlanReport] count],
+            @"Query using index is included in the query plan report.");
+}
+
+- (void)testProfileSnapshot_withQueries {
+    NSString *path = [_directory stringByAppendingString:@"/diagnostics"];
+    RASqlite *rasqlite = [[RASqlite alloc] initWithPath:path];
+    XCTAssertNil([rasqlite profileSnapshot], @"Profile snapshot is available without profiling.");
+
+    [rasqlite setProfilingEnabled:YES];
+    XCTAssertTrue([rasqlite isProfilingEnabled], @"Profiling is not enabled.");
+
+    NSArray *columns = @[RAColumn(@"id", RASqliteInteger)];
+    XCTAssertTrue([rasqlite createTable:@"foo" withColumns:columns],
+            @"Unable to create table for `%s`: %@",
+            __PRETTY_FUNCTION__,
+            [[rasqlite error] localizedDescription]);
+
+    for (int i = 0; i < 3; i++) {
+        [rasqlite execute:@"INSERT INTO foo(id) VALUES(?)" withParam:@(i)];
+    }
+
+    // Queries are grouped by their normalized form.
+    [rasqlite fetch:@"SELECT id FROM foo"];
+    [rasqlite fetch:@"SELECT id\n  FROM foo"];
+
+    NSDictionary *snapshot = [rasqlite profileSnapshot];
+    NSDictionary *insert = snapshot[@"INSERT INTO foo(id) VALUES(?)"];
+    XCTAssertEqualObjects(@3, insert[@"count"], @"Profile do not contain the number of calls.");
+
+    NSDictionary *select = snapshot[@"SELECT id FROM foo"];
+    XCTAssertEqualObjects(@2, select[@"count"], @"Profile did not normalize the query.");
+    XCTAssertEqualObjects(@6, select[@"rows"], @"Profile do not contain the number of rows.");
+    XCTAssertTrue([select[@"p99"] doubleValue] > 0, @"Profile do not contain the latency.");
+
+    [rasqlite setProfilingEnabled:NO];
+    XCTAssertNil([rasqlite profileSnapshot], @"Profile snapshot is available after disabling profiling.");
+}
+
+- (void)testProfileSnapshot_withInlinedLiterals {
+    NSString *path = [_directory stringByAppendingString:@"/diagnostics"];
+    RASqlite *rasqlite = [[RASqlite alloc] initWithPath:path];
+    [rasqlite setProfilingEnabled:YES];
+
+    XCTAssertTrue([rasqlite execute:@"CREATE TABLE \"foo 1\"(id INTEGER, bar TEXT)"], @"Unable to create table.");
+    for (int i = 0; i < 3; i++) {
+        [rasqlite fetch:[NSString stringWithFormat:@"SELECT id FROM \"foo 1\" WHERE id = %d AND bar = 'it''s %d'", i, i]];
+    }
+
+    NSDictionary *snapshot = [rasqlite profileSnapshot];
+    NSDictionary *select = snapshot[@"SELECT id FROM \"foo 1\" WHERE id = ? AND bar = ?"];
+    XCTAssertEqualObjects(@3, select[@"count"], @"Profile did not replace the literals.");
+}
+
+- (void)testProfileSnapshot_withScript {
+    NSString *path = [_directory stringByAppendingString:@"/diagnostics"];
+    RASqlite *rasqlite = [[RASqlite alloc] initWithPath:path];
+    [rasqlite setProfilingEnabled:YES];
+
+    NSString *script = @"CREATE TABLE foo(id INTEGER); INSERT INTO foo(id) VALUES(1)";
+    XCTAssertTrue([rasqlite executeScript:script],
+            @"Script failed: %@",
+            [[rasqlite error] localizedDescription]);
+
+    // Statements within the script are prepared through the same path as the
+    // queries, i.e. the prepare time is recorded for each of them.
+    NSDictionary *snapshot = [rasqlite profileSnapshot];
+    NSDictionary *insert = snapshot[@"INSERT INTO foo(id) VALUES(?)"];
+    XCTAssertTrue([insert[@"prepareTime"] doubleValue] > 0, @"Profile do not contain the prepare time for the script.");
+}
+
+#pragma mark - Cancellation
+
+- (void)testFetchWithCancellationToken_withCancelledToken {
+    NSString *path = [_directory stringByAppendingString:@"/cancellation"];
+    RASqlite *rasqlite = [[RASqlite alloc] initWithPath:path];
+
+    RASqliteCancellationToken *token = [[RASqliteCancellationToken alloc] init];
+    [token cancel];
+
+    NSArray *result = [rasqlite fetch:@"SELECT 1 AS foo" withParams:nil cancellationToken:token];
+    XCTAssertNil(result, @"Query was executed with a cancelled token.");
+    XCTAssertEqual(RASqliteErrorInterrupt, [[rasqlite error] code], @"Cancelled query did not fail with interrupt.");
+}
+
+- (void)testFetchWithCancellationToken_withExpiredTimeout {
+    NSString *path = [_directory stringByAppendingString:@"/cancellation"];
+    RASqlite *rasqlite = [[RASqlite alloc] initWithPath:path];
+
+    // The recursive query never ends, unless it is interrupted.
+    NSString *sql = @"WITH RECURSIVE c(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM c) SELECT count(*) FROM c";
+    RASqliteCancellationToken *token = [RASqliteCancellationToken tokenWithTimeout:0.1];
+
+    NSArray *result = [rasqlite fetch:sql withParams:nil cancellationToken:token];
+    XCTAssertNil(result, @"Query was not interrupted.");
+    XCTAssertEqual(RASqliteErrorInterrupt, [[rasqlite error] code], @"Query did not fail with interrupt.");
+
+    // The connection should be usable after the interrupt.
+    [rasqlite setError:nil];
+    XCTAssertNotNil([rasqlite fetchRow:@"SELECT 1 AS foo"], @"Unable to query after interrupt.");
+}
+
+- (void)testFetch_withQueryTimeout {
+    NSString *path = [_directory stringByAppendingString:@"/cancellation"];
+    RASqlite *rasqlite = [[RASqlite alloc] initWithPath:path];
+    [rasqlite setQueryTimeout:0.1];
+
+    NSString *sql = @"WITH RECURSIVE c(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM c) SELECT count(*) FROM c";
+    XCTAssertNil([rasqlite fetch:sql], @"Query was not interrupted.");
+    XCTAssertEqual(RASqliteErrorInterrupt, [[rasqlite error] code], @"Query did not fail with interrupt.");
+
+    [rasqlite setError:nil];
+    XCTAssertNotNil([rasqlite fetchRow:@"SELECT 1 AS foo"], @"Unable to query within the timeout.");
+}
+
+- (void)testExecuteScript_withQueryTimeout {
+    NSString *path = [_directory stringByAppendingString:@"/cancellation"];
+    RASqlite *rasqlite = [[RASqlite alloc] initWithPath:path];
+    [rasqlite setQueryTimeout:0.1];
+
+    NSString *script = @"CREATE TABLE foo(id INTEGER PRIMARY KEY);\n"
+            "WITH RECURSIVE c(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM c) SELECT count(*) FROM c;";
+    XCTAssertFalse([rasqlite executeScript:script], @"Script was not interrupted.");
+    XCTAssertEqual(RASqliteErrorInterrupt, [[rasqlite error] code], @"Script did not fail with interrupt.");
+}
+
+- (void)testExecuteScriptWithCancellationToken_withExpiredTimeout {
+    NSString *path = [_directory stringByAppendingString:@"/cancellation"];
+    RASqlite *rasqlite = [[RASqlite alloc] initWithPath:path];
+    RASqliteCancellationToken *token = [RASqliteCancellationToken tokenWithTimeout:0.1];
+
+    NSString *script = @"CREATE TABLE foo(id INTEGER PRIMARY KEY);\n"
+            "WITH RECURSIVE c(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM c) SELECT count(*) FROM c;\n"
+            "CREATE TABLE bar(id INTEGER PRIMARY KEY);";
+    XCTAssertFalse([rasqlite executeScript:script inTransaction:NO cancellationToken:token], @"Script was not interrupted.");
+    XCTAssertEqual(RASqliteErrorInterrupt, [[rasqlite error] code], @"Script did not fail with interrupt.");
+
+    [rasqlite setError:nil];
+    NSDictionary *row = [rasqlite fetchRow:@"SELECT count(*) AS count FROM sqlite_master WHERE name = 'bar'"];
+    XCTAssertEqualObjects(@0, row[@"count"], @"Statements after the cancellation were executed.");
+}
+
+- (void)testInterrupt_whileClosing {
+    NSString *path = [_directory stringByAppendingString:@"/cancellation"];
+    RASqlite *rasqlite = [[RASqlite alloc] initWithPath:path];
+
+    dispatch_queue_t queue = dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0);
+    dispatch_apply(200, queue, ^(size_t index) {
+        if (index % 2) {
+            [rasqlite interrupt];
+        } else {
+            [rasqlite fetchRow:@"SELECT 1 AS foo"];
+            [rasqlite close];
+        }
+    });
+
+    [rasqlite setError:nil];
+    XCTAssertNotNil([rasqlite fetchRow:@"SELECT 1 AS foo"], @"Unable to query after interrupts.");
+}
+
+- (void)testObserveTable_withCommittedTransaction {
+    NSString *path = [_directory stringByAppendingString:@"/observation"];
+    RASqlite *rasqlite = [[RASqlite alloc] initWithPath:path];
+    XCTAssertTrue([rasqlite execute:@"CREATE TABLE foo(id INTEGER PRIMARY KEY, bar TEXT)"], @"Unable to create table.");
+
+    dispatch_queue_t queue = dispatch_queue_create("me.raatiniemi.rasqlite.tests.observation", DISPATCH_QUEUE_SERIAL);
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Change have been delivered."];
+
+    NSMutableArray *changes = [[NSMutableArray alloc] init];
+    id observer = [rasqlite observeTable:@"foo" queue:queue handler:^(RASqliteTableChange *change) {
+        [changes addObject:change];
+        [expectation fulfill];
+    }];
+
+    [rasqlite queueTransactionWithBlock:^(RASqlite *db, BOOL *commit) {
+        [db execute:@"INSERT INTO foo(id, bar) VALUES(1, 'baz'), (2, 'qux')"];
+        [db execute:@"UPDATE foo SET bar = 'quux' WHERE id = 2"];
+        *commit = YES;
+    }];
+
+    [self waitForExpectationsWithTimeout:1.0 handler:nil];
+
+    // Wait for any additional deliveries before checking the changes.
+    dispatch_sync(queue, ^{
+    });
+    [rasqlite removeObserver:observer];
+
+    XCTAssertEqual(1, [changes count], @"Changes within the transaction were not coalesced.");
+    RASqliteTableChange *change = [changes firstObject];
+    XCTAssertEqualObjects(@"foo", [change table], @"Change do not reference the table.");
+    XCTAssertEqualObjects(([NSSet setWithObjects:@1, @2, nil]), [change insertedRowids], @"Inserted rows do not match.");
+    XCTAssertEqualObjects([NSSet setWithObject:@2], [change updatedRowids], @"Updated rows do not match.");
+    XCTAssertEqual(0, [[change deletedRowids] count], @"Rows were reported as deleted.");
+}
+
+- (void)testObserveTable_withRolledBackTransaction {
+    NSString *path = [_directory stringByAppendingString:@"/observation"];
+    RASqlite *rasqlite = [[RASqlite alloc] initWithPath:path];
+    XCTAssertTrue([rasqlite execute:@"CREATE TABLE foo(id INTEGER PRIMARY KEY, bar TEXT)"], @"Unable to create table.");
+
+    dispatch_queue_t queue = dispatch_queue_create("me.raatiniemi.rasqlite.tests.observation", DISPATCH_QUEUE_SERIAL);
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Change have been delivered."];
+
+    NSMutableArray *changes = [[NSMutableArray alloc] init];
+    id observer = [rasqlite observeTable:@"foo" queue:queue handler:^(RASqliteTableChange *change) {
+        [changes addObject:change];
+        [expectation fulfill];
+    }];
+
+    [rasqlite queueTransactionWithBlock:^(RASqlite *db, BOOL *commit) {
+        [db execute:@"INSERT INTO foo(id, bar) VALUES(1, 'baz')"];
+        *commit = NO;
+    }];
+
+    // Statements outside of a transaction are committed automatically.
+    XCTAssertTrue([rasqlite execute:@"INSERT INTO foo(id, bar) VALUES(2, 'qux')"], @"Unable to insert row.");
+
+    [self waitForExpectationsWithTimeout:1.0 handler:nil];
+    dispatch_sync(queue, ^{
+    });
+    [rasqlite removeObserver:observer];
+
+    XCTAssertEqual(1, [changes count], @"Rolled back transaction was delivered.");
+    XCTAssertEqualObjects([NSSet setWithObject:@2], [[changes firstObject] insertedRowids], @"Inserted rows do not match.");
+}
+
+#pragma mark - Cache
+
+- (void)testFetchRow_withResultCache {
+    NSString *path = [_directory stringByAppendingString:@"/cache"];
+    RASqlite *rasqlite = [[RASqlite alloc] initWithPath:path];
+    [rasqlite setResultCacheLimit:1024 * 1024];
+
+    XCTAssertTrue([rasqlite execute:@"CREATE TABLE foo(id INTEGER PRIMARY KEY, bar TEXT)"], @"Unable to create table.");
+    XCTAssertTrue([rasqlite execute:@"INSERT INTO foo(id, bar) VALUES(1, 'baz')"], @"Unable to insert row.");
+
+    NSDictionary *row = [rasqlite fetchRow:@"SELECT bar FROM foo WHERE id = ?" withParam:@1];
+    XCTAssertEqualObjects(@"baz", row[@"bar"], @"Row do not match the inserted value.");
+
+    // The second fetch should be retrieved from the cache.
+    XCTAssertEqual(row, [rasqlite fetchRow:@"SELECT bar FROM foo WHERE id = ?" withParam:@1], @"Row was not cached.");
+
+    XCTAssertTrue([rasqlite execute:@"UPDATE foo SET bar = 'qux' WHERE id = 1"], @"Unable to update row.");
+
+    row = [rasqlite fetchRow:@"SELECT bar FROM foo WHERE id = ?" withParam:@1];
+    XCTAssertEqualObjects(@"qux", row[@"bar"], @"Cached row was not invalidated by the update.");
+}
+
+- (void)testFetch_withResultCacheAndRandom {
+    NSString *path = [_directory stringByAppendingString:@"/cache"];
+    RASqlite *rasqlite = [[RASqlite alloc] initWithPath:path];
+    [rasqlite setResultCacheLimit:1024 * 1024];
+
+    NSMutableSet *values = [[NSMutableSet alloc] init];
+    for (NSUInteger index = 0; index < 3; index++) {
+        NSArray *rows = [rasqlite fetch:@"SELECT random() AS value"];
+        XCTAssertEqual(1, [rows count], @"Unable to fetch result.");
+
+        [values addObject:[rows firstObject][@"value"]];
+    }
+
+    XCTAssertEqual(3, [values count], @"Result with non-deterministic function was cached.");
+}
+
+- (void)testFetchRow_withResultCacheAndNumberTypes {
+    NSString *path = [_directory stringByAppendingString:@"/cache"];
+    RASqlite *rasqlite = [[RASqlite alloc] initWithPath:path];
+    [rasqlite setResultCacheLimit:1024 * 1024];
+
+    XCTAssertTrue([rasqlite execute:@"CREATE TABLE foo(id INTEGER PRIMARY KEY)"], @"Unable to create table.");
+    XCTAssertTrue([rasqlite execute:@"INSERT INTO foo(id) VALUES(1)"], @"Unable to insert row.");
+
+    // The numbers are equal, but bound as integer and real respectively.
+    NSString *sql = @"SELECT typeof(?) AS type FROM foo";
+    XCTAssertEqualObjects(@"integer", [rasqlite fetchRow:sql withParam:@1][@"type"], @"Integer was not bound as integer.");
+    XCTAssertEqualObjects(@"real", [rasqlite fetchRow:sql withParam:@1.0][@"type"], @"Cached row for integer was returned for real.");
+}
+
+#pragma mark - Function
+
+- (void)testRegisterFunction_withReopenedConnection {
+    NSString *path = [_directory stringByAppendingString:@"/function"];
+    RASqlite *rasqlite = [[RASqlite alloc] initWithPath:path];
+
+    BOOL registered = [rasqlite registerFunction:@"reverse" arity:1 deterministic:YES block:^id(RASqliteFunctionArguments *arguments) {
+        NSString *text = [arguments textAtIndex:0];
+        NSMutableString *reversed = [[NSMutableString alloc] initWithCapacity:[text length]];
+        for (NSInteger index = [text length] - 1; index >= 0; index--) {
+            [reversed appendFormat:@"%C", [text characterAtIndex:(NSUInteger) index]];
+        }
+
+        return reversed;
+    }];
+    XCTAssertTrue(registered, @"Unable to register function: %@", [[rasqlite error] localizedDescription]);
+
+    NSDictionary *row = [rasqlite fetchRow:@"SELECT reverse(?) AS value" withParam:@"foo"];
+    XCTAssertEqualObjects(@"oof", row[@"value"], @"Function did not return the reversed text.");
+
+    XCTAssertTrue([rasqlite close], @"Unable to close database: %@", [[rasqlite error] localizedDescription]);
+
+    row = [rasqlite fetchRow:@"SELECT reverse(?) AS value" withParam:@"bar"];
+    XCTAssertEqualObjects(@"rab", row[@"value"], @"Function was not registered after reopening the connection.");
+}
+
+- (void)testRegisterAggregate_withGroups {
+    NSString *path = [_directory stringByAppendingString:@"/function"];
+    RASqlite *rasqlite = [[RASqlite alloc] initWithPath:path];
+
+    BOOL registered = [rasqlite registerAggregate:@"product" arity:1 deterministic:YES step:^(NSMutableDictionary *context, RASqliteFunctionArguments *arguments) {
+        sqlite3_int64 product = [context[@"product"] longLongValue] ?: 1;
+        context[@"product"] = @(product * [arguments integerAtIndex:0]);
+    } final:^id(NSMutableDictionary *context) {
+        return context[@"product"];
+    }];
+    XCTAssertTrue(registered, @"Unable to register aggregate: %@", [[rasqlite error] localizedDescription]);
+
+    XCTAssertTrue([rasqlite execute:@"CREATE TABLE foo(grp INTEGER, value INTEGER)"], @"Unable to create table.");
+    XCTAssertTrue([rasqlite execute:@"INSERT INTO foo(grp, value) VALUES(1, 2), (1, 3), (2, 4), (2, 5)"], @"Unable to insert rows.");
+
+    NSArray *results = [rasqlite fetch:@"SELECT grp, product(value) AS value FROM foo GROUP BY grp ORDER BY grp"];
+    XCTAssertEqual(2, [results count], @"Number of groups do not match.");
+    XCTAssertEqualObjects(@6, results[0][@"value"], @"Product for the first group do not match.");
+    XCTAssertEqualObjects(@20, results[1][@"value"], @"Product for the second group do not match.");
+
+    NSDictionary *row = [rasqlite fetchRow:@"SELECT product(value) AS value FROM foo WHERE grp = 3"];
+    XCTAssertEqualObjects([NSNull null], row[@"value"], @"Product without rows should be `NULL`.");
+}
+
+- (void)testRegisterFunction_withResultCacheAndNotDeterministic {
+    NSString *path = [_directory stringByAppendingString:@"/function"];
+    RASqlite *rasqlite = [[RASqlite alloc] initWithPath:path];
+
+    NSInteger __block counter = 0;
+    RASqliteFunctionBlock block = ^id(RASqliteFunctionArguments *arguments) {
+        return @(++counter);
+    };
+
+    // Functions registered both before and after the cache is enabled have
+    // to be excluded from the cache.
+    XCTAssertTrue([rasqlite registerFunction:@"counter" arity:0 deterministic:NO block:block],
+            @"Unable to register function: %@", [[rasqlite error] localizedDescription]);
+    [rasqlite setResultCacheLimit:1024 * 1024];
+    XCTAssertTrue([rasqlite registerFunction:@"Tick" arity:0 deterministic:NO block:block],
+            @"Unable to register function: %@", [[rasqlite error] localizedDescription]);
+
+    NSDictionary *first = [rasqlite fetchRow:@"SELECT counter() AS value"];
+    NSDictionary *second = [rasqlite fetchRow:@"SELECT counter() AS value"];
+    XCTAssertNotEqualObjects(first[@"value"], second[@"value"], @"Result for function registered before the cache was cached.");
+
+    first = [rasqlite fetchRow:@"SELECT tick() AS value"];
+    second = [rasqlite fetchRow:@"SELECT tick() AS value"];
+    XCTAssertNotEqualObjects(first[@"value"], second[@"value"], @"Result for function registered after the cache was cached.");
+}
+
+#pragma mark - Maintenance
+
+- (void)testPerformMaintenance_withIncrementalVacuum {
+    NSString *path = [_directory stringByAppendingString:@"/maintenance"];
+    RASqlite *rasqlite = [[RASqlite alloc] initWithPath:path];
+
+    // The vacuum mode have to be configured before any table is created.
+    XCTAssertTrue([rasqlite execute:@"PRAGMA auto_vacuum = INCREMENTAL"], @"Unable to configure vacuum.");
+    XCTAssertTrue([rasqlite execute:@"CREATE TABLE foo(id INTEGER PRIMARY KEY, bar BLOB)"], @"Unable to create table.");
+    XCTAssertTrue([rasqlite execute:@"WITH RECURSIVE n(i) AS (SELECT 1 UNION ALL SELECT i + 1 FROM n WHERE i < 200) "
+                                    "INSERT INTO foo(bar) SELECT randomblob(1000) FROM n"], @"Unable to insert rows.");
+    XCTAssertTrue([rasqlite execute:@"DELETE FROM foo"], @"Unable to delete rows.");
+
+    NSDictionary *row = [rasqlite fetchRow:@"PRAGMA freelist_count"];
+    XCTAssertGreaterThan([row[@"freelist_count"] integerValue], 0, @"Deleted rows did not leave any free pages.");
+
+    XCTAssertTrue([rasqlite performMaintenance], @"Unable to perform maintenance: %@", [[rasqlite error] localizedDescription]);
+
+    row = [rasqlite fetchRow:@"PRAGMA freelist_count"];
+    XCTAssertEqual(0, [row[@"freelist_count"] integerValue], @"Free pages were not released by the maintenance.");
+}
+
+- (void)testPerformMaintenance_withAnalysisLimit {
+    NSString *path = [_directory stringByAppendingString:@"/maintenance"];
+    RASqlite *rasqlite = [[RASqlite alloc] initWithPath:path];
+
+    XCTAssertTrue([rasqlite execute:@"PRAGMA analysis_limit = 123"], @"Unable to configure analysis limit.");
+    XCTAssertTrue([rasqlite execute:@"CREATE TABLE foo(id INTEGER PRIMARY KEY, bar INTEGER)"], @"Unable to create table.");
+    XCTAssertTrue([rasqlite execute:@"CREATE INDEX foo_bar ON foo(bar)"], @"Unable to create index.");
+
+    // Enough rows have to be changed for the optimization to run.
+    XCTAssertTrue([rasqlite execute:@"WITH RECURSIVE n(i) AS (SELECT 1 UNION ALL SELECT i + 1 FROM n WHERE i < 2000) "
+                                    "INSERT INTO foo(bar) SELECT i % 10 FROM n"], @"Unable to insert rows.");
+
+    XCTAssertTrue([rasqlite performMaintenance], @"Unable to perform maintenance: %@", [[rasqlite error] localizedDescription]);
+
+    NSDictionary *row = [rasqlite fetchRow:@"PRAGMA analysis_limit"];
+    XCTAssertEqual(123, [row[@"analysis_limit"] integerValue], @"Analysis limit was not restored by the maintenance.");
+}
+
+#pragma mark - Immutable
+
+- (void)testImmutableDatabaseWithPath_withRead {
+    NSString *path = [_directory stringByAppendingString:@"/immutable read"];
+    RASqlite *rasqlite = [[RASqlite alloc] initWithPath:path];
+    XCTAssertTrue([rasqlite execute:@"CREATE TABLE foo(id INTEGER PRIMARY KEY, bar TEXT)"], @"Unable to create table.");
+    XCTAssertTrue([rasqlite execute:@"INSERT INTO foo(bar) VALUES('baz')"], @"Unable to insert row.");
+    XCTAssertTrue([rasqlite close], @"Unable to close database.");
+
+    RASqlite *immutable = [RASqlite immutableDatabaseWithPath:path];
+    XCTAssertTrue([immutable isImmutable], @"Database is not immutable.");
+
+    NSDictionary *row = [immutable fetchRow:@"SELECT bar FROM foo WHERE id = ?" withParam:@1];
+    XCTAssertEqualObjects(@"baz", row[@"bar"], @"Unable to read from immutable database: %@", [[immutable error] localizedDescription]);
+
+    XCTAssertFalse([immutable execute:@"INSERT INTO foo(bar) VALUES('qux')"], @"Able to write to immutable database.");
+    XCTAssertNotNil([immutable error], @"Error is `nil` after write to immutable database.");
+
+    // The connection is kept for the thread, i.e. it have to be closed before
+    // the directory is removed.
+    [RASqlite closeImmutableDatabaseWithPath:path];
+}
+
+- (void)testImmutableDatabaseWithPath_withThreads {
+    NSString *path = [_directory stringByAppendingString:@"/immutable"];
+    RASqlite *rasqlite = [[RASqlite alloc] initWithPath:path];
+    XCTAssertTrue([rasqlite execute:@"CREATE TABLE foo(id INTEGER PRIMARY KEY)"], @"Unable to create table.");
+    XCTAssertTrue([rasqlite close], @"Unable to close database.");
+
+    RASqlite *immutable = [RASqlite immutableDatabaseWithPath:path];
+    XCTAssertEqual(immutable, [RASqlite immutableDatabaseWithPath:path], @"Connection is not reused within thread.");
+
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Connection have been retrieved."];
+    RASqlite __block *other;
+
+    dispatch_queue_t queue = dispatch_queue_create("me.raatiniemi.rasqlite.tests.immutable", DISPATCH_QUEUE_SERIAL);
+    dispatch_async(queue, ^{
+        other = [RASqlite immutableDatabaseWithPath:path];
+        [other fetch:@"SELECT id FROM foo"];
+
+        // The worker thread is reused by other queues, i.e. the connection
+        // have to be closed on the thread that retrieved it.
+        [RASqlite closeImmutableDatabaseWithPath:path];
+        [expectation fulfill];
+    });
+
+    [self waitForExpectationsWithTimeout:1.0 handler:nil];
+    XCTAssertNotNil(other, @"Connection was not retrieved on other thread.");
+    XCTAssertNotEqual(immutable, other, @"Connection is shared between threads.");
+
+    [RASqlite closeImmutableDatabaseWithPath:path];
+}
+
+- (void)testCloseImmutableDatabaseWithPath {
+    NSString *path = [_directory stringByAppendingString:@"/immutable"];
+    RASqlite *rasqlite = [[RASqlite alloc] initWithPath:path];
+    XCTAssertTrue([rasqlite execute:@"CREATE TABLE foo(id INTEGER PRIMARY KEY)"], @"Unable to create table.");
+    XCTAssertTrue([rasqlite close], @"Unable to close database.");
+
+    RASqlite *immutable = [RASqlite immutableDatabaseWithPath:path];
+    XCTAssertNotNil([immutable fetch:@"SELECT id FROM foo"], @"Unable to read from immutable database.");
+
+    [RASqlite closeImmutableDatabaseWithPath:path];
+
+    RASqlite *reopened = [RASqlite immutableDatabaseWithPath:path];
+    XCTAssertNotEqual(immutable, reopened, @"Closed connection was reused within thread.");
+    XCTAssertNotNil([reopened fetch:@"SELECT id FROM foo"], @"Unable to read from reopened immutable database.");
+
+    [RASqlite closeImmutableDatabaseWithPath:path];
+}
+
 #pragma mark - Query
 
 #pragma mark -- Fetch
@@ -494,6 +1223,87 @@ static NSString *_directory = @"/tmp/rasqlite";
     XCTAssertNil(row, @"Deleted row was found.");
 }
 
+#pragma mark -- Script
+
+- (void)testExecuteScript_withMultipleStatements {
+    NSString *path = [_directory stringByAppendingString:@"/script"];
+    RASqlite *rasqlite = [[RASqlite alloc] initWithPath:path];
+
+    NSString *script = @"CREATE TABLE foo(id INTEGER PRIMARY KEY, bar TEXT);\n"
+            "-- Seed data.\n"
+            "INSERT INTO foo(bar) VALUES('baz');\n"
+            "INSERT INTO foo(bar) VALUES('qux');\n";
+    XCTAssertTrue([rasqlite executeScript:script],
+            @"Script failed: %@",
+            [[rasqlite error] localizedDescription]);
+
+    NSArray *rows = [rasqlite fetch:@"SELECT bar FROM foo"];
+    XCTAssertEqual(2, [rows count], @"Every statement was not executed.");
+}
+
+- (void)testExecuteScript_withInvalidStatement {
+    NSString *path = [_directory stringByAppendingString:@"/script"];
+    RASqlite *rasqlite = [[RASqlite alloc] initWithPath:path];
+    XCTAssertTrue([rasqlite execute:@"CREATE TABLE foo(id INTEGER PRIMARY KEY, bar TEXT NOT NULL)"],
+            @"Unable to create table for script: %@",
+            [[rasqlite error] localizedDescription]);
+
+    NSString *script = @"INSERT INTO foo(bar) VALUES('baz'); INSERT INTO foo(bar) VALUES(NULL);";
+    XCTAssertFalse([rasqlite executeScript:script inTransaction:YES], @"Script with failing statement was successful.");
+
+    NSString *message = [[rasqlite error] localizedDescription];
+    XCTAssertTrue([message rangeOfString:@"offset 36"].location != NSNotFound, @"Offset is missing from error: %@", message);
+    XCTAssertEqualObjects(@36, [[rasqlite error] userInfo][RASqliteErrorOffsetKey], @"Offset is missing from user info.");
+
+    [rasqlite setError:nil];
+    XCTAssertEqual(0, [[rasqlite fetch:@"SELECT bar FROM foo"] count], @"Transaction was not rolled back.");
+}
+
+- (void)testExecuteScript_withinTransaction {
+    NSString *path = [_directory stringByAppendingString:@"/script"];
+    RASqlite *rasqlite = [[RASqlite alloc] initWithPath:path];
+    XCTAssertTrue([rasqlite execute:@"CREATE TABLE foo(id INTEGER PRIMARY KEY, bar TEXT NOT NULL)"],
+            @"Unable to create table for script: %@",
+            [[rasqlite error] localizedDescription]);
+
+    BOOL __block executed = YES;
+    [rasqlite queueTransactionWithBlock:^(RASqlite *db, BOOL *commit) {
+        [db execute:@"INSERT INTO foo(bar) VALUES('baz')"];
+
+        NSString *script = @"INSERT INTO foo(bar) VALUES('qux'); INSERT INTO foo(bar) VALUES(NULL);";
+        executed = [db executeScript:script inTransaction:YES];
+        *commit = YES;
+    }];
+    XCTAssertFalse(executed, @"Script with failing statement was successful.");
+
+    NSArray *rows = [rasqlite fetch:@"SELECT bar FROM foo"];
+    XCTAssertEqualObjects((@[@"baz"]), [rows valueForKey:@"bar"], @"Only the script should have been rolled back.");
+}
+
+- (void)testExecuteScriptAtPath_withMultipleLines {
+    NSString *path = [_directory stringByAppendingString:@"/script"];
+    RASqlite *rasqlite = [[RASqlite alloc] initWithPath:path];
+
+    NSString *script = @"CREATE TABLE foo(id INTEGER PRIMARY KEY, bar TEXT);\n"
+            "CREATE TABLE log(bar TEXT);\n"
+            "CREATE TRIGGER foo_log AFTER INSERT ON foo\n"
+            "BEGIN\n"
+            "    INSERT INTO log(bar) VALUES(new.bar);\n"
+            "END;\n"
+            "INSERT INTO foo(bar)\n"
+            "    VALUES('baz')";
+
+    NSString *file = [_directory stringByAppendingString:@"/script.sql"];
+    [script writeToFile:file atomically:YES encoding:NSUTF8StringEncoding error:nil];
+
+    XCTAssertTrue([rasqlite executeScriptAtPath:file inTransaction:YES],
+            @"Script failed: %@",
+            [[rasqlite error] localizedDescription]);
+
+    NSArray *rows = [rasqlite fetch:@"SELECT bar FROM log"];
+    XCTAssertEqual(1, [rows count], @"Trigger was not created from script.");
+}
+
 #pragma mark - Transaction
 
 - (void)testQueueTransactionWithBlock_commitInsert {
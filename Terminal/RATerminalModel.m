@@ -17,25 +17,16 @@ static RATerminalModel *_sharedModel = nil;
 - (id)init {
     if (self = [super initWithPath:@"/tmp/rasqlite-user.db"]) {
         [self queueTransactionWithBlock:^(RASqlite *db, BOOL *commit) {
-            // Iterate over the table structure.
-            for (NSString *table in [self structure]) {
-                NSArray *columns = [self structure][table];
-
-                // Check if the structure for the table have changed.
-                if (!(*commit = [db checkTable:table withColumns:columns])) {
-                    // The structure have changed, delete the table and
-                    // recreate it with the new column structure.
-                    *commit = [db deleteTable:table];
-                    if (*commit) {
-                        *commit = [db createTable:table withColumns:columns];
-                    }
-                }
-
-                // If either of the operations fails the transaction is failed.
-                if (!*commit) {
-                    break;
-                }
+            // If the stored fingerprint matches the structure, or every table
+            // is as defined, there is no need to check each table individually.
+            if ((*commit = [db check])) {
+                return;
             }
+
+            // The structure have changed, migrate the tables to the new
+            // column structure while preserving the existing data. If the
+            // migration fails the transaction is failed.
+            *commit = [db migrate];
         }];
     }
     return self;
@@ -72,6 +63,9 @@ static RATerminalModel *_sharedModel = nil;
     [column setDefaultValue:@1];
     [user addObject:column];
 
+    // Users are looked up by their name.
+    [user addObject:RAIndex(@"user_name", @[@"name"])];
+
     NSMutableDictionary *tables = [[NSMutableDictionary alloc] init];
     tables[@"user"] = user;
 